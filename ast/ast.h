@@ -14,6 +14,7 @@
 #include "ast/jump_options.h"
 #include "ast/node.h"
 #include "ast/scope.h"
+#include "ast/symbol.h"
 #include "ast/visitor_base.h"
 #include "base/ptr_span.h"
 #include "core/arguments.h"
@@ -810,16 +811,18 @@ struct FunctionType : Expression {
 // Represents any user-defined identifier.
 struct Identifier : Expression {
   Identifier(frontend::SourceRange const &range, std::string name)
-      : Expression(range), name_(std::move(name)) {}
+      : Expression(range), name_(std::move(name)), symbol_(name_) {}
 
   ICARUS_AST_VIRTUAL_METHODS;
 
   std::string_view name() const { return name_; }
+  Symbol symbol() const { return symbol_; }
 
   std::string extract() && { return std::move(name_); }
 
  private:
   std::string name_;
+  Symbol symbol_;
 };
 
 // Import:
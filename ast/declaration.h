@@ -9,6 +9,7 @@
 #include "absl/types/span.h"
 #include "ast/expression.h"
 #include "ast/node.h"
+#include "ast/symbol.h"
 #include "frontend/source/buffer.h"
 
 namespace ast {
@@ -20,9 +21,10 @@ struct Declaration;
 // TODO: Does it make sense for this to be an expression?
 struct Declaration_Id : Expression {
   explicit Declaration_Id(std::string name, frontend::SourceRange const &range)
-      : Expression(range), name_(std::move(name)) {}
+      : Expression(range), name_(std::move(name)), symbol_(name_) {}
 
   std::string_view name() const { return name_; }
+  Symbol symbol() const { return symbol_; }
   ast::Declaration const &declaration() const {
     return *ASSERT_NOT_NULL(decl_);
   }
@@ -40,6 +42,7 @@ struct Declaration_Id : Expression {
   }
   void Initialize(Initializer &initializer) override {
     scope_ = initializer.scope;
+    index_ = initializer.next_index++;
   }
 
  private:
@@ -48,6 +51,7 @@ struct Declaration_Id : Expression {
 
   ast::Declaration const *decl_;
   std::string name_;
+  Symbol symbol_;
 };
 
 // Declaration:
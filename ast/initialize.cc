@@ -92,6 +92,7 @@ void InitializeNodes(base::PtrSpan<Node> nodes,
 
 void Access::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   operand_->Initialize(initializer);
   covers_binding_ = operand_->covers_binding();
   is_dependent_   = operand_->is_dependent();
@@ -99,11 +100,13 @@ void Access::Initialize(Initializer& initializer) {
 
 void ArgumentType::Initialize(Initializer& initializer) {
   scope_        = initializer.scope;
+  index_        = initializer.next_index++;
   is_dependent_ = true;
 }
 
 void ArrayLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   for (auto& expr : elems_) {
     expr->Initialize(initializer);
     covers_binding_ |= expr->covers_binding();
@@ -113,6 +116,7 @@ void ArrayLiteral::Initialize(Initializer& initializer) {
 
 void ArrayType::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   for (auto const& len : lengths_) {
     len->Initialize(initializer);
     covers_binding_ |= len->covers_binding();
@@ -125,12 +129,14 @@ void ArrayType::Initialize(Initializer& initializer) {
 
 void Assignment::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   InitializeAll(lhs_, initializer, &covers_binding_, &is_dependent_);
   InitializeAll(rhs_, initializer, &covers_binding_, &is_dependent_);
 }
 
 void BinaryOperator::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   lhs_->Initialize(initializer);
   rhs_->Initialize(initializer);
   covers_binding_ = lhs_->covers_binding() or rhs_->covers_binding();
@@ -146,6 +152,7 @@ void BindingDeclaration::Initialize(Initializer& initializer) {
 
 void BlockLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -155,6 +162,7 @@ void BlockLiteral::Initialize(Initializer& initializer) {
 
 void BlockNode::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope, true);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -165,10 +173,12 @@ void BlockNode::Initialize(Initializer& initializer) {
 
 void BuiltinFn::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
 }
 
 void Call::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   callee_->Initialize(initializer);
   covers_binding_ = callee_->covers_binding();
   is_dependent_   = callee_->is_dependent();
@@ -181,6 +191,7 @@ void Call::Initialize(Initializer& initializer) {
 
 void Cast::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   expr_->Initialize(initializer);
   type_->Initialize(initializer);
   covers_binding_ = expr_->covers_binding() or type_->covers_binding();
@@ -189,6 +200,7 @@ void Cast::Initialize(Initializer& initializer) {
 
 void ComparisonOperator::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   for (auto& expr : exprs_) {
     expr->Initialize(initializer);
     covers_binding_ |= expr->covers_binding();
@@ -198,6 +210,7 @@ void ComparisonOperator::Initialize(Initializer& initializer) {
 
 void Declaration::Initialize(Initializer& initializer) {
   scope_ = ASSERT_NOT_NULL(initializer.scope);
+  index_ = initializer.next_index++;
   scope_->InsertDeclaration(this);
   if (type_expr_) {
     auto* m         = std::exchange(initializer.match_against, this);
@@ -220,6 +233,7 @@ void Declaration::Initialize(Initializer& initializer) {
 
 void DesignatedInitializer::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   type_->Initialize(initializer);
   for (auto& assignment : assignments_) {
     assignment->Initialize(initializer);
@@ -230,6 +244,7 @@ void DesignatedInitializer::Initialize(Initializer& initializer) {
 
 void EnumLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   for (auto& [id, value] : values_) {
     value->Initialize(initializer);
@@ -240,6 +255,7 @@ void EnumLiteral::Initialize(Initializer& initializer) {
 
 void FunctionLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
 
   initializer.scope = &body_scope();
@@ -263,16 +279,19 @@ void FunctionLiteral::Initialize(Initializer& initializer) {
 
 void FunctionType::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   InitializeAll(params_, initializer, &covers_binding_, &is_dependent_);
   InitializeAll(output_, initializer, &covers_binding_, &is_dependent_);
 }
 
 void Identifier::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
 }
 
 void Import::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   operand_->Initialize(initializer);
   covers_binding_ = operand_->covers_binding();
   is_dependent_   = operand_->is_dependent();
@@ -280,6 +299,7 @@ void Import::Initialize(Initializer& initializer) {
 
 void Index::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   lhs_->Initialize(initializer);
   rhs_->Initialize(initializer);
   covers_binding_ = lhs_->covers_binding() or rhs_->covers_binding();
@@ -288,6 +308,7 @@ void Index::Initialize(Initializer& initializer) {
 
 void InterfaceLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -301,6 +322,7 @@ void InterfaceLiteral::Initialize(Initializer& initializer) {
 
 void ConditionalGoto::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   condition_->Initialize(initializer);
   for (auto& opt : true_options_) {
     opt.args_.Apply([&](auto& expr) {
@@ -320,6 +342,7 @@ void ConditionalGoto::Initialize(Initializer& initializer) {
 
 void UnconditionalGoto::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   for (auto& opt : options_) {
     opt.args_.Apply([&](auto& expr) {
       expr->Initialize(initializer);
@@ -331,6 +354,7 @@ void UnconditionalGoto::Initialize(Initializer& initializer) {
 
 void Jump::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -348,21 +372,27 @@ void Jump::Initialize(Initializer& initializer) {
   InitializeParams();
 }
 
-void Label::Initialize(Initializer& initializer) { scope_ = initializer.scope; }
+void Label::Initialize(Initializer& initializer) {
+  scope_ = initializer.scope;
+  index_ = initializer.next_index++;
+}
 
 void ReturnStmt::Initialize(Initializer& initializer) {
   scope_            = initializer.scope;
+  index_            = initializer.next_index++;
   function_literal_ = initializer.function_literal;
   InitializeAll(exprs_, initializer, &covers_binding_, &is_dependent_);
 }
 
 void YieldStmt::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   InitializeAll(exprs_, initializer, &covers_binding_, &is_dependent_);
 }
 
 void ScopeLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   if (state_type_) { state_type_->Initialize(initializer); }
   initializer.scope = &body_scope();
@@ -372,6 +402,7 @@ void ScopeLiteral::Initialize(Initializer& initializer) {
 
 void ScopeNode::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   name_->Initialize(initializer);
   args_.Apply([&](Expression* expr) { expr->Initialize(initializer); });
 
@@ -380,6 +411,7 @@ void ScopeNode::Initialize(Initializer& initializer) {
 
 void SliceType::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   data_type_->Initialize(initializer);
   covers_binding_ = data_type_->covers_binding();
   is_dependent_   = data_type_->is_dependent();
@@ -387,6 +419,7 @@ void SliceType::Initialize(Initializer& initializer) {
 
 void ShortFunctionLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -398,6 +431,7 @@ void ShortFunctionLiteral::Initialize(Initializer& initializer) {
 
 void StructLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -406,6 +440,7 @@ void StructLiteral::Initialize(Initializer& initializer) {
 
 void ParameterizedStructLiteral::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   set_body_with_parent(initializer.scope);
   initializer.scope = &body_scope();
   absl::Cleanup c   = [&] { initializer.scope = scope_; };
@@ -419,6 +454,7 @@ void PatternMatch::Initialize(Initializer& initializer) {
   covers_binding_ = false;
   is_dependent_   = true;
   scope_          = initializer.scope;
+  index_          = initializer.next_index++;
   auto const* p   = std::exchange(initializer.pattern, this);
   absl::Cleanup c = [&] { initializer.pattern = p; };
   pattern_->Initialize(initializer);
@@ -431,10 +467,12 @@ void PatternMatch::Initialize(Initializer& initializer) {
 
 void Terminal::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
 }
 
 void UnaryOperator::Initialize(Initializer& initializer) {
   scope_ = initializer.scope;
+  index_ = initializer.next_index++;
   operand_->Initialize(initializer);
   covers_binding_ = operand_->covers_binding();
   is_dependent_   = operand_->is_dependent();
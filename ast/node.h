@@ -1,6 +1,8 @@
 #ifndef ICARUS_AST_NODE_H
 #define ICARUS_AST_NODE_H
 
+#include <cstdint>
+#include <limits>
 #include <utility>
 
 #include "ast/visitor_base.h"
@@ -35,6 +37,13 @@ struct Node : base::Cast<Node> {
   constexpr frontend::SourceRange range() const { return range_; }
   Scope *scope() const { return scope_; }
 
+  // Nodes are numbered densely within their module in the order in which they
+  // are initialized, so that data computed about them may be stored in
+  // vector-backed side tables. Nodes which have not been initialized have
+  // index `kUnindexed`.
+  static constexpr uint32_t kUnindexed = std::numeric_limits<uint32_t>::max();
+  uint32_t index() const { return index_; }
+
   // Object used to track state while initializing the syntax tree.
   struct Initializer {
     Scope *scope = nullptr;
@@ -46,13 +55,17 @@ struct Node : base::Cast<Node> {
 
     PatternMatch const *pattern = nullptr;
     Declaration *match_against  = nullptr;
+
+    // The index to be assigned to the next node initialized.
+    uint32_t next_index = 0;
   };
 
   virtual void Initialize(Initializer &initializer) {}
 
  protected:
   frontend::SourceRange range_;
-  Scope *scope_ = nullptr;
+  Scope *scope_   = nullptr;
+  uint32_t index_ = kUnindexed;
   // TODO: We can compress these bit somewhere.
   bool covers_binding_ = false;
   bool is_dependent_   = false;
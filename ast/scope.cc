@@ -1,5 +1,7 @@
 #include "ast/scope.h"
 
+#include <algorithm>
+
 namespace ast {
 
 void Scope::InsertDeclaration(ast::Declaration const *decl) {
@@ -9,6 +11,7 @@ void Scope::InsertDeclaration(ast::Declaration const *decl) {
     }
     LOG("Scope", "Inserting a declaration of `%s` into %p", id.name(), this);
     decls_[id.name()].push_back(&id);
+    InvalidateLookups();
     for (auto *scope_ptr = parent(); scope_ptr;
          scope_ptr       = scope_ptr->parent()) {
       if (scope_ptr->is_visibility_boundary()) { break; }
@@ -20,6 +23,10 @@ void Scope::InsertDeclaration(ast::Declaration const *decl) {
 Scope::Scope(Scope *parent, bool executable)
     : parent_(parent), executable_(executable) {
   if (not parent_) { return; }
+  {
+    absl::MutexLock lock(&parent_->mutex_);
+    parent_->children_.push_back(this);
+  }
   for (Scope *s = parent_; s; s = s->parent_) {
     LOG("Scope", "%p", s);
     if (auto *fs = s->if_as<FnScope>()) {
@@ -30,4 +37,109 @@ Scope::Scope(Scope *parent, bool executable)
   UNREACHABLE();
 }
 
+Scope::Scope(Scope &&scope) : executable_(scope.executable_) {
+  *this = std::move(scope);
+}
+
+Scope &Scope::operator=(Scope &&scope) {
+  if (this == &scope) { return *this; }
+
+  if (parent_) {
+    absl::MutexLock lock(&parent_->mutex_);
+    std::erase(parent_->children_, this);
+  }
+  parent_ = std::exchange(scope.parent_, nullptr);
+  if (parent_) {
+    absl::MutexLock lock(&parent_->mutex_);
+    std::replace(parent_->children_.begin(), parent_->children_.end(), &scope,
+                 this);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  absl::MutexLock scope_lock(&scope.mutex_);
+  decls_                  = std::move(scope.decls_);
+  child_decls_            = std::move(scope.child_decls_);
+  embedded_module_scopes_ = std::move(scope.embedded_module_scopes_);
+  executable_             = scope.executable_;
+  children_               = std::move(scope.children_);
+  for (Scope *child : children_) { child->parent_ = this; }
+
+  // The moved-from scope is left with an empty cache.
+  generation_.store(scope.generation_.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+  lookups_.store(scope.lookups_.exchange(nullptr, std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+  num_lookups_ = std::exchange(scope.num_lookups_, 0);
+  tables_      = std::move(scope.tables_);
+  cached_ids_  = std::move(scope.cached_ids_);
+  return *this;
+}
+
+void Scope::embed(ModuleScope const *scope) {
+  {
+    absl::MutexLock lock(&scope->mutex_);
+    scope->embedders_.push_back(this);
+  }
+  embedded_module_scopes_.insert(scope);
+  InvalidateLookups();
+}
+
+void Scope::InvalidateLookups() {
+  generation_.fetch_add(1, std::memory_order_release);
+  absl::MutexLock lock(&mutex_);
+  for (Scope *child : children_) { child->InvalidateLookups(); }
+}
+
+Scope::CachedIds const &Scope::CacheLookup(
+    Symbol symbol, uint64_t generation,
+    std::vector<Declaration::Id const *> ids) const {
+  absl::MutexLock lock(&mutex_);
+  CachedIds const &cached = *cached_ids_.emplace_back(
+      std::make_unique<CachedIds>(generation, std::move(ids)));
+
+  LookupTable *table = lookups_.load(std::memory_order_relaxed);
+  LookupTable::Slot *slot = table ? &table->Probe(symbol) : nullptr;
+  if (slot and slot->key.load(std::memory_order_relaxed) != 0) {
+    // Another thread may have cached a result computed at a later generation.
+    if (slot->ids.load(std::memory_order_relaxed)->generation <= generation) {
+      slot->ids.store(&cached, std::memory_order_release);
+    }
+    return cached;
+  }
+
+  // Tables are kept at most half full, so that probing is quick and always
+  // finds an empty slot.
+  if (not table or 2 * (num_lookups_ + 1) > table->capacity) {
+    auto &grown = tables_.emplace_back(
+        std::make_unique<LookupTable>(table ? 2 * table->capacity : 8));
+    if (table) {
+      for (size_t i = 0; i < table->capacity; ++i) {
+        uint32_t key = table->slots[i].key.load(std::memory_order_relaxed);
+        if (key == 0) { continue; }
+        LookupTable::Slot &s = grown->Probe(key);
+        s.ids.store(table->slots[i].ids.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+        s.key.store(key, std::memory_order_relaxed);
+      }
+    }
+    table = grown.get();
+    slot  = &table->Probe(symbol);
+  }
+  slot->ids.store(&cached, std::memory_order_relaxed);
+  slot->key.store(symbol.id() + 1, std::memory_order_release);
+  ++num_lookups_;
+  lookups_.store(table, std::memory_order_release);
+  return cached;
+}
+
+void ModuleScope::insert_exported(Declaration::Id const *id) {
+  exported_declarations_[id->name()].push_back(id);
+  std::vector<Scope *> embedders;
+  {
+    absl::MutexLock lock(&mutex_);
+    embedders = embedders_;
+  }
+  for (Scope *scope : embedders) { scope->InvalidateLookups(); }
+}
+
 }  // namespace ast
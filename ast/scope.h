@@ -1,13 +1,18 @@
 #ifndef ICARUS_AST_SCOPE_H
 #define ICARUS_AST_SCOPE_H
 
+#include <atomic>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "ast/ast_fwd.h"
 #include "ast/declaration.h"
+#include "ast/symbol.h"
 #include "base/cast.h"
 #include "base/debug.h"
 #include "base/iterator.h"
@@ -23,6 +28,10 @@ struct ModuleScope;
 struct Scope : public base::Cast<Scope> {
   Scope() = delete;
   Scope(Scope *parent, bool executable);
+  // Moving a scope is not thread-safe: no lookup may be in progress on either
+  // scope, nor on any of their ancestors or descendants.
+  Scope(Scope &&scope);
+  Scope &operator=(Scope &&scope);
   virtual ~Scope() {}
 
   struct ancestor_iterator {
@@ -112,9 +121,7 @@ struct Scope : public base::Cast<Scope> {
     return absl::Span<Declaration::Id const *const>();
   }
 
-  void embed(ModuleScope const *scope) {
-    embedded_module_scopes_.insert(scope);
-  }
+  void embed(ModuleScope const *scope);
 
   absl::flat_hash_set<ModuleScope const *> const &embedded_module_scopes()
       const {
@@ -127,12 +134,94 @@ struct Scope : public base::Cast<Scope> {
       std::string_view name,
       std::invocable<Declaration::Id const *> auto &&fn) const;
 
+  // Returns the result of looking up `symbol` starting at this scope, calling
+  // `lookup` to compute it if it has not already been cached. Results are
+  // invalidated whenever a declaration is inserted into or exported from, or a
+  // module is embedded in, any scope the lookup may visit. Finding a cached
+  // result takes no lock and does not allocate. This may be called
+  // concurrently from any number of threads. The returned span remains valid
+  // for the lifetime of this scope.
+  absl::Span<Declaration::Id const *const> CachedLookup(
+      Symbol symbol, std::invocable<> auto &&lookup) const;
+
+ protected:
+  // Invalidates the cached lookups of this scope and all of its descendants.
+  void InvalidateLookups();
+
+  // Guards writes to the lookup cache and the lists of scopes to which
+  // invalidation is pushed. Cached lookups are read without taking this lock.
+  mutable absl::Mutex mutex_;
+
  private:
+  friend struct ModuleScope;
+
+  // A result of `CachedLookup`, computed when the scope's generation was
+  // `generation`.
+  struct CachedIds {
+    uint64_t generation;
+    std::vector<Declaration::Id const *> ids;
+  };
+
+  // An open-addressed table of cached lookups, keyed by symbol. Slots are only
+  // ever filled or have their entry replaced, and a full table is replaced by a
+  // larger copy, so the table may be probed without locking.
+  struct LookupTable {
+    explicit LookupTable(size_t capacity)
+        : capacity(capacity), slots(new Slot[capacity]) {}
+
+    struct Slot {
+      // One more than the id of the symbol cached in this slot, or zero if
+      // the slot is empty.
+      std::atomic<uint32_t> key = 0;
+      std::atomic<CachedIds const *> ids = nullptr;
+    };
+
+    // Returns the slot holding `symbol`, or the empty slot in which it would
+    // be inserted.
+    Slot &Probe(Symbol symbol) const { return Probe(symbol.id() + 1); }
+    Slot &Probe(uint32_t key) const {
+      // Fibonacci hashing spreads the dense symbol ids across the table.
+      size_t i = (key * uint64_t{0x9e3779b97f4a7c15}) & (capacity - 1);
+      while (true) {
+        uint32_t k = slots[i].key.load(std::memory_order_acquire);
+        if (k == 0 or k == key) { return slots[i]; }
+        i = (i + 1) & (capacity - 1);
+      }
+    }
+
+    size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  // Stores `ids` as the result of looking up `symbol`, computed at
+  // `generation`, and returns the stored result.
+  CachedIds const &CacheLookup(Symbol symbol, uint64_t generation,
+                               std::vector<Declaration::Id const *> ids) const;
+
   Scope *parent_ = nullptr;
   absl::flat_hash_map<std::string_view, std::vector<Declaration::Id const *>>
       child_decls_;
   absl::flat_hash_set<ModuleScope const *> embedded_module_scopes_;
   bool executable_;
+
+  // Incremented whenever the result of any lookup starting at this scope may
+  // change. Cached results computed at an earlier generation are stale.
+  std::atomic<uint64_t> generation_ = 0;
+  mutable std::atomic<LookupTable *> lookups_ = nullptr;
+
+  // Scopes whose parent is this scope. Invalidation is pushed down to them.
+  std::vector<Scope *> children_ ABSL_GUARDED_BY(mutex_);
+
+  // The number of symbols cached in `lookups_`.
+  mutable size_t num_lookups_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Every table and result ever published, as a reader may still be holding
+  // one which has since been replaced. Replacements are rare as declarations
+  // are almost always inserted before any lookup is made.
+  mutable std::vector<std::unique_ptr<LookupTable>> tables_
+      ABSL_GUARDED_BY(mutex_);
+  mutable std::vector<std::unique_ptr<CachedIds>> cached_ids_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 // An executable scope representing the body of a function literal. These scopes
@@ -169,9 +258,7 @@ struct ModuleScope : FnScope {
     return iter->second;
   }
 
-  void insert_exported(Declaration::Id const *id) {
-    exported_declarations_[id->name()].push_back(id);
-  }
+  void insert_exported(Declaration::Id const *id);
 
  private:
   friend struct Scope;
@@ -179,6 +266,10 @@ struct ModuleScope : FnScope {
   absl::flat_hash_map<std::string_view, std::vector<Declaration::Id const *>>
       exported_declarations_;
 
+  // Scopes in which this module is embedded. Lookups starting in them or their
+  // descendants are invalidated when a declaration is exported.
+  mutable std::vector<Scope *> embedders_ ABSL_GUARDED_BY(mutex_);
+
   module::BasicModule *module_;
 };
 
@@ -218,6 +309,25 @@ bool Scope::ForEachDeclIdTowardsRoot(
   return true;
 }
 
+absl::Span<Declaration::Id const *const> Scope::CachedLookup(
+    Symbol symbol, std::invocable<> auto &&lookup) const {
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  if (LookupTable const *table = lookups_.load(std::memory_order_acquire)) {
+    // The slot may have been filled with a different symbol since it was
+    // probed, so its key must be checked again before reading its entry.
+    LookupTable::Slot const &slot = table->Probe(symbol);
+    if (slot.key.load(std::memory_order_acquire) == symbol.id() + 1) {
+      CachedIds const *cached = slot.ids.load(std::memory_order_acquire);
+      if (cached->generation == generation) { return cached->ids; }
+    }
+  }
+
+  // The lookup is computed without holding the lock, as it may visit other
+  // scopes. Should declarations be added concurrently, `generation` is stale
+  // and the next lookup recomputes the result.
+  return CacheLookup(symbol, generation, lookup()).ids;
+}
+
 }  // namespace ast
 
 #endif  // ICARUS_AST_SCOPE_H
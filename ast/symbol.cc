@@ -0,0 +1,16 @@
+#include "ast/symbol.h"
+
+#include "base/flyweight_map.h"
+
+namespace ast {
+namespace {
+
+base::concurrent_flyweight_map<std::string> symbols;
+
+}  // namespace
+
+Symbol::Symbol(std::string const &name) : id_(symbols.get(name)) {}
+
+std::string_view Symbol::name() const { return symbols.get(id_); }
+
+}  // namespace ast
@@ -0,0 +1,34 @@
+#ifndef ICARUS_AST_SYMBOL_H
+#define ICARUS_AST_SYMBOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ast {
+
+// An interned identifier. Identifiers with the same name are interned to the
+// same symbol, so symbols may be compared and hashed without reading the name.
+// Symbol ids are dense, starting at zero.
+struct Symbol {
+  explicit Symbol(std::string const &name);
+
+  std::string_view name() const;
+  uint32_t id() const { return id_; }
+
+  friend bool operator==(Symbol lhs, Symbol rhs) { return lhs.id_ == rhs.id_; }
+  friend bool operator!=(Symbol lhs, Symbol rhs) { return not(lhs == rhs); }
+
+  template <typename H>
+  friend H AbslHashValue(H h, Symbol s) {
+    return H::combine(std::move(h), s.id_);
+  }
+
+ private:
+  uint32_t id_;
+};
+
+}  // namespace ast
+
+#endif  // ICARUS_AST_SYMBOL_H
@@ -0,0 +1,520 @@
+#include "backend/baseline.h"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "backend/x86_64/object_file.h"
+#include "base/log.h"
+#include "base/meta.h"
+#include "core/arch.h"
+#include "ir/instruction/arithmetic.h"
+#include "ir/instruction/compare.h"
+#include "ir/instruction/core.h"
+#include "ir/instruction/instructions.h"
+#include "type/function.h"
+#include "type/pointer.h"
+#include "type/primitive.h"
+
+namespace backend {
+namespace {
+
+using x86_64::Condition;
+using x86_64::Memory;
+using x86_64::Register;
+
+// Integer and pointer arguments are passed in these registers, in order.
+constexpr std::array kArgumentRegisters = {Register::rdi, Register::rsi,
+                                           Register::rdx, Register::rcx,
+                                           Register::r8,  Register::r9};
+
+// The types the baseline backend can hold in a general-purpose register.
+using PhiTypes = base::type_list<bool, ir::Char, int8_t, int16_t, int32_t,
+                                 int64_t, uint8_t, uint16_t, uint32_t,
+                                 uint64_t, ir::addr_t>;
+
+// Values are held in registers and home slots as 64-bit values, sign- or
+// zero-extended from their natural width.
+template <typename T>
+uint64_t Bits(T value) {
+  if constexpr (base::meta<T> == base::meta<ir::Char>) {
+    uint8_t c = value;
+    return c;
+  } else if constexpr (base::meta<T> == base::meta<ir::addr_t>) {
+    // A constant address other than null points into the compiler's own
+    // memory (e.g., read-only data), which does not exist in the emitted
+    // program. Such addresses would need to be emitted as data with a
+    // relocation.
+    if (value != nullptr) {
+      NOT_YET("The baseline backend does not support constant addresses.");
+    }
+    return 0;
+  } else if constexpr (std::is_signed_v<T>) {
+    return static_cast<uint64_t>(static_cast<int64_t>(value));
+  } else {
+    return static_cast<uint64_t>(value);
+  }
+}
+
+template <typename T>
+void Load(BaselineEmitter &emitter, Register dst, ir::RegOr<T> const &value,
+          BaselineEmitter::context_type const &context) {
+  if (value.is_reg()) {
+    emitter.Load(dst, value.reg(), context);
+  } else {
+    emitter.code().Move(dst, Bits(value.value()));
+  }
+}
+
+void Load(BaselineEmitter &emitter, Register dst, ir::Value const &value,
+          BaselineEmitter::context_type const &context) {
+  value.apply<bool, ir::Char, int8_t, int16_t, int32_t, int64_t, uint8_t,
+              uint16_t, uint32_t, uint64_t, ir::Reg, ir::addr_t>(
+      [&](auto v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (base::meta<T> == base::meta<ir::Reg>) {
+          emitter.Load(dst, v, context);
+        } else {
+          emitter.code().Move(dst, Bits(v));
+        }
+      });
+}
+
+// Returns the size of a value of type `t` and whether it is sign-extended.
+std::pair<int, bool> Representation(type::Type t) {
+  if (auto const *p = t.if_as<type::Primitive>()) {
+    return p->Apply([]<typename T>() -> std::pair<int, bool> {
+      if constexpr (std::is_integral_v<T> or
+                    base::meta<T> == base::meta<ir::Char>) {
+        return {sizeof(T), std::is_signed_v<T>};
+      } else {
+        NOT_YET(base::meta<T>);
+      }
+    });
+  } else if (t.is<type::Pointer>()) {
+    return {sizeof(ir::addr_t), false};
+  } else {
+    NOT_YET(t.to_string());
+  }
+}
+
+template <typename Inst>
+bool EmitInstruction(BaselineEmitter &emitter,
+                     BaselineEmitter::context_type &context,
+                     ir::Inst const &instruction) {
+  static constexpr auto instruction_t = base::meta<Inst>;
+  auto &inst                          = instruction.as<Inst>();
+  auto &code                          = emitter.code();
+  if constexpr (instruction_t.template is_a<ir::AddInstruction>() or
+                instruction_t.template is_a<ir::SubInstruction>() or
+                instruction_t.template is_a<ir::MulInstruction>() or
+                instruction_t.template is_a<ir::DivInstruction>() or
+                instruction_t.template is_a<ir::ModInstruction>()) {
+    using num_type = typename Inst::num_type;
+    Load(emitter, Register::rax, inst.lhs, context);
+    Load(emitter, Register::rcx, inst.rhs, context);
+    if constexpr (instruction_t.template is_a<ir::AddInstruction>()) {
+      code.Add(Register::rax, Register::rcx);
+    } else if constexpr (instruction_t.template is_a<ir::SubInstruction>()) {
+      code.Subtract(Register::rax, Register::rcx);
+    } else if constexpr (instruction_t.template is_a<ir::MulInstruction>()) {
+      code.Multiply(Register::rax, Register::rcx);
+    } else {
+      code.Divide(Register::rcx, std::is_signed_v<num_type>);
+      if constexpr (instruction_t.template is_a<ir::ModInstruction>()) {
+        code.Move(Register::rax, Register::rdx);
+      }
+    }
+    code.Extend(Register::rax, sizeof(num_type), std::is_signed_v<num_type>);
+    emitter.Define(inst.result, Register::rax);
+  } else if constexpr (instruction_t.template is_a<ir::EqInstruction>() or
+                       instruction_t.template is_a<ir::NeInstruction>() or
+                       instruction_t.template is_a<ir::LtInstruction>() or
+                       instruction_t.template is_a<ir::LeInstruction>()) {
+    constexpr bool is_signed = std::is_signed_v<typename Inst::num_type>;
+    Load(emitter, Register::rax, inst.lhs, context);
+    Load(emitter, Register::rcx, inst.rhs, context);
+    code.Compare(Register::rax, Register::rcx);
+    if constexpr (instruction_t.template is_a<ir::EqInstruction>()) {
+      code.Set(Condition::Equal, Register::rax);
+    } else if constexpr (instruction_t.template is_a<ir::NeInstruction>()) {
+      code.Set(Condition::NotEqual, Register::rax);
+    } else if constexpr (instruction_t.template is_a<ir::LtInstruction>()) {
+      code.Set(is_signed ? Condition::Less : Condition::Below, Register::rax);
+    } else {
+      code.Set(is_signed ? Condition::LessOrEqual : Condition::BelowOrEqual,
+               Register::rax);
+    }
+    emitter.Define(inst.result, Register::rax);
+  } else if constexpr (instruction_t.template is_a<ir::PhiInstruction>()) {
+    // The home slot of a phi's result is written by each predecessor before it
+    // jumps to this block.
+  } else if constexpr (instruction_t
+                           .template is_a<ir::SetReturnInstruction>()) {
+    if (inst.index != 0) {
+      NOT_YET("Not yet supporting multiple returns: index = ", inst.index);
+    }
+    Load(emitter, Register::rax, inst.value, context);
+    code.Store(BaselineEmitter::ReturnSlot(), Register::rax, 8);
+  } else if constexpr (instruction_t.template is_a<ir::StoreInstruction>()) {
+    Load(emitter, Register::rax, inst.value, context);
+    Load(emitter, Register::rcx, inst.location, context);
+    code.Store({.base = Register::rcx}, Register::rax,
+               sizeof(typename Inst::type));
+  } else if constexpr (instruction_t == base::meta<ir::LoadInstruction>) {
+    auto [bytes, sign_extend] = Representation(inst.type);
+    Load(emitter, Register::rcx, inst.addr, context);
+    code.Load(Register::rax, {.base = Register::rcx}, bytes, sign_extend);
+    emitter.Define(inst.result, Register::rax);
+  } else if constexpr (instruction_t == base::meta<ir::PtrIncrInstruction>) {
+    type::Type pointee = inst.ptr->pointee();
+    core::Bytes stride = core::FwdAlign(pointee.bytes(core::Host),
+                                        pointee.alignment(core::Host));
+    Load(emitter, Register::rax, inst.index, context);
+    code.Move(Register::rcx, static_cast<uint64_t>(stride.value()));
+    code.Multiply(Register::rax, Register::rcx);
+    Load(emitter, Register::rcx, inst.addr, context);
+    code.Add(Register::rax, Register::rcx);
+    emitter.Define(inst.result, Register::rax);
+  } else if constexpr (instruction_t == base::meta<ir::MemCopyInstruction> or
+                       instruction_t == base::meta<ir::MemSetInstruction>) {
+    core::Bytes stride = core::FwdAlign(inst.type.bytes(core::Host),
+                                        inst.type.alignment(core::Host));
+    Load(emitter, Register::rcx, inst.count, context);
+    code.Move(Register::rax, static_cast<uint64_t>(stride.value()));
+    code.Multiply(Register::rcx, Register::rax);
+    Load(emitter, Register::rdi, inst.to, context);
+    if constexpr (instruction_t == base::meta<ir::MemCopyInstruction>) {
+      Load(emitter, Register::rsi, inst.from, context);
+      code.CopyBytes();
+    } else {
+      Load(emitter, Register::rax, inst.value, context);
+      code.FillBytes();
+    }
+  } else if constexpr (instruction_t == base::meta<ir::CallInstruction>) {
+    if (inst.outputs().size() > 1) { NOT_YET(); }
+    if (inst.arguments().size() > kArgumentRegisters.size()) { NOT_YET(); }
+    if (inst.func().is_reg() or
+        inst.func().value().kind() != ir::Fn::Kind::Native) {
+      NOT_YET();
+    }
+    // Only functions emitted into the same module can be called directly.
+    auto callee = context.functions.find(&*inst.func().value().native());
+    if (callee == context.functions.end()) {
+      NOT_YET("The baseline backend does not support calling ",
+              inst.to_string(), " outside the module being emitted.");
+    }
+    for (size_t i = 0; i < inst.arguments().size(); ++i) {
+      Load(emitter, kArgumentRegisters[i], inst.arguments()[i], context);
+    }
+    emitter.block().function_references.emplace_back(code.Call(),
+                                                      callee->second);
+    if (inst.outputs().size() == 1) {
+      emitter.Define(inst.outputs()[0], Register::rax);
+    }
+  } else {
+    static_assert(base::always_false(instruction_t));
+  }
+
+  return true;
+}
+
+template <typename... Insts>
+absl::flat_hash_map<base::MetaValue,
+                    bool (*)(BaselineEmitter &, BaselineEmitter::context_type &,
+                             ir::Inst const &)> const &
+InstructionMap(base::type_list<Insts...>) {
+  static absl::flat_hash_map<
+      base::MetaValue, bool (*)(BaselineEmitter &,
+                                BaselineEmitter::context_type &,
+                                ir::Inst const &)>
+      inst_map = {{base::meta<Insts>, EmitInstruction<Insts>}...};
+  return inst_map;
+}
+
+template <template <typename> typename Inst, typename... Ts>
+using Instantiate = base::type_list<Inst<Ts>...>;
+
+template <template <typename> typename Inst>
+using ForIntegers = Instantiate<Inst, int8_t, int16_t, int32_t, int64_t,
+                                uint8_t, uint16_t, uint32_t, uint64_t>;
+
+template <template <typename> typename Inst>
+using ForPhiTypes = Instantiate<Inst, bool, ir::Char, int8_t, int16_t, int32_t,
+                                int64_t, uint8_t, uint16_t, uint32_t, uint64_t,
+                                ir::addr_t>;
+
+using Instructions = base::type_list_cat<
+    ForIntegers<ir::AddInstruction>, ForIntegers<ir::SubInstruction>,
+    ForIntegers<ir::MulInstruction>, ForIntegers<ir::DivInstruction>,
+    ForIntegers<ir::ModInstruction>, ForIntegers<ir::EqInstruction>,
+    ForIntegers<ir::NeInstruction>, ForIntegers<ir::LtInstruction>,
+    ForIntegers<ir::LeInstruction>, ForPhiTypes<ir::PhiInstruction>,
+    ForPhiTypes<ir::SetReturnInstruction>, ForPhiTypes<ir::StoreInstruction>,
+    base::type_list<ir::LoadInstruction, ir::PtrIncrInstruction,
+                    ir::MemCopyInstruction, ir::MemSetInstruction,
+                    ir::CallInstruction>>;
+
+// Copies into the home slots of the phi instructions in `target` the values
+// they take when control reaches `target` from `from`. All values are read
+// before any are written, since a phi may read the result of another.
+void EmitPhiMoves(BaselineEmitter &emitter, ir::BasicBlock const *from,
+                  ir::BasicBlock const *target,
+                  BaselineEmitter::context_type const &context) {
+  std::vector<ir::Reg> results;
+  for (ir::Inst const &inst : target->instructions()) {
+    bool is_phi = [&]<typename... Ts>(base::type_list<Ts...>) {
+      return ([&]<typename T>() {
+        auto const *phi = inst.if_as<ir::PhiInstruction<T>>();
+        if (not phi) { return false; }
+        auto iter = std::find(phi->blocks.begin(), phi->blocks.end(), from);
+        ASSERT(iter != phi->blocks.end());
+        Load(emitter, Register::rax, phi->values[iter - phi->blocks.begin()],
+             context);
+        emitter.code().Push(Register::rax);
+        results.push_back(phi->result);
+        return true;
+      }.template operator()<Ts>() or ...);
+    }(PhiTypes{});
+    if (not is_phi) { break; }
+  }
+
+  auto const &fn = *emitter.block().function;
+  for (auto iter = results.rbegin(); iter != results.rend(); ++iter) {
+    emitter.code().Pop(Register::rax);
+    emitter.code().Store(BaselineEmitter::HomeSlot(fn, *iter), Register::rax,
+                         8);
+  }
+}
+
+// The slot in which the `n`th callee-saved register used by a function is saved
+// by its prologue.
+Memory SavedRegisterSlot(size_t n) {
+  return {.base         = Register::rbp,
+          .displacement = static_cast<int32_t>(-8 * (n + 1))};
+}
+
+}  // namespace
+
+BaselineEmitter::BaselineEmitter(module_type *module)
+    : Emitter<BaselineEmitter, BaselineBackendTraits>(module),
+      output_(*module) {}
+
+// The frame of each function holds, from the frame pointer down: the
+// callee-saved registers it uses, its return value, the home slots of its
+// registers and then of its arguments, and its stack allocations.
+x86_64::Memory BaselineEmitter::HomeSlot(function_type const &fn, ir::Reg r) {
+  int64_t index = r.is_arg() ? fn.num_regs + r.arg_value() : r.value();
+  int64_t slot  = kCacheRegisters.size() + 2 + index;
+  return {.base         = Register::rbp,
+          .displacement = static_cast<int32_t>(-8 * slot)};
+}
+
+x86_64::Memory BaselineEmitter::ReturnSlot() {
+  int64_t slot = kCacheRegisters.size() + 1;
+  return {.base         = Register::rbp,
+          .displacement = static_cast<int32_t>(-8 * slot)};
+}
+
+BaselineEmitter::function_type *BaselineEmitter::DeclareFunction(
+    ir::CompiledFn const *fn, module::Linkage linkage,
+    module_type &output_module) {
+  auto const &outputs = fn->type()->output();
+  if (outputs.size() > 1 or (outputs.size() == 1 and outputs[0].is_big())) {
+    NOT_YET("Not yet supporting multiple or big returns.");
+  }
+  if (fn->num_args() > kArgumentRegisters.size()) {
+    NOT_YET("Not yet supporting more than six arguments.");
+  }
+
+  auto &f         = output_module.functions_.emplace_back();
+  f.name          = absl::StrCat("icarus.fn.", output_module.functions_.size());
+  f.global        = (linkage == module::Linkage::External);
+  f.returns_value = not outputs.empty();
+  f.num_args      = fn->num_args();
+  f.num_regs      = fn->num_regs();
+  f.frame_size    = 8 * (kCacheRegisters.size() + 1 + f.num_regs + f.num_args);
+  return &f;
+}
+
+BaselineEmitter::basic_block_type *BaselineEmitter::DeclareBasicBlock(
+    function_type &fn) {
+  auto &block    = output_.blocks_.emplace_back();
+  block.function = &fn;
+  return &block;
+}
+
+void BaselineEmitter::PrepareForStackAllocation(
+    ir::CompiledFn const &fn,
+    const absl::flat_hash_map<ir::BasicBlock const *, basic_block_type *>
+        &block_map) {
+  block_ = block_map.at(fn.entry());
+}
+
+void BaselineEmitter::PrepareForBasicBlockAppend(basic_block_type *block) {
+  block->function->blocks.push_back(block);
+  block_ = block;
+  cache_.fill(std::nullopt);
+}
+
+BaselineEmitter::value_type *BaselineEmitter::StackAllocate(type::Type t) {
+  auto &fn = *block_->function;
+  fn.frame_size =
+      core::FwdAlign(core::Bytes(fn.frame_size) + t.bytes(core::Host),
+                     t.alignment(core::Host))
+          .value();
+  return &output_.values_.emplace_back(BaselineValue{-fn.frame_size});
+}
+
+void BaselineEmitter::Load(Register dst, ir::Reg r,
+                           context_type const &context) {
+  if (auto iter = context.registers.find(r); iter != context.registers.end()) {
+    code().LoadAddress(dst,
+                       {.base = Register::rbp,
+                        .displacement = iter->second->frame_offset});
+    return;
+  }
+  for (size_t i = 0; i < cache_.size(); ++i) {
+    if (cache_[i] == r) {
+      code().Move(dst, kCacheRegisters[i]);
+      return;
+    }
+  }
+  code().Load(dst, HomeSlot(*block_->function, r), 8, /*sign_extend=*/false);
+}
+
+void BaselineEmitter::Define(ir::Reg r, Register src) {
+  auto &fn = *block_->function;
+  code().Store(HomeSlot(fn, r), src, 8);
+
+  size_t i             = next_cache_register_;
+  next_cache_register_ = (i + 1) % kCacheRegisters.size();
+  cache_[i]            = r;
+  code().Move(kCacheRegisters[i], src);
+  if (std::find(fn.saved_registers.begin(), fn.saved_registers.end(),
+                kCacheRegisters[i]) == fn.saved_registers.end()) {
+    fn.saved_registers.push_back(kCacheRegisters[i]);
+  }
+}
+
+bool BaselineEmitter::EmitInstruction(ir::Inst const &instruction,
+                                      context_type &context) {
+  LOG("EmitInstruction", "Emitting machine code for %s",
+      instruction.to_string());
+  auto const &inst_map = InstructionMap(Instructions{});
+  if (auto iter = inst_map.find(instruction.rtti()); iter != inst_map.end()) {
+    return iter->second(*this, context, instruction);
+  } else {
+    NOT_YET("The baseline backend does not support ", instruction.to_string());
+  }
+}
+
+void BaselineEmitter::EmitBasicBlockJump(ir::BasicBlock const *block,
+                                         context_type &context,
+                                         bool returns_void) {
+  // Instructions have already been emitted for every block, so no register
+  // holds a known value.
+  block_ = context.blocks.at(block);
+  cache_.fill(std::nullopt);
+
+  switch (block->jump().kind()) {
+    case ir::JumpCmd::Kind::Return:
+      block_->epilogue_references.push_back(code().Jump());
+      return;
+    case ir::JumpCmd::Kind::Uncond: {
+      ir::BasicBlock const *target = block->jump().UncondTarget();
+      EmitPhiMoves(*this, block, target, context);
+      block_->block_references.emplace_back(code().Jump(),
+                                            context.blocks.at(target));
+    }
+      return;
+    case ir::JumpCmd::Kind::Cond: {
+      Load(Register::rax, block->jump().CondReg(), context);
+      code().Test(Register::rax, Register::rax);
+      size_t if_false = code().Jump(Condition::Equal);
+      for (bool condition : {true, false}) {
+        if (not condition) {
+          code().PatchDisplacement(if_false, code().size());
+        }
+        ir::BasicBlock const *target = block->jump().CondTarget(condition);
+        EmitPhiMoves(*this, block, target, context);
+        block_->block_references.emplace_back(code().Jump(),
+                                              context.blocks.at(target));
+      }
+    }
+      return;
+    case ir::JumpCmd::Kind::Choose:
+    default: UNREACHABLE("choose-jump should not be possible.");
+  }
+}
+
+std::string BaselineModule::ObjectFile() const {
+  x86_64::Assembler text;
+  absl::flat_hash_map<BaselineBlock const *, size_t> block_offsets;
+  absl::flat_hash_map<BaselineFunction const *, size_t> function_offsets;
+  absl::flat_hash_map<BaselineFunction const *, size_t> epilogue_offsets;
+  std::vector<x86_64::FunctionSymbol> symbols;
+
+  for (auto const &fn : functions_) {
+    size_t start = text.size();
+    function_offsets.emplace(&fn, start);
+
+    text.Push(Register::rbp);
+    text.Move(Register::rbp, Register::rsp);
+    // Keep the stack 16-byte aligned at each call.
+    text.Subtract(Register::rsp, (fn.frame_size + 15) / 16 * 16);
+    for (size_t i = 0; i < fn.saved_registers.size(); ++i) {
+      text.Store(SavedRegisterSlot(i), fn.saved_registers[i], 8);
+    }
+    for (size_t i = 0; i < fn.num_args; ++i) {
+      text.Store(BaselineEmitter::HomeSlot(fn, ir::Reg::Arg(i)),
+                 kArgumentRegisters[i], 8);
+    }
+
+    for (auto const *block : fn.blocks) {
+      block_offsets.emplace(block, text.size());
+      text.Append(block->code.code());
+    }
+
+    epilogue_offsets.emplace(&fn, text.size());
+    if (fn.returns_value) {
+      text.Load(Register::rax, BaselineEmitter::ReturnSlot(), 8,
+                /*sign_extend=*/false);
+    } else {
+      text.Move(Register::rax, uint64_t{0});
+    }
+    for (size_t i = 0; i < fn.saved_registers.size(); ++i) {
+      text.Load(fn.saved_registers[i], SavedRegisterSlot(i), 8,
+                /*sign_extend=*/false);
+    }
+    text.Move(Register::rsp, Register::rbp);
+    text.Pop(Register::rbp);
+    text.Return();
+
+    symbols.push_back({.name   = fn.name,
+                       .offset = start,
+                       .size   = text.size() - start,
+                       .global = fn.global});
+  }
+
+  for (auto const &fn : functions_) {
+    for (auto const *block : fn.blocks) {
+      size_t offset = block_offsets.at(block);
+      for (auto [position, target] : block->block_references) {
+        text.PatchDisplacement(offset + position, block_offsets.at(target));
+      }
+      for (auto [position, target] : block->function_references) {
+        text.PatchDisplacement(offset + position, function_offsets.at(target));
+      }
+      for (size_t position : block->epilogue_references) {
+        text.PatchDisplacement(offset + position, epilogue_offsets.at(&fn));
+      }
+    }
+  }
+
+  return x86_64::RelocatableObjectFile(text.code(), symbols);
+}
+
+}  // namespace backend
@@ -0,0 +1,144 @@
+#ifndef ICARUS_BACKEND_BASELINE_H
+#define ICARUS_BACKEND_BASELINE_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "backend/emit.h"
+#include "backend/x86_64/assembler.h"
+#include "compiler/module.h"
+#include "ir/compiled_fn.h"
+#include "ir/value/reg.h"
+#include "type/type.h"
+
+namespace backend {
+
+struct BaselineFunction;
+
+struct BaselineBlock {
+  BaselineFunction *function;
+  x86_64::Assembler code;
+  // Offsets of displacements in `code` referring to the start of a block, the
+  // start of a function, or the epilogue of the function containing the block.
+  std::vector<std::pair<size_t, BaselineBlock const *>> block_references;
+  std::vector<std::pair<size_t, BaselineFunction const *>> function_references;
+  std::vector<size_t> epilogue_references;
+};
+
+struct BaselineFunction {
+  std::string name;
+  bool global;
+  bool returns_value;
+  size_t num_args;
+  size_t num_regs;
+  // The number of bytes of stack used by the function below its frame pointer.
+  int32_t frame_size;
+  // Blocks in the order in which they are to be laid out.
+  std::vector<BaselineBlock *> blocks;
+  // Callee-saved registers used by the function, which must be restored before
+  // it returns.
+  std::vector<x86_64::Register> saved_registers;
+};
+
+// The address of a stack allocation, relative to the frame pointer.
+struct BaselineValue {
+  int32_t frame_offset;
+};
+
+// BaselineModule:
+//
+// Holds the machine code for each function emitted by a `BaselineEmitter`
+// until all functions have been emitted and can be laid out in an object file.
+struct BaselineModule {
+  // Returns the contents of a relocatable ELF object file holding each
+  // function in the module.
+  std::string ObjectFile() const;
+
+ private:
+  friend struct BaselineEmitter;
+
+  std::deque<BaselineFunction> functions_;
+  std::deque<BaselineBlock> blocks_;
+  std::deque<BaselineValue> values_;
+};
+
+struct BaselineBackendTraits {
+  using function_type    = BaselineFunction;
+  using basic_block_type = BaselineBlock;
+  using value_type       = BaselineValue;
+  using module_type      = BaselineModule;
+};
+
+// BaselineEmitter:
+//
+// Emits x86-64 machine code for the System V ABI directly, without an
+// optimizer, trading the speed of the generated code for the speed of
+// generating it. Each register has a home slot in its function's stack frame.
+// Registers are allocated in a single pass over each block: every result is
+// written to its home slot and also held in a callee-saved register, from
+// which later reads in the same block are served until the register is
+// reassigned.
+struct BaselineEmitter : Emitter<BaselineEmitter, BaselineBackendTraits> {
+  using traits_type  = BaselineBackendTraits;
+  using context_type = EmitContext<traits_type>;
+
+  explicit BaselineEmitter(module_type *module);
+
+  function_type *DeclareFunction(ir::CompiledFn const *fn,
+                                 module::Linkage linkage,
+                                 module_type &output_module);
+
+  basic_block_type *DeclareBasicBlock(function_type &fn);
+
+  void PrepareForStackAllocation(
+      ir::CompiledFn const &fn,
+      const absl::flat_hash_map<ir::BasicBlock const *, basic_block_type *>
+          &block_map);
+
+  void PrepareForBasicBlockAppend(basic_block_type *block);
+
+  value_type *StackAllocate(type::Type t);
+
+  bool EmitInstruction(ir::Inst const &instruction, context_type &context);
+
+  void EmitBasicBlockJump(ir::BasicBlock const *block, context_type &context,
+                          bool returns_void);
+
+  // Every register has a home slot, so there is never a need to refer to a
+  // register before it is defined.
+  void ResolveForwardReferences(context_type &) {}
+
+  x86_64::Assembler &code() { return block_->code; }
+  basic_block_type &block() { return *block_; }
+
+  // Loads the value of `r` into `dst`.
+  void Load(x86_64::Register dst, ir::Reg r, context_type const &context);
+  // Writes `src` to the home slot of `r`.
+  void Define(ir::Reg r, x86_64::Register src);
+
+  static x86_64::Memory HomeSlot(function_type const &fn, ir::Reg r);
+  static x86_64::Memory ReturnSlot();
+
+ private:
+  static constexpr std::array kCacheRegisters = {
+      x86_64::Register::rbx, x86_64::Register::r12, x86_64::Register::r13,
+      x86_64::Register::r14, x86_64::Register::r15};
+
+  module_type &output_;
+  basic_block_type *block_ = nullptr;
+
+  // The register held by each of `kCacheRegisters`, if any. Cleared at the
+  // start of each block.
+  std::array<std::optional<ir::Reg>, kCacheRegisters.size()> cache_;
+  size_t next_cache_register_ = 0;
+};
+
+}  // namespace backend
+
+#endif  // ICARUS_BACKEND_BASELINE_H
@@ -0,0 +1,150 @@
+#include "backend/baseline.h"
+
+#include <utility>
+#include <vector>
+
+#include "backend/x86_64/assembler.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ir/builder.h"
+#include "ir/compiled_fn.h"
+#include "ir/instruction/arithmetic.h"
+#include "ir/instruction/core.h"
+#include "type/function.h"
+#include "type/primitive.h"
+
+namespace backend {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using x86_64::Register;
+
+type::Function const *I64I64ToI64() {
+  return type::Func(
+      {core::AnonymousParam(type::QualType::NonConstant(type::I64)),
+       core::AnonymousParam(type::QualType::NonConstant(type::I64))},
+      {type::I64});
+}
+
+type::Function const *I64ToI64() {
+  return type::Func(
+      {core::AnonymousParam(type::QualType::NonConstant(type::I64))},
+      {type::I64});
+}
+
+std::vector<uint8_t> Code(x86_64::Assembler const &a) {
+  return std::vector<uint8_t>(a.code().begin(), a.code().end());
+}
+
+void SetReturn(ir::Builder &bldr, ir::RegOr<int64_t> value) {
+  bldr.CurrentBlock()->Append(
+      ir::SetReturnInstruction<int64_t>{.index = 0, .value = value});
+  bldr.ReturnJump();
+}
+
+struct BaselineEmitterTest : testing::Test {
+  BaselineEmitterTest()
+      : add(I64I64ToI64(),
+            core::Params<type::Typed<ast::Declaration const *>>(2)),
+        add_data{.fn = &add, .type = I64I64ToI64()},
+        emitter(&module) {
+    // add ::= (a: i64, b: i64) -> i64 { return a + b }
+    ir::Builder bldr;
+    bldr.CurrentGroup() = &add;
+    bldr.CurrentBlock() = add.entry();
+    ir::Reg sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+        .lhs    = ir::Reg::Arg(0),
+        .rhs    = ir::Reg::Arg(1),
+        .result = bldr.CurrentGroup()->Reserve()});
+    SetReturn(bldr, sum);
+  }
+
+  ir::CompiledFn add;
+  ir::NativeFn::Data add_data;
+  BaselineModule module;
+  BaselineEmitter emitter;
+};
+
+TEST_F(BaselineEmitterTest, AddAndReturn) {
+  BaselineFunction const *f =
+      emitter.EmitFunction(&add, module::Linkage::External);
+  ASSERT_NE(f, nullptr);
+  EXPECT_TRUE(f->global);
+  EXPECT_TRUE(f->returns_value);
+  EXPECT_EQ(f->num_args, 2);
+  EXPECT_THAT(f->saved_registers, ElementsAre(Register::rbx));
+  ASSERT_THAT(f->blocks, ElementsAre(::testing::_));
+
+  // Arguments are read from their home slots, the sum is written to its home
+  // slot and cached in `rbx`, from which the return value is then read.
+  x86_64::Assembler expected;
+  expected.Load(Register::rax, BaselineEmitter::HomeSlot(*f, ir::Reg::Arg(0)),
+                8, /*sign_extend=*/false);
+  expected.Load(Register::rcx, BaselineEmitter::HomeSlot(*f, ir::Reg::Arg(1)),
+                8, /*sign_extend=*/false);
+  expected.Add(Register::rax, Register::rcx);
+  expected.Extend(Register::rax, 8, /*sign_extend=*/true);
+  expected.Store(BaselineEmitter::HomeSlot(*f, ir::Reg(0)), Register::rax, 8);
+  expected.Move(Register::rbx, Register::rax);
+  expected.Move(Register::rax, Register::rbx);
+  expected.Store(BaselineEmitter::ReturnSlot(), Register::rax, 8);
+  size_t epilogue = expected.Jump();
+
+  BaselineBlock const &block = *f->blocks[0];
+  EXPECT_EQ(block.function, f);
+  EXPECT_EQ(Code(block.code), Code(expected));
+  EXPECT_THAT(block.epilogue_references, ElementsAre(epilogue));
+  EXPECT_THAT(block.block_references, IsEmpty());
+  EXPECT_THAT(block.function_references, IsEmpty());
+}
+
+TEST_F(BaselineEmitterTest, Call) {
+  // f ::= (n: i64) -> i64 { return add(n, 3) }
+  ir::CompiledFn caller(I64ToI64(),
+                        core::Params<type::Typed<ast::Declaration const *>>(1));
+  ir::Reg out;
+  {
+    ir::Builder bldr;
+    bldr.CurrentGroup() = &caller;
+    bldr.CurrentBlock() = caller.entry();
+    ir::OutParams outs  = bldr.OutParams(I64I64ToI64()->output());
+    out                 = outs[0];
+    bldr.Call(ir::Fn(ir::NativeFn(&add_data)), I64I64ToI64(),
+              {ir::Value(ir::RegOr<int64_t>(ir::Reg::Arg(0))),
+               ir::Value(ir::RegOr<int64_t>(3))},
+              std::move(outs));
+    SetReturn(bldr, out);
+  }
+
+  BaselineFunction const *callee =
+      emitter.EmitFunction(&add, module::Linkage::Internal);
+  BaselineFunction const *f =
+      emitter.EmitFunction(&caller, module::Linkage::External);
+  ASSERT_NE(f, callee);
+  EXPECT_FALSE(callee->global);
+  ASSERT_THAT(f->blocks, ElementsAre(::testing::_));
+
+  // Arguments are passed in `rdi` and `rsi`, and the result is taken from
+  // `rax`.
+  x86_64::Assembler expected;
+  expected.Load(Register::rdi, BaselineEmitter::HomeSlot(*f, ir::Reg::Arg(0)),
+                8, /*sign_extend=*/false);
+  expected.Move(Register::rsi, uint64_t{3});
+  size_t call = expected.Call();
+  expected.Store(BaselineEmitter::HomeSlot(*f, out), Register::rax, 8);
+  expected.Move(Register::rbx, Register::rax);
+  expected.Move(Register::rax, Register::rbx);
+  expected.Store(BaselineEmitter::ReturnSlot(), Register::rax, 8);
+  size_t epilogue = expected.Jump();
+
+  BaselineBlock const &block = *f->blocks[0];
+  EXPECT_EQ(Code(block.code), Code(expected));
+  EXPECT_THAT(block.function_references, ElementsAre(Pair(call, callee)));
+  EXPECT_THAT(block.epilogue_references, ElementsAre(epilogue));
+  EXPECT_THAT(block.block_references, IsEmpty());
+}
+
+}  // namespace
+}  // namespace backend
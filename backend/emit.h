@@ -1,14 +1,18 @@
 #ifndef ICARUS_BACKEND_EMIT_H
 #define ICARUS_BACKEND_EMIT_H
 
+#include <concepts>
+#include <optional>
+#include <utility>
 #include <vector>
-#include <tuple>
 
 #include "absl/container/flat_hash_map.h"
-#include "absl/types/span.h"
+#include "absl/container/flat_hash_set.h"
+#include "base/debug.h"
 #include "compiler/module.h"
 #include "ir/compiled_fn.h"
 #include "ir/value/reg.h"
+#include "opt/cfg.h"
 #include "type/type.h"
 
 namespace backend {
@@ -24,6 +28,9 @@ struct EmitContext {
                       typename Traits::basic_block_type *>
       blocks;
   absl::flat_hash_map<ir::Reg, typename Traits::value_type *> registers;
+  // Placeholders for registers read before they were defined.
+  absl::flat_hash_map<ir::Reg, typename Traits::value_type *>
+      forward_references;
   absl::flat_hash_map<ir::CompiledFn const *, typename Traits::function_type *>
       &functions;
 };
@@ -36,19 +43,33 @@ struct Emitter {
   using value_type       = typename Traits::value_type;
 
   void EmitModule(compiler::CompiledModule const &module) {
+    EmitModule(module, [](ir::CompiledFn const *) { return true; });
+  }
+
+  // Declares every function in `module`, but only emits definitions for those
+  // on which `should_define` returns true. Functions are always declared in the
+  // same order. If `linkage` is provided, every function is declared with it
+  // rather than with its own linkage, so that a module may be split across
+  // several output modules whose definitions refer to one another.
+  void EmitModule(compiler::CompiledModule const &module,
+                  std::predicate<ir::CompiledFn const *> auto &&should_define,
+                  std::optional<module::Linkage> linkage = std::nullopt) {
     auto &emitter = *static_cast<Derived *>(this);
 
+    std::vector<std::pair<ir::CompiledFn const *, module::Linkage>> to_define;
     module.context().ForEachCompiledFn(
-        [&](ir::CompiledFn const *fn, module::Linkage linkage) {
+        [&](ir::CompiledFn const *fn, module::Linkage fn_linkage) {
           LOG("Emitter", "Declaring function %p", fn);
+          fn_linkage = linkage.value_or(fn_linkage);
           contexts_.try_emplace(fn, functions_);
-          functions_.emplace(fn, emitter.DeclareFunction(fn, linkage, module_));
+          functions_.emplace(fn,
+                             emitter.DeclareFunction(fn, fn_linkage, module_));
+          if (should_define(fn)) { to_define.emplace_back(fn, fn_linkage); }
         });
 
-    module.context().ForEachCompiledFn(
-        [&](ir::CompiledFn const *fn, module::Linkage linkage) {
-          emitter.EmitFunction(fn, linkage);
-        });
+    for (auto [fn, fn_linkage] : to_define) {
+      emitter.EmitFunction(fn, fn_linkage);
+    }
   }
 
   function_type *EmitFunction(ir::CompiledFn const *fn,
@@ -58,10 +79,10 @@ struct Emitter {
 
     contexts_.try_emplace(fn, functions_);
     auto [iter, inserted] = functions_.try_emplace(fn);
-    function_type *f;
     if (inserted) {
-      f = iter->second = emitter.DeclareFunction(fn, linkage, module_);
+      iter->second = emitter.DeclareFunction(fn, linkage, module_);
     }
+    function_type *f = iter->second;
     DeclareBasicBlocks(fn);
 
     emitter.AllocateLocalVariables(*fn);
@@ -98,41 +119,33 @@ struct Emitter {
   }
 
  private:
+  // Blocks are emitted in reverse post-order, so the block defining a register
+  // is emitted before every block it dominates. Registers read before they are
+  // defined (e.g., loop-carried values read by phi instructions) are given
+  // forward references by the derived emitter, which are resolved once the
+  // entire function has been emitted. Blocks unreachable from the entry are
+  // emitted last.
   void EmitBasicBlocks(ir::CompiledFn const &fn) {
-    std::vector<std::tuple<ir::BasicBlock const *, basic_block_type *,
-                           absl::Span<ir::Inst const>>>
-        to_process;
-    auto &ctx = contexts_.at(&fn);
-    for (auto const *block : fn.blocks()) {
-      to_process.emplace_back(block, ctx.blocks.at(block),
-                              block->instructions());
+    auto &emitter = *static_cast<Derived *>(this);
+    auto &ctx     = contexts_.at(&fn);
+
+    std::vector<ir::BasicBlock const *> order = opt::ReversePostOrder(fn);
+    if (order.size() != fn.blocks().size()) {
+      absl::flat_hash_set<ir::BasicBlock const *> reachable(order.begin(),
+                                                            order.end());
+      for (auto const *block : fn.blocks()) {
+        if (not reachable.contains(block)) { order.push_back(block); }
+      }
     }
 
-    auto front_iter = to_process.begin();
-    auto back_iter  = to_process.end();
-    while (front_iter != back_iter) {
-      while (front_iter != back_iter) {
-        auto &[in_block, out_block, instructions] = *front_iter;
-        static_cast<Derived *>(this)->PrepareForBasicBlockAppend(out_block);
-
-        while (not instructions.empty()) {
-          if (static_cast<Derived *>(this)->EmitInstruction(
-                  instructions.front(), ctx)) {
-            instructions.remove_prefix(1);
-          } else {
-            break;
-          }
-        }
-
-        if (instructions.empty()) {
-          *front_iter = *back_iter;
-          --back_iter;
-        } else {
-          ++front_iter;
-        }
+    for (auto const *block : order) {
+      emitter.PrepareForBasicBlockAppend(ctx.blocks.at(block));
+      for (ir::Inst const &inst : block->instructions()) {
+        bool emitted = emitter.EmitInstruction(inst, ctx);
+        ASSERT(emitted == true);
       }
-      front_iter = to_process.begin();
     }
+    emitter.ResolveForwardReferences(ctx);
   }
 
   module_type &module_;
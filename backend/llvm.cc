@@ -1,19 +1,36 @@
 #include "backend/llvm.h"
 
+#include <iterator>
+#include <string>
+
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "backend/type.h"
 #include "base/log.h"
 #include "base/meta.h"
+#include "core/arch.h"
 #include "ir/instruction/arithmetic.h"
+#include "ir/instruction/core.h"
 #include "ir/instruction/instructions.h"
+#include "ir/read_only_data.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
 
 namespace backend {
 
 LlvmEmitter::function_type *LlvmEmitter::DeclareFunction(
     ir::CompiledFn const *fn, module::Linkage linkage,
     module_type &output_module) {
+  // Externally visible functions are named in the order they are declared.
+  // Modules declaring the same functions in the same order therefore agree on
+  // their names and may be linked together.
+  std::string name =
+      linkage == module::Linkage::External
+          ? absl::StrCat("icarus.fn.", num_external_functions_++)
+          : "fn";
   return llvm::Function::Create(
       llvm::cast<llvm::FunctionType>(ToLlvmType(fn->type(), context_)),
       [&] {
@@ -23,7 +40,7 @@ LlvmEmitter::function_type *LlvmEmitter::DeclareFunction(
             return llvm::Function::ExternalLinkage;
         }
       }(),
-      "fn", &output_module);
+      name, &output_module);
 }
 
 LlvmEmitter::LlvmEmitter(llvm::IRBuilder<> &builder, module_type *module)
@@ -40,6 +57,7 @@ void LlvmEmitter::PrepareForStackAllocation(
     ir::CompiledFn const &fn,
     const absl::flat_hash_map<ir::BasicBlock const *, basic_block_type *>
         &block_map) {
+  fn_ = &fn;
   PrepareForBasicBlockAppend(block_map.at(fn.entry()));
 }
 
@@ -164,6 +182,26 @@ bool EmitInstruction(LlvmEmitter &emitter, LlvmEmitter::context_type &context,
       context.registers.emplace(inst.result,
                                 emitter.builder().CreateICmpULE(&lhs, &rhs));
     }
+  } else if constexpr (instruction_t.template is_a<ir::PhiInstruction>()) {
+    // Phi instructions lead their blocks, but values flowing in along back
+    // edges have not yet been emitted. These are resolved as forward references
+    // once the whole function has been emitted.
+    using type = typename Inst::type;
+    auto *phi  = emitter.builder().CreatePHI(emitter.RegisterType<type>(),
+                                             inst.values.size());
+    for (size_t i = 0; i < inst.values.size(); ++i) {
+      auto *value    = emitter.Resolve(inst.values[i], context);
+      auto *incoming = context.blocks.at(inst.blocks[i]);
+      if (value->getType() != phi->getType()) {
+        // Addresses of differing pointee types are merged as `i8*`. Jumps are
+        // emitted after every block, so the cast still precedes the incoming
+        // block's terminator.
+        llvm::IRBuilder<> incoming_builder(incoming);
+        value = incoming_builder.CreatePointerCast(value, phi->getType());
+      }
+      phi->addIncoming(value, incoming);
+    }
+    context.registers.emplace(inst.result, phi);
   } else if constexpr (instruction_t
                            .template is_a<ir::SetReturnInstruction>()) {
     ASSIGN_OR(return false, auto &value, emitter.Resolve(inst.value, context));
@@ -175,18 +213,87 @@ bool EmitInstruction(LlvmEmitter &emitter, LlvmEmitter::context_type &context,
   } else if constexpr (instruction_t.template is_a<ir::StoreInstruction>()) {
     ASSIGN_OR(return false, auto &value, emitter.Resolve(inst.value, context));
     ASSIGN_OR(return false, auto &loc, emitter.Resolve(inst.location, context));
-    emitter.builder().CreateStore(&value, &loc);
+    emitter.builder().CreateStore(
+        &value, emitter.builder().CreatePointerCast(
+                    &loc, value.getType()->getPointerTo()));
   } else if constexpr (instruction_t == base::meta<ir::LoadInstruction>) {
     ASSIGN_OR(return false, auto &addr, emitter.Resolve(inst.addr, context));
+    auto *t = ToLlvmType(inst.type, emitter.context());
     context.registers.emplace(
-        inst.result, emitter.builder().CreateLoad(
-                         ToLlvmType(inst.type, emitter.context()), &addr));
+        inst.result,
+        emitter.builder().CreateLoad(
+            t, emitter.builder().CreatePointerCast(&addr, t->getPointerTo())));
   } else if constexpr (instruction_t == base::meta<ir::PtrIncrInstruction>) {
+    auto *t = ToLlvmType(inst.ptr, emitter.context());
     context.registers.emplace(
         inst.result,
-        emitter.builder().CreateGEP(ToLlvmType(inst.ptr, emitter.context()),
-                                    emitter.Resolve(inst.addr, context),
-                                    emitter.Resolve(inst.index, context)));
+        emitter.builder().CreateGEP(
+            t,
+            emitter.builder().CreatePointerCast(
+                emitter.Resolve(inst.addr, context), t->getPointerTo()),
+            emitter.Resolve(inst.index, context)));
+  } else if constexpr (instruction_t == base::meta<ir::MemCopyInstruction> or
+                       instruction_t == base::meta<ir::MemSetInstruction>) {
+    // Lowered to `llvm.memcpy` or `llvm.memset` so that the optimizer may
+    // reason about (and often eliminate) the bulk memory operation.
+    core::Bytes stride = core::FwdAlign(inst.type.bytes(core::Host),
+                                        inst.type.alignment(core::Host));
+    llvm::MaybeAlign alignment(inst.type.alignment(core::Host).value());
+    auto *bytes = emitter.builder().CreateMul(
+        emitter.Resolve(inst.count, context),
+        emitter.builder().getInt64(stride.value()));
+    if constexpr (instruction_t == base::meta<ir::MemCopyInstruction>) {
+      emitter.builder().CreateMemCpy(emitter.Resolve(inst.to, context),
+                                     alignment,
+                                     emitter.Resolve(inst.from, context),
+                                     alignment, bytes);
+    } else {
+      emitter.builder().CreateMemSet(emitter.Resolve(inst.to, context),
+                                     emitter.Resolve(inst.value, context),
+                                     bytes, alignment);
+    }
+  } else if constexpr (instruction_t == base::meta<ir::MemCompareInstruction> or
+                       instruction_t == base::meta<ir::MallocInstruction> or
+                       instruction_t == base::meta<ir::FreeInstruction>) {
+    // Lowered to calls to the C library, whose semantics LLVM knows. The
+    // optimizer may expand small comparisons inline and remove unused
+    // allocations.
+    auto &builder = emitter.builder();
+    auto *module  = builder.GetInsertBlock()->getModule();
+    auto *i8_ptr  = builder.getInt8PtrTy();
+    if constexpr (instruction_t == base::meta<ir::MemCompareInstruction>) {
+      auto memcmp =
+          module->getOrInsertFunction("memcmp", builder.getInt32Ty(), i8_ptr,
+                                      i8_ptr, builder.getInt64Ty());
+      context.registers.emplace(
+          inst.result,
+          builder.CreateCall(
+              memcmp,
+              {builder.CreatePointerCast(emitter.Resolve(inst.lhs, context),
+                                         i8_ptr),
+               builder.CreatePointerCast(emitter.Resolve(inst.rhs, context),
+                                         i8_ptr),
+               emitter.Resolve(inst.bytes, context)}));
+    } else if constexpr (instruction_t == base::meta<ir::MallocInstruction>) {
+      auto malloc = module->getOrInsertFunction("malloc", i8_ptr,
+                                                builder.getInt64Ty());
+      core::Bytes stride = core::FwdAlign(inst.type.bytes(core::Host),
+                                          inst.type.alignment(core::Host));
+      auto *bytes =
+          builder.CreateMul(emitter.Resolve(inst.count, context),
+                            builder.getInt64(stride.value()));
+      context.registers.emplace(
+          inst.result,
+          builder.CreatePointerCast(
+              builder.CreateCall(malloc, {bytes}),
+              ToLlvmType(inst.type, emitter.context())->getPointerTo()));
+    } else {
+      auto free = module->getOrInsertFunction("free", builder.getVoidTy(),
+                                              i8_ptr);
+      builder.CreateCall(
+          free, {builder.CreatePointerCast(emitter.Resolve(inst.addr, context),
+                                           i8_ptr)});
+    }
   } else if constexpr (instruction_t == base::meta<ir::CallInstruction>) {
     // TODO: support multiple outputs
     if (inst.outputs().size() > 1) { NOT_YET(); }
@@ -199,11 +306,29 @@ bool EmitInstruction(LlvmEmitter &emitter, LlvmEmitter::context_type &context,
                          uint8_t, uint16_t, uint32_t, uint64_t, float, double,
                          ir::Reg, ir::addr_t, ir::Fn>([&](auto v) {
         using T = std::decay_t<decltype(v)>;
+        type::Type param_type = param_iter->value.type();
+        // Big arguments are held by address, whether in a register or as a
+        // constant, and small aggregates are loaded to be passed by value.
+        if constexpr (base::meta<T> == base::meta<ir::Reg> or
+                      base::meta<T> == base::meta<ir::addr_t>) {
+          if (param_type.is_big()) {
+            auto *addr = emitter.Resolve<ir::addr_t>(v, context);
+            if (type::IsSmallAggregate(param_type, core::Host)) {
+              auto *t = ToLlvmType(param_type, emitter.context());
+              addr    = emitter.builder().CreateLoad(
+                  t, emitter.builder().CreatePointerCast(addr,
+                                                         t->getPointerTo()));
+            }
+            args.push_back(addr);
+            return;
+          }
+        }
+
         if constexpr (base::meta<T> == base::meta<ir::Reg>) {
-          if (param_iter->value.type().template is<type::Pointer>()) {
+          if (param_type.template is<type::Pointer>()) {
             args.push_back(emitter.Resolve<ir::addr_t>(v, context));
           } else {
-            param_iter->value.type().template as<type::Primitive>().Apply(
+            param_type.template as<type::Primitive>().Apply(
                 [&]<typename T>() {
                   args.push_back(emitter.Resolve<T>(v, context));
                 });
@@ -214,11 +339,38 @@ bool EmitInstruction(LlvmEmitter &emitter, LlvmEmitter::context_type &context,
       });
       ++param_iter;
     }
+
+    // A single big output is returned by value if it is a small aggregate and
+    // is written through an output parameter pointer otherwise. Either way,
+    // the IR holds its address.
+    type::Type out_type =
+        inst.outputs().size() == 1 ? fn_type->output()[0] : type::Type();
+    bool out_is_big = out_type.valid() and out_type.is_big();
+    bool out_by_value =
+        out_is_big and type::IsSmallAggregate(out_type, core::Host);
+    if (out_is_big and not out_by_value) {
+      args.push_back(
+          emitter.Resolve<ir::addr_t>(inst.outputs()[0], context));
+    }
+
+    // Addresses of read-only constants must be cast to the parameter types.
+    auto *llvm_fn_type = llvm::cast<llvm::FunctionType>(
+        ToLlvmType(fn_type, emitter.builder().getContext()));
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (not args[i]->getType()->isPointerTy() or
+          not llvm_fn_type->getParamType(i)->isPointerTy()) {
+        continue;
+      }
+      args[i] = emitter.builder().CreatePointerCast(
+          args[i], llvm_fn_type->getParamType(i));
+    }
+
     auto *result = emitter.builder().CreateCall(
-        llvm::cast<llvm::FunctionType>(
-            ToLlvmType(fn_type, emitter.builder().getContext())),
-        emitter.Resolve(inst.func(), context), args);
-    if (inst.outputs().size() == 1) {
+        llvm_fn_type, emitter.Resolve(inst.func(), context), args);
+    if (out_by_value) {
+      emitter.builder().CreateStore(
+          result, emitter.Resolve<ir::addr_t>(inst.outputs()[0], context));
+    } else if (inst.outputs().size() == 1 and not out_is_big) {
       context.registers.emplace(inst.outputs()[0], result);
     }
 
@@ -279,6 +431,12 @@ bool LlvmEmitter::EmitInstruction(ir::Inst const &instruction,
       ir::LeInstruction<int32_t>, ir::LeInstruction<uint32_t>,
       ir::LeInstruction<int64_t>, ir::LeInstruction<uint64_t>,
       ir::LeInstruction<float>, ir::LeInstruction<double>,
+      ir::PhiInstruction<bool>, ir::PhiInstruction<int8_t>,
+      ir::PhiInstruction<uint8_t>, ir::PhiInstruction<int16_t>,
+      ir::PhiInstruction<uint16_t>, ir::PhiInstruction<int32_t>,
+      ir::PhiInstruction<uint32_t>, ir::PhiInstruction<int64_t>,
+      ir::PhiInstruction<uint64_t>, ir::PhiInstruction<float>,
+      ir::PhiInstruction<double>, ir::PhiInstruction<ir::addr_t>,
       ir::SetReturnInstruction<bool>, ir::SetReturnInstruction<int8_t>,
       ir::SetReturnInstruction<uint8_t>, ir::SetReturnInstruction<int16_t>,
       ir::SetReturnInstruction<uint16_t>, ir::SetReturnInstruction<int32_t>,
@@ -291,7 +449,9 @@ bool LlvmEmitter::EmitInstruction(ir::Inst const &instruction,
       ir::StoreInstruction<uint32_t>, ir::StoreInstruction<int64_t>,
       ir::StoreInstruction<uint64_t>, ir::StoreInstruction<float>,
       ir::StoreInstruction<double>, ir::LoadInstruction, ir::CallInstruction,
-      ir::PtrIncrInstruction>();
+      ir::PtrIncrInstruction, ir::MemCopyInstruction, ir::MemSetInstruction,
+      ir::MemCompareInstruction, ir::MallocInstruction,
+      ir::FreeInstruction>();
   LOG("EmitInstruction", "Emitting LLVM IR for %s", instruction.to_string());
   if (auto iter = inst_map.find(instruction.rtti()); iter != inst_map.end()) {
     return iter->second(*this, context, instruction);
@@ -301,19 +461,105 @@ bool LlvmEmitter::EmitInstruction(ir::Inst const &instruction,
   }
 }
 
+void LlvmEmitter::ResolveForwardReferences(context_type &context) {
+  for (auto [reg, placeholder] : context.forward_references) {
+    auto iter = context.registers.find(reg);
+    if (iter == context.registers.end()) {
+      NOT_YET("Register ", reg, " is read but never defined.");
+    }
+    auto *value = iter->second;
+    if (value->getType() != placeholder->getType()) {
+      // Forward references to addresses are `i8*`, so the definition must be
+      // cast immediately after it (or after the phis leading its block).
+      auto *def   = llvm::cast<llvm::Instruction>(value);
+      auto *block = def->getParent();
+      auto insertion_point = llvm::isa<llvm::PHINode>(def)
+                                 ? block->getFirstInsertionPt()
+                                 : std::next(def->getIterator());
+      llvm::IRBuilder<> cast_builder(block, insertion_point);
+      value = cast_builder.CreatePointerCast(value, placeholder->getType());
+    }
+    placeholder->replaceAllUsesWith(value);
+    placeholder->deleteValue();
+  }
+  context.forward_references.clear();
+}
+
+LlvmEmitter::value_type *LlvmEmitter::ReadOnlyGlobal(ir::addr_t addr) {
+  auto *i8_ptr = llvm::Type::getInt8PtrTy(context_);
+  if (addr == ir::Null()) { return llvm::ConstantPointerNull::get(i8_ptr); }
+
+  auto [iter, inserted] = read_only_globals_.try_emplace(addr);
+  if (inserted) {
+    auto bytes = ir::GlobalReadOnlyData.lock()->Find(addr);
+    // Only constants consisting of plain data are interned. Others hold
+    // addresses within the compiler, which cannot be emitted as bytes.
+    if (not bytes) { NOT_YET("Address outside of read-only data"); }
+    auto *init = llvm::ConstantDataArray::getRaw(
+        llvm::StringRef(bytes->data(), bytes->size()), bytes->size(),
+        llvm::Type::getInt8Ty(context_));
+    auto *global = new llvm::GlobalVariable(
+        *builder_.GetInsertBlock()->getModule(), init->getType(),
+        /*isConstant=*/true, llvm::GlobalValue::PrivateLinkage, init,
+        "icarus.rodata");
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    global->setAlignment(llvm::Align(ir::ReadOnlyData::kAlignment));
+    iter->second = llvm::ConstantExpr::getPointerCast(global, i8_ptr);
+  }
+  return iter->second;
+}
+
+LlvmEmitter::value_type *LlvmEmitter::AggregateSlot(ir::Reg r,
+                                                    context_type &context) {
+  llvm::Function *fn = builder_.GetInsertBlock()->getParent();
+  llvm::Argument *arg =
+      r.is_arg() ? fn->arg_begin() + r.arg_value() : nullptr;
+  llvm::Type *t = arg ? arg->getType() : fn->getReturnType();
+  if (not t->isAggregateType()) { return nullptr; }
+
+  auto [iter, inserted] = context.registers.try_emplace(r);
+  if (inserted) {
+    llvm::BasicBlock &entry = fn->getEntryBlock();
+    llvm::IRBuilder<> entry_builder(&entry, entry.begin());
+    iter->second = entry_builder.CreateAlloca(t);
+    if (arg) { entry_builder.CreateStore(arg, iter->second); }
+  }
+  return iter->second;
+}
+
+LlvmEmitter::value_type *LlvmEmitter::OutputArgument(ir::Reg r) {
+  // Outputs which are not returned by value are written through pointers
+  // passed after the inputs, one per output.
+  llvm::Function *fn = builder_.GetInsertBlock()->getParent();
+  if (not fn->getReturnType()->isVoidTy()) { return nullptr; }
+  size_t num_outputs = fn_->type()->output().size();
+  if (r.out_value() >= num_outputs) { return nullptr; }
+  return fn->arg_begin() + (fn->arg_size() - num_outputs + r.out_value());
+}
+
 void LlvmEmitter::EmitBasicBlockJump(ir::BasicBlock const *block,
                                      context_type &context, bool returns_void) {
   builder_.SetInsertPoint(context.blocks.at(block));
 
   switch (block->jump().kind()) {
-    case ir::JumpCmd::Kind::Return:
-      if (returns_void) { builder_.CreateRetVoid(); }
+    case ir::JumpCmd::Kind::Return: {
+      llvm::Type *t = builder_.GetInsertBlock()->getParent()->getReturnType();
+      if (returns_void or t->isVoidTy()) {
+        builder_.CreateRetVoid();
+      } else if (t->isAggregateType()) {
+        // The IR has written the small aggregate being returned into its
+        // output slot, from which it is loaded and returned by value.
+        builder_.CreateRet(builder_.CreateLoad(
+            t, AggregateSlot(ir::Reg::Out(0), context)));
+      }
       return;
+    }
     case ir::JumpCmd::Kind::Uncond:
       builder_.CreateBr(context.blocks.at(block->jump().UncondTarget()));
       return;
     case ir::JumpCmd::Kind::Cond:
-      builder_.CreateCondBr(context.registers.at(block->jump().CondReg()),
+      builder_.CreateCondBr(Resolve(ir::RegOr<bool>(block->jump().CondReg()),
+                                    context),
                             context.blocks.at(block->jump().CondTarget(true)),
                             context.blocks.at(block->jump().CondTarget(false)));
       return;
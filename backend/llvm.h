@@ -6,7 +6,9 @@
 #include "backend/type.h"
 #include "compiler/module.h"
 #include "ir/compiled_fn.h"
+#include "ir/value/addr.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 
 namespace backend {
@@ -44,20 +46,71 @@ struct LlvmEmitter : Emitter<LlvmEmitter, LlvmBackendTraits> {
   void EmitBasicBlockJump(ir::BasicBlock const *block, context_type &context,
                           bool returns_void);
 
+  // Replaces each placeholder in `context.forward_references` with the value
+  // eventually defined for its register.
+  void ResolveForwardReferences(context_type &context);
+
   llvm::IRBuilder<> &builder() { return builder_; }
   llvm::LLVMContext &context() { return context_; }
 
+  // Returns the type used for values of type `T` whose definition has not been
+  // seen. The pointee type of an address is not known there, so addresses use
+  // `i8*` and are cast to and from it as needed.
+  template <typename T>
+  llvm::Type *RegisterType() {
+    if constexpr (base::meta<T> == base::meta<ir::addr_t>) {
+      return llvm::Type::getInt8PtrTy(context_);
+    } else {
+      return LlvmType<T>(context_);
+    }
+  }
+
+  // Returns the address of a stack slot in the entry block of the current
+  // function holding the small aggregate argument or return value `r`, which
+  // the IR refers to by address but the function receives or returns by value.
+  // Returns null if `r` is not such an aggregate.
+  value_type *AggregateSlot(ir::Reg r, context_type &context);
+
+  // Returns the pointer argument through which the current function writes its
+  // output `r`, or null if its outputs are returned by value.
+  value_type *OutputArgument(ir::Reg r);
+
+  // Returns a pointer to a private constant global holding the read-only
+  // constant at `addr`, which is emitted into the module on first use. Because
+  // the pointee type of the result is `i8`, it must be cast to the pointer type
+  // expected by its users.
+  value_type *ReadOnlyGlobal(ir::addr_t addr);
+
   template <typename T>
   value_type *Resolve(ir::RegOr<T> val, context_type &context) {
     if (val.is_reg()) {
+      if (val.reg().is_arg() or val.reg().is_out()) {
+        if (auto *slot = AggregateSlot(val.reg(), context)) { return slot; }
+      }
       if (val.reg().is_arg()) {
         // TODO: Use getArg when you upgrade to llvm 11.0
         return builder_.GetInsertBlock()->getParent()->arg_begin() +
                val.reg().arg_value();
       }
+      if (val.reg().is_out()) {
+        if (auto *arg = OutputArgument(val.reg())) { return arg; }
+        NOT_YET("Output register ", val.reg(), " has no output argument.");
+      }
       auto iter = context.registers.find(val.reg());
-      if (iter == context.registers.end()) { return nullptr; }
-      return iter->second;
+      if (iter != context.registers.end()) { return iter->second; }
+      if constexpr (std::is_arithmetic_v<T> or
+                    base::meta<T> == base::meta<ir::addr_t>) {
+        // The register is defined in a block which has not yet been emitted,
+        // so a detached placeholder of the same type is used in its place.
+        auto [ref_iter, inserted] =
+            context.forward_references.try_emplace(val.reg());
+        if (inserted) {
+          ref_iter->second = llvm::PHINode::Create(RegisterType<T>(), 0);
+        }
+        return ref_iter->second;
+      } else {
+        NOT_YET("Forward reference to a register of type ", typeid(T).name());
+      }
     } else {
       if constexpr (std::is_integral_v<T>) {
         return llvm::Constant::getIntegerValue(
@@ -65,10 +118,19 @@ struct LlvmEmitter : Emitter<LlvmEmitter, LlvmBackendTraits> {
             llvm::APInt(sizeof(T) * CHAR_BIT,
                         static_cast<uint64_t>(val.value()),
                         std::is_signed_v<T>));
+      } else if constexpr (base::meta<T> == base::meta<ir::addr_t>) {
+        return ReadOnlyGlobal(val.value());
       } else if constexpr (base::meta<T> == base::meta<ir::Fn>) {
         switch (val.value().kind()) {
           case ir::Fn::Kind::Native: {
-            return context.functions.at(&*val.value().native());
+            // Only functions declared in the module being emitted can be
+            // referred to directly.
+            auto iter = context.functions.find(&*val.value().native());
+            if (iter == context.functions.end()) {
+              NOT_YET("Reference to a function outside the module: ",
+                      val.value());
+            }
+            return iter->second;
           } break;
           default: NOT_YET();
         }
@@ -81,6 +143,10 @@ struct LlvmEmitter : Emitter<LlvmEmitter, LlvmBackendTraits> {
  private:
   llvm::IRBuilder<> &builder_;
   llvm::LLVMContext &context_;
+  // The function whose definition is being emitted.
+  ir::CompiledFn const *fn_   = nullptr;
+  int num_external_functions_ = 0;
+  absl::flat_hash_map<ir::addr_t, llvm::Constant *> read_only_globals_;
 };
 
 }  // namespace backend
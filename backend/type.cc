@@ -1,5 +1,7 @@
 #include "backend/type.h"
 
+#include "core/arch.h"
+#include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "type/array.h"
@@ -54,21 +56,31 @@ struct LlvmTypeVisitor : type::Visitor<LlvmTypeTag, llvm::Type *()> {
   // qualifier-level distinction in Icarus. We don't actually take this into
   // account yet.
   llvm::Type *get(type::Function const *t) {
+    // Small aggregates are passed by value, leaving it to LLVM to split them
+    // across registers as the target ABI requires. Other big types are passed
+    // by address.
     std::vector<llvm::Type *> param_types;
     for (auto const &p : t->params()) {
       if (p.value.constant()) { continue; }
-      param_types.push_back(get(p.value.type()));
+      type::Type param_type = p.value.type();
+      param_types.push_back(
+          param_type.is_big() and
+                  not type::IsSmallAggregate(param_type, core::Host)
+              ? get(param_type)->getPointerTo()
+              : get(param_type));
     }
 
     //  If an Icarus function has exactly one return value and it fits in a
-    //  register, we use the function types return value. Otherwise, we use
-    //  output parameter pointers.
+    //  register (or a pair of registers, for small aggregates), we use the
+    //  function types return value. Otherwise, we use output parameter
+    //  pointers.
     //
-    //  TODO: We could maybe do better than this by packing two `i32`s into a
-    //  single register on 64-bit architectures. We could also try to pick one
-    //  return type that does fit in a rgeister and use that.
+    //  TODO: We could also try to pick one return type that does fit in a
+    //  register and use that.
     auto const output_span = t->output();
-    if (output_span.size() != 1 or output_span[0].get()->is_big()) {
+    if (output_span.size() != 1 or
+        (output_span[0].is_big() and
+         not type::IsSmallAggregate(output_span[0], core::Host))) {
       for (auto out_type : output_span) {
         param_types.push_back(get(out_type)->getPointerTo());
       }
@@ -92,7 +104,14 @@ struct LlvmTypeVisitor : type::Visitor<LlvmTypeTag, llvm::Type *()> {
   llvm::Type *get(type::GenericStruct const *t) { NOT_YET(); }
   llvm::Type *get(type::Jump const *t) { NOT_YET(); }
   llvm::Type *get(type::Opaque const *t) { NOT_YET(); }
-  llvm::Type *get(type::Struct const *t) { NOT_YET(); }
+  llvm::Type *get(type::Struct const *t) {
+    std::vector<llvm::Type *> field_types;
+    field_types.reserve(t->fields().size());
+    for (size_t i : t->layout()) {
+      field_types.push_back(get(t->fields()[i].type));
+    }
+    return llvm::StructType::get(context_, field_types);
+  }
 
  private:
   llvm::LLVMContext &context_;
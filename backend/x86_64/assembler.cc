@@ -0,0 +1,245 @@
+#include "backend/x86_64/assembler.h"
+
+#include "base/debug.h"
+
+namespace backend::x86_64 {
+namespace {
+
+constexpr uint8_t Low(Register r) { return static_cast<uint8_t>(r) & 7; }
+constexpr bool Extended(Register r) { return static_cast<uint8_t>(r) >= 8; }
+
+// Instructions taking a single operand encode an extension of their op code in
+// the `reg` field of the ModR/M byte.
+constexpr Register OpCodeExtension(uint8_t n) {
+  return static_cast<Register>(n);
+}
+
+}  // namespace
+
+void Assembler::Imm32(uint32_t n) {
+  for (int i = 0; i < 4; ++i) { Byte((n >> (8 * i)) & 0xff); }
+}
+
+void Assembler::Rex(bool w, Register reg, Register rm, bool force) {
+  uint8_t rex = 0x40 | (w << 3) | (Extended(reg) << 2) | Extended(rm);
+  if (rex != 0x40 or force) { Byte(rex); }
+}
+
+void Assembler::ModRm(Register reg, Register rm) {
+  Byte(0xc0 | (Low(reg) << 3) | Low(rm));
+}
+
+void Assembler::ModRm(Register reg, Memory m) {
+  // Always use a 32-bit displacement. A base of rsp or r12 requires a SIB byte.
+  Byte(0x80 | (Low(reg) << 3) | Low(m.base));
+  if (Low(m.base) == Low(Register::rsp)) { Byte(0x24); }
+  Imm32(m.displacement);
+}
+
+void Assembler::Move(Register dst, Register src) {
+  Rex(true, src, dst);
+  Byte(0x89);
+  ModRm(src, dst);
+}
+
+void Assembler::Move(Register dst, uint64_t immediate) {
+  Rex(true, Register::rax, dst);
+  Byte(0xb8 + Low(dst));
+  for (int i = 0; i < 8; ++i) { Byte((immediate >> (8 * i)) & 0xff); }
+}
+
+void Assembler::Load(Register dst, Memory src, int bytes, bool sign_extend) {
+  switch (bytes) {
+    case 1:
+      Rex(true, dst, src.base);
+      Byte(0x0f);
+      Byte(sign_extend ? 0xbe : 0xb6);
+      break;
+    case 2:
+      Rex(true, dst, src.base);
+      Byte(0x0f);
+      Byte(sign_extend ? 0xbf : 0xb7);
+      break;
+    case 4:
+      // Writing a 32-bit register implicitly zero-extends it.
+      Rex(sign_extend, dst, src.base);
+      Byte(sign_extend ? 0x63 : 0x8b);
+      break;
+    case 8:
+      Rex(true, dst, src.base);
+      Byte(0x8b);
+      break;
+    default: UNREACHABLE(bytes);
+  }
+  ModRm(dst, src);
+}
+
+void Assembler::Store(Memory dst, Register src, int bytes) {
+  switch (bytes) {
+    case 1:
+      // Without a REX prefix, the byte registers of rsp, rbp, rsi, and rdi
+      // cannot be encoded.
+      Rex(false, src, dst.base, /*force=*/true);
+      Byte(0x88);
+      break;
+    case 2:
+      Byte(0x66);
+      Rex(false, src, dst.base);
+      Byte(0x89);
+      break;
+    case 4:
+      Rex(false, src, dst.base);
+      Byte(0x89);
+      break;
+    case 8:
+      Rex(true, src, dst.base);
+      Byte(0x89);
+      break;
+    default: UNREACHABLE(bytes);
+  }
+  ModRm(src, dst);
+}
+
+void Assembler::LoadAddress(Register dst, Memory src) {
+  Rex(true, dst, src.base);
+  Byte(0x8d);
+  ModRm(dst, src);
+}
+
+void Assembler::Extend(Register r, int bytes, bool sign_extend) {
+  switch (bytes) {
+    case 1:
+    case 2:
+      Rex(true, r, r);
+      Byte(0x0f);
+      Byte((sign_extend ? 0xbe : 0xb6) + (bytes == 2));
+      break;
+    case 4:
+      if (sign_extend) {
+        Rex(true, r, r);
+        Byte(0x63);
+      } else {
+        Rex(false, r, r);
+        Byte(0x89);
+      }
+      break;
+    case 8: return;
+    default: UNREACHABLE(bytes);
+  }
+  ModRm(r, r);
+}
+
+void Assembler::Add(Register dst, Register src) {
+  Rex(true, src, dst);
+  Byte(0x01);
+  ModRm(src, dst);
+}
+
+void Assembler::Subtract(Register dst, Register src) {
+  Rex(true, src, dst);
+  Byte(0x29);
+  ModRm(src, dst);
+}
+
+void Assembler::Multiply(Register dst, Register src) {
+  Rex(true, dst, src);
+  Byte(0x0f);
+  Byte(0xaf);
+  ModRm(dst, src);
+}
+
+void Assembler::Divide(Register divisor, bool is_signed) {
+  if (is_signed) {
+    // cqo
+    Byte(0x48);
+    Byte(0x99);
+  } else {
+    // xor edx, edx
+    Byte(0x31);
+    Byte(0xd2);
+  }
+  Rex(true, Register::rax, divisor);
+  Byte(0xf7);
+  ModRm(OpCodeExtension(is_signed ? 7 : 6), divisor);
+}
+
+void Assembler::Compare(Register lhs, Register rhs) {
+  Rex(true, rhs, lhs);
+  Byte(0x39);
+  ModRm(rhs, lhs);
+}
+
+void Assembler::Test(Register lhs, Register rhs) {
+  Rex(true, rhs, lhs);
+  Byte(0x85);
+  ModRm(rhs, lhs);
+}
+
+void Assembler::Set(Condition c, Register dst) {
+  Rex(false, Register::rax, dst, /*force=*/true);
+  Byte(0x0f);
+  Byte(0x90 + static_cast<uint8_t>(c));
+  ModRm(OpCodeExtension(0), dst);
+  Extend(dst, 1, /*sign_extend=*/false);
+}
+
+void Assembler::CopyBytes() {
+  Byte(0xf3);
+  Byte(0xa4);
+}
+
+void Assembler::FillBytes() {
+  Byte(0xf3);
+  Byte(0xaa);
+}
+
+void Assembler::Push(Register r) {
+  if (Extended(r)) { Byte(0x41); }
+  Byte(0x50 + Low(r));
+}
+
+void Assembler::Pop(Register r) {
+  if (Extended(r)) { Byte(0x41); }
+  Byte(0x58 + Low(r));
+}
+
+void Assembler::Subtract(Register r, int32_t immediate) {
+  Rex(true, Register::rax, r);
+  Byte(0x81);
+  ModRm(OpCodeExtension(5), r);
+  Imm32(immediate);
+}
+
+void Assembler::Return() { Byte(0xc3); }
+
+size_t Assembler::Jump() {
+  Byte(0xe9);
+  size_t offset = size();
+  Imm32(0);
+  return offset;
+}
+
+size_t Assembler::Jump(Condition c) {
+  Byte(0x0f);
+  Byte(0x80 + static_cast<uint8_t>(c));
+  size_t offset = size();
+  Imm32(0);
+  return offset;
+}
+
+size_t Assembler::Call() {
+  Byte(0xe8);
+  size_t offset = size();
+  Imm32(0);
+  return offset;
+}
+
+void Assembler::PatchDisplacement(size_t offset, size_t target) {
+  uint32_t displacement = static_cast<uint32_t>(
+      static_cast<int64_t>(target) - static_cast<int64_t>(offset + 4));
+  for (int i = 0; i < 4; ++i) {
+    code_[offset + i] = (displacement >> (8 * i)) & 0xff;
+  }
+}
+
+}  // namespace backend::x86_64
@@ -0,0 +1,130 @@
+#ifndef ICARUS_BACKEND_X86_64_ASSEMBLER_H
+#define ICARUS_BACKEND_X86_64_ASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
+
+namespace backend::x86_64 {
+
+enum class Register : uint8_t {
+  rax,
+  rcx,
+  rdx,
+  rbx,
+  rsp,
+  rbp,
+  rsi,
+  rdi,
+  r8,
+  r9,
+  r10,
+  r11,
+  r12,
+  r13,
+  r14,
+  r15,
+};
+
+// The condition codes used by `jcc` and `setcc`.
+enum class Condition : uint8_t {
+  Overflow       = 0x0,
+  NoOverflow     = 0x1,
+  Below          = 0x2,
+  AboveOrEqual   = 0x3,
+  Equal          = 0x4,
+  NotEqual       = 0x5,
+  BelowOrEqual   = 0x6,
+  Above          = 0x7,
+  Less           = 0xc,
+  GreaterOrEqual = 0xd,
+  LessOrEqual    = 0xe,
+  Greater        = 0xf,
+};
+
+// A memory operand addressing `base + displacement`.
+struct Memory {
+  Register base;
+  int32_t displacement = 0;
+};
+
+// Assembler:
+//
+// Encodes x86-64 instructions into a growing buffer of machine code. Unless
+// otherwise noted, instructions operate on the full 64-bit registers. Jumps and
+// calls are emitted with 32-bit displacements which are filled in later with
+// `PatchDisplacement`, once the location of their target is known.
+struct Assembler {
+  absl::Span<uint8_t const> code() const { return code_; }
+  size_t size() const { return code_.size(); }
+
+  void Append(absl::Span<uint8_t const> code) {
+    code_.insert(code_.end(), code.begin(), code.end());
+  }
+
+  // mov dst, src
+  void Move(Register dst, Register src);
+  // movabs dst, immediate
+  void Move(Register dst, uint64_t immediate);
+  // Loads `bytes` bytes (1, 2, 4, or 8) from `src` into `dst`, sign- or
+  // zero-extending the value to 64 bits.
+  void Load(Register dst, Memory src, int bytes, bool sign_extend);
+  // Stores the low `bytes` bytes (1, 2, 4, or 8) of `src` to `dst`.
+  void Store(Memory dst, Register src, int bytes);
+  // lea dst, src
+  void LoadAddress(Register dst, Memory src);
+
+  // Sign- or zero-extends the low `bytes` bytes of `r` to fill all of `r`.
+  void Extend(Register r, int bytes, bool sign_extend);
+
+  // dst += src, dst -= src, dst *= src
+  void Add(Register dst, Register src);
+  void Subtract(Register dst, Register src);
+  void Multiply(Register dst, Register src);
+  // Divides rdx:rax by `divisor`, leaving the quotient in rax and the
+  // remainder in rdx. rdx is first set by sign- or zero-extending rax.
+  void Divide(Register divisor, bool is_signed);
+
+  // cmp lhs, rhs
+  void Compare(Register lhs, Register rhs);
+  // test lhs, rhs
+  void Test(Register lhs, Register rhs);
+  // Sets `dst` to 1 if `c` holds and 0 otherwise.
+  void Set(Condition c, Register dst);
+
+  // rep movsb: Copies rcx bytes from [rsi] to [rdi].
+  void CopyBytes();
+  // rep stosb: Sets rcx bytes at [rdi] to al.
+  void FillBytes();
+
+  void Push(Register r);
+  void Pop(Register r);
+  // sub r, immediate
+  void Subtract(Register r, int32_t immediate);
+  void Return();
+
+  // Each of these emits an instruction with a 32-bit displacement relative to
+  // the end of the instruction, and returns the offset of the displacement.
+  size_t Jump();
+  size_t Jump(Condition c);
+  size_t Call();
+
+  // Sets the displacement at `offset` so that it refers to `target`. Both are
+  // offsets into this buffer.
+  void PatchDisplacement(size_t offset, size_t target);
+
+ private:
+  void Byte(uint8_t b) { code_.push_back(b); }
+  void Imm32(uint32_t n);
+  void Rex(bool w, Register reg, Register rm, bool force = false);
+  void ModRm(Register reg, Register rm);
+  void ModRm(Register reg, Memory m);
+
+  std::vector<uint8_t> code_;
+};
+
+}  // namespace backend::x86_64
+
+#endif  // ICARUS_BACKEND_X86_64_ASSEMBLER_H
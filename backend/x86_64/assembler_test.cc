@@ -0,0 +1,100 @@
+#include "backend/x86_64/assembler.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace backend::x86_64 {
+namespace {
+
+using ::testing::ElementsAre;
+
+std::vector<uint8_t> Code(Assembler const &a) {
+  return std::vector<uint8_t>(a.code().begin(), a.code().end());
+}
+
+TEST(Assembler, Move) {
+  Assembler a;
+  a.Move(Register::rbp, Register::rsp);
+  a.Move(Register::rax, Register::r10);
+  EXPECT_THAT(Code(a), ElementsAre(0x48, 0x89, 0xe5, 0x4c, 0x89, 0xd0));
+}
+
+TEST(Assembler, MoveImmediate) {
+  Assembler a;
+  a.Move(Register::r9, uint64_t{0x0102030405060708});
+  EXPECT_THAT(Code(a), ElementsAre(0x49, 0xb9, 0x08, 0x07, 0x06, 0x05, 0x04,
+                                   0x03, 0x02, 0x01));
+}
+
+TEST(Assembler, Load) {
+  Assembler a;
+  a.Load(Register::r10, {.base = Register::rbp, .displacement = -8}, 8,
+         /*sign_extend=*/true);
+  EXPECT_THAT(Code(a), ElementsAre(0x4c, 0x8b, 0x95, 0xf8, 0xff, 0xff, 0xff));
+}
+
+TEST(Assembler, LoadNarrow) {
+  Assembler a;
+  a.Load(Register::rax, {.base = Register::rcx}, 1, /*sign_extend=*/true);
+  a.Load(Register::rax, {.base = Register::rcx}, 2, /*sign_extend=*/false);
+  a.Load(Register::rax, {.base = Register::rcx}, 4, /*sign_extend=*/false);
+  EXPECT_THAT(Code(a),
+              ElementsAre(0x48, 0x0f, 0xbe, 0x81, 0, 0, 0, 0,  //
+                          0x48, 0x0f, 0xb7, 0x81, 0, 0, 0, 0,  //
+                          0x8b, 0x81, 0, 0, 0, 0));
+}
+
+TEST(Assembler, StoreRequiresSib) {
+  Assembler a;
+  a.Store({.base = Register::rsp}, Register::rsi, 1);
+  a.Store({.base = Register::r12, .displacement = 16}, Register::rax, 8);
+  EXPECT_THAT(Code(a), ElementsAre(0x40, 0x88, 0xb4, 0x24, 0, 0, 0, 0,  //
+                                   0x49, 0x89, 0x84, 0x24, 0x10, 0, 0, 0));
+}
+
+TEST(Assembler, Arithmetic) {
+  Assembler a;
+  a.Add(Register::r12, Register::rax);
+  a.Subtract(Register::r10, Register::rax);
+  a.Multiply(Register::r10, Register::r11);
+  EXPECT_THAT(Code(a), ElementsAre(0x49, 0x01, 0xc4,  //
+                                   0x49, 0x29, 0xc2,  //
+                                   0x4d, 0x0f, 0xaf, 0xd3));
+}
+
+TEST(Assembler, Divide) {
+  Assembler a;
+  a.Divide(Register::rcx, /*is_signed=*/true);
+  a.Divide(Register::rcx, /*is_signed=*/false);
+  EXPECT_THAT(Code(a), ElementsAre(0x48, 0x99, 0x48, 0xf7, 0xf9,  //
+                                   0x31, 0xd2, 0x48, 0xf7, 0xf1));
+}
+
+TEST(Assembler, Set) {
+  Assembler a;
+  a.Set(Condition::Less, Register::r9);
+  EXPECT_THAT(Code(a),
+              ElementsAre(0x41, 0x0f, 0x9c, 0xc1, 0x4d, 0x0f, 0xb6, 0xc9));
+}
+
+TEST(Assembler, BulkMemory) {
+  Assembler a;
+  a.CopyBytes();
+  a.FillBytes();
+  EXPECT_THAT(Code(a), ElementsAre(0xf3, 0xa4, 0xf3, 0xaa));
+}
+
+TEST(Assembler, Jumps) {
+  Assembler a;
+  size_t forward = a.Jump(Condition::NotEqual);
+  size_t call    = a.Call();
+  a.PatchDisplacement(forward, a.size());
+  a.PatchDisplacement(call, 0);
+  EXPECT_THAT(Code(a), ElementsAre(0x0f, 0x85, 0x05, 0x00, 0x00, 0x00,  //
+                                   0xe8, 0xf5, 0xff, 0xff, 0xff));
+}
+
+}  // namespace
+}  // namespace backend::x86_64
@@ -0,0 +1,154 @@
+#include "backend/x86_64/object_file.h"
+
+#include <elf.h>
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace backend::x86_64 {
+namespace {
+
+enum Section : uint16_t {
+  kNullSection,
+  kTextSection,
+  kSymbolTableSection,
+  kStringTableSection,
+  kSectionNameTableSection,
+  // An empty section whose presence marks the stack as non-executable.
+  kStackNoteSection,
+  kNumSections,
+};
+
+// A table of null-terminated strings, as used for symbol and section names.
+struct StringTable {
+  StringTable() : data_(1, '\0') {}
+
+  uint32_t Add(std::string_view s) {
+    uint32_t offset = data_.size();
+    data_.append(s);
+    data_.push_back('\0');
+    return offset;
+  }
+
+  std::string const &data() const { return data_; }
+
+ private:
+  std::string data_;
+};
+
+template <typename T>
+void Append(std::string &out, T const &value) {
+  out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+size_t Align(std::string &out, size_t alignment) {
+  out.resize((out.size() + alignment - 1) / alignment * alignment, '\0');
+  return out.size();
+}
+
+}  // namespace
+
+std::string RelocatableObjectFile(absl::Span<uint8_t const> text,
+                                  absl::Span<FunctionSymbol const> symbols) {
+  StringTable section_names;
+  uint32_t text_name          = section_names.Add(".text");
+  uint32_t symbol_table_name  = section_names.Add(".symtab");
+  uint32_t string_table_name  = section_names.Add(".strtab");
+  uint32_t section_names_name = section_names.Add(".shstrtab");
+  uint32_t stack_note_name    = section_names.Add(".note.GNU-stack");
+
+  // Local symbols must precede global symbols in the symbol table.
+  StringTable symbol_names;
+  std::vector<Elf64_Sym> symbol_table(1, Elf64_Sym{});
+  for (bool global : {false, true}) {
+    for (auto const &symbol : symbols) {
+      if (symbol.global != global) { continue; }
+      Elf64_Sym &sym = symbol_table.emplace_back();
+      sym.st_name    = symbol_names.Add(symbol.name);
+      sym.st_info    = ELF64_ST_INFO(global ? STB_GLOBAL : STB_LOCAL, STT_FUNC);
+      sym.st_other   = STV_DEFAULT;
+      sym.st_shndx   = kTextSection;
+      sym.st_value   = symbol.offset;
+      sym.st_size    = symbol.size;
+    }
+  }
+  uint32_t first_global = symbol_table.size();
+  for (auto const &symbol : symbols) { first_global -= symbol.global; }
+
+  std::string out(sizeof(Elf64_Ehdr), '\0');
+
+  size_t text_offset = Align(out, 16);
+  out.append(reinterpret_cast<char const *>(text.data()), text.size());
+
+  size_t symbol_table_offset = Align(out, alignof(Elf64_Sym));
+  for (auto const &sym : symbol_table) { Append(out, sym); }
+
+  size_t string_table_offset = out.size();
+  out.append(symbol_names.data());
+
+  size_t section_names_offset = out.size();
+  out.append(section_names.data());
+
+  size_t section_headers_offset = Align(out, alignof(Elf64_Shdr));
+  Elf64_Shdr headers[kNumSections] = {};
+  headers[kTextSection] = {
+      .sh_name      = text_name,
+      .sh_type      = SHT_PROGBITS,
+      .sh_flags     = SHF_ALLOC | SHF_EXECINSTR,
+      .sh_offset    = text_offset,
+      .sh_size      = text.size(),
+      .sh_addralign = 16,
+  };
+  headers[kSymbolTableSection] = {
+      .sh_name      = symbol_table_name,
+      .sh_type      = SHT_SYMTAB,
+      .sh_offset    = symbol_table_offset,
+      .sh_size      = symbol_table.size() * sizeof(Elf64_Sym),
+      .sh_link      = kStringTableSection,
+      .sh_info      = first_global,
+      .sh_addralign = alignof(Elf64_Sym),
+      .sh_entsize   = sizeof(Elf64_Sym),
+  };
+  headers[kStringTableSection] = {
+      .sh_name      = string_table_name,
+      .sh_type      = SHT_STRTAB,
+      .sh_offset    = string_table_offset,
+      .sh_size      = symbol_names.data().size(),
+      .sh_addralign = 1,
+  };
+  headers[kSectionNameTableSection] = {
+      .sh_name      = section_names_name,
+      .sh_type      = SHT_STRTAB,
+      .sh_offset    = section_names_offset,
+      .sh_size      = section_names.data().size(),
+      .sh_addralign = 1,
+  };
+  headers[kStackNoteSection] = {
+      .sh_name      = stack_note_name,
+      .sh_type      = SHT_PROGBITS,
+      .sh_offset    = section_headers_offset,
+      .sh_addralign = 1,
+  };
+  for (auto const &header : headers) { Append(out, header); }
+
+  Elf64_Ehdr elf_header = {};
+  std::memcpy(elf_header.e_ident, ELFMAG, SELFMAG);
+  elf_header.e_ident[EI_CLASS]   = ELFCLASS64;
+  elf_header.e_ident[EI_DATA]    = ELFDATA2LSB;
+  elf_header.e_ident[EI_VERSION] = EV_CURRENT;
+  elf_header.e_ident[EI_OSABI]   = ELFOSABI_SYSV;
+  elf_header.e_type              = ET_REL;
+  elf_header.e_machine           = EM_X86_64;
+  elf_header.e_version           = EV_CURRENT;
+  elf_header.e_shoff             = section_headers_offset;
+  elf_header.e_ehsize            = sizeof(Elf64_Ehdr);
+  elf_header.e_shentsize         = sizeof(Elf64_Shdr);
+  elf_header.e_shnum             = kNumSections;
+  elf_header.e_shstrndx          = kSectionNameTableSection;
+  std::memcpy(out.data(), &elf_header, sizeof(elf_header));
+
+  return out;
+}
+
+}  // namespace backend::x86_64
@@ -0,0 +1,29 @@
+#ifndef ICARUS_BACKEND_X86_64_OBJECT_FILE_H
+#define ICARUS_BACKEND_X86_64_OBJECT_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/types/span.h"
+
+namespace backend::x86_64 {
+
+// A function defined in the text section of an object file.
+struct FunctionSymbol {
+  std::string name;
+  size_t offset;
+  size_t size;
+  // Whether the symbol is visible to other object files.
+  bool global;
+};
+
+// Returns the contents of a relocatable x86-64 ELF object file whose only
+// section holding data is a text section containing `text`. Calls between the
+// functions in `text` must already be resolved, as no relocations are emitted.
+std::string RelocatableObjectFile(absl::Span<uint8_t const> text,
+                                  absl::Span<FunctionSymbol const> symbols);
+
+}  // namespace backend::x86_64
+
+#endif  // ICARUS_BACKEND_X86_64_OBJECT_FILE_H
@@ -0,0 +1,70 @@
+#include "backend/x86_64/object_file.h"
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace backend::x86_64 {
+namespace {
+
+TEST(RelocatableObjectFile, Header) {
+  uint8_t const text[] = {0xc3};
+  std::string object   = RelocatableObjectFile(text, {});
+  ASSERT_GE(object.size(), sizeof(Elf64_Ehdr));
+
+  Elf64_Ehdr header;
+  std::memcpy(&header, object.data(), sizeof(header));
+  EXPECT_EQ(std::memcmp(header.e_ident, ELFMAG, SELFMAG), 0);
+  EXPECT_EQ(header.e_ident[EI_CLASS], ELFCLASS64);
+  EXPECT_EQ(header.e_type, ET_REL);
+  EXPECT_EQ(header.e_machine, EM_X86_64);
+  EXPECT_EQ(header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr),
+            object.size());
+}
+
+TEST(RelocatableObjectFile, Symbols) {
+  uint8_t const text[] = {0xc3, 0xc3};
+  FunctionSymbol const symbols[] = {
+      {.name = "main", .offset = 1, .size = 1, .global = true},
+      {.name = "f", .offset = 0, .size = 1, .global = false},
+  };
+  std::string object = RelocatableObjectFile(text, symbols);
+
+  Elf64_Ehdr header;
+  std::memcpy(&header, object.data(), sizeof(header));
+  std::vector<Elf64_Shdr> sections(header.e_shnum);
+  std::memcpy(sections.data(), object.data() + header.e_shoff,
+              header.e_shnum * sizeof(Elf64_Shdr));
+
+  auto symbol_table = std::find_if(
+      sections.begin(), sections.end(),
+      [](Elf64_Shdr const &s) { return s.sh_type == SHT_SYMTAB; });
+  ASSERT_NE(symbol_table, sections.end());
+  ASSERT_EQ(symbol_table->sh_size, 3 * sizeof(Elf64_Sym));
+  // Local symbols precede global ones.
+  EXPECT_EQ(symbol_table->sh_info, 2);
+
+  Elf64_Sym syms[3];
+  std::memcpy(syms, object.data() + symbol_table->sh_offset, sizeof(syms));
+  char const *names =
+      object.data() + sections[symbol_table->sh_link].sh_offset;
+  EXPECT_STREQ(names + syms[1].st_name, "f");
+  EXPECT_EQ(ELF64_ST_BIND(syms[1].st_info), STB_LOCAL);
+  EXPECT_EQ(syms[1].st_value, 0);
+  EXPECT_STREQ(names + syms[2].st_name, "main");
+  EXPECT_EQ(ELF64_ST_BIND(syms[2].st_info), STB_GLOBAL);
+  EXPECT_EQ(syms[2].st_value, 1);
+
+  Elf64_Shdr const &text_section = sections[syms[2].st_shndx];
+  EXPECT_EQ(text_section.sh_type, SHT_PROGBITS);
+  EXPECT_EQ(text_section.sh_size, 2);
+  EXPECT_EQ(std::memcmp(object.data() + text_section.sh_offset, text, 2), 0);
+}
+
+}  // namespace
+}  // namespace backend::x86_64
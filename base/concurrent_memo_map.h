@@ -0,0 +1,53 @@
+#ifndef ICARUS_BASE_CONCURRENT_MEMO_MAP_H
+#define ICARUS_BASE_CONCURRENT_MEMO_MAP_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/synchronization/mutex.h"
+
+namespace base {
+
+// A memo table which may be shared between threads: a map from keys to values
+// which are computed the first time they are requested and never change
+// afterwards. Keys are spread over independently locked shards so that threads
+// querying unrelated keys do not contend, and a value which has already been
+// computed is found under a reader lock.
+template <typename K, typename V, size_t kNumShards = 16>
+struct concurrent_memo_map {
+  static_assert(kNumShards > 0);
+
+  // Returns the value memoized for `key`, computing it with `f` if there is
+  // none. No lock is held while `f` runs, so `f` may itself query this map. If
+  // several threads compute a value for the same key, the first one stored is
+  // returned to all of them.
+  V get(K const &key, std::invocable auto &&f) {
+    shard &s = shards_[absl::Hash<K>{}(key) % kNumShards];
+    {
+      absl::ReaderMutexLock lock(&s.mutex);
+      if (auto iter = s.values.find(key); iter != s.values.end()) {
+        return iter->second;
+      }
+    }
+    V value = f();
+    absl::MutexLock lock(&s.mutex);
+    return s.values.try_emplace(key, std::move(value)).first->second;
+  }
+
+ private:
+  // Each shard is given its own cache line so that locking one does not
+  // invalidate the line holding its neighbor's mutex.
+  struct alignas(64) shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<K, V> values ABSL_GUARDED_BY(mutex);
+  };
+  std::array<shard, kNumShards> shards_;
+};
+
+}  // namespace base
+
+#endif  // ICARUS_BASE_CONCURRENT_MEMO_MAP_H
@@ -0,0 +1,57 @@
+#include "base/concurrent_memo_map.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(ConcurrentMemoMap, ComputesOnce) {
+  base::concurrent_memo_map<std::string, int> m;
+  int calls = 0;
+  EXPECT_EQ(m.get("a", [&] { return ++calls; }), 1);
+  EXPECT_EQ(m.get("a", [&] { return ++calls; }), 1);
+  EXPECT_EQ(m.get("b", [&] { return ++calls; }), 2);
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(ConcurrentMemoMap, RecursiveQueries) {
+  base::concurrent_memo_map<int, int> m;
+  auto fib = [&](auto &fib, int n) -> int {
+    return m.get(n, [&] {
+      return n < 2 ? n : fib(fib, n - 1) + fib(fib, n - 2);
+    });
+  };
+  EXPECT_EQ(fib(fib, 40), 102334155);
+}
+
+TEST(ConcurrentMemoMap, Threads) {
+  base::concurrent_memo_map<int, int, 4> m;
+  std::atomic<int> calls = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(m.get(i,
+                        [&] {
+                          ++calls;
+                          return i * i;
+                        }),
+                  i * i);
+      }
+    });
+  }
+  for (auto &t : threads) { t.join(); }
+
+  // Threads racing on the same key may each compute it, but every key is
+  // computed at least once and then answered from the map.
+  EXPECT_GE(calls.load(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(m.get(i, [] { return -1; }), i * i);
+  }
+}
+
+}  // namespace
@@ -1,10 +1,19 @@
 #ifndef ICARUS_BASE_FLYWEIGHT_MAP_H
 #define ICARUS_BASE_FLYWEIGHT_MAP_H
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "base/debug.h"
 
 namespace base {
@@ -33,6 +42,77 @@ struct flyweight_map {
   std::vector<Data const *> data_;
 };
 
+// A `flyweight_map` which may be shared between threads. Inserting data takes a
+// lock, but looking data up by id does not: data is stored in segments of
+// geometrically increasing size which are never moved or freed while the map is
+// alive. An id may be looked up on any thread synchronized with the one which
+// obtained it.
+template <typename Data>
+struct concurrent_flyweight_map {
+  static_assert(not std::is_same_v<Data, size_t>);
+
+  concurrent_flyweight_map() = default;
+  concurrent_flyweight_map(concurrent_flyweight_map const &) = delete;
+  concurrent_flyweight_map &operator=(concurrent_flyweight_map const &) =
+      delete;
+
+  ~concurrent_flyweight_map() {
+    for (size_t id = 0; id < size_; ++id) {
+      auto [segment, offset] = Locate(id);
+      segments_[segment].load(std::memory_order_relaxed)[offset].~Data();
+    }
+    for (size_t segment = 0; segment < kNumSegments; ++segment) {
+      if (Data *s = segments_[segment].load(std::memory_order_relaxed)) {
+        std::allocator<Data>().deallocate(s, SegmentSize(segment));
+      }
+    }
+  }
+
+  size_t get(Data const &data) {
+    absl::MutexLock lock(&mutex_);
+    auto [iter, inserted] = ids_.try_emplace(data, size_);
+    if (inserted) {
+      auto [segment, offset] = Locate(size_);
+      Data *s = segments_[segment].load(std::memory_order_relaxed);
+      if (not s) {
+        s = std::allocator<Data>().allocate(SegmentSize(segment));
+        segments_[segment].store(s, std::memory_order_release);
+      }
+      new (s + offset) Data(data);
+      ++size_;
+    }
+    return iter->second;
+  }
+
+  Data const &get(size_t id) const {
+    auto [segment, offset] = Locate(id);
+    Data const *s = segments_[segment].load(std::memory_order_acquire);
+    ASSERT(s != nullptr);
+    return s[offset];
+  }
+
+ private:
+  static constexpr size_t kFirstSegmentBits = 4;
+  static constexpr size_t kNumSegments =
+      std::numeric_limits<size_t>::digits - kFirstSegmentBits;
+
+  static constexpr size_t SegmentSize(size_t segment) {
+    return size_t{1} << (segment + kFirstSegmentBits);
+  }
+
+  // Returns the segment holding `id` and the offset of `id` within it.
+  static constexpr std::pair<size_t, size_t> Locate(size_t id) {
+    size_t position = id + SegmentSize(0);
+    size_t segment  = std::bit_width(position) - kFirstSegmentBits - 1;
+    return {segment, position - SegmentSize(segment)};
+  }
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Data, size_t> ids_;
+  size_t size_ = 0;
+  std::array<std::atomic<Data *>, kNumSegments> segments_ = {};
+};
+
 }  // namespace base
 
 #endif  // ICARUS_BASE_FLYWEIGHT_MAP_H
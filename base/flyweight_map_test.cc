@@ -0,0 +1,58 @@
+#include "base/flyweight_map.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(FlyweightMap, Ids) {
+  base::flyweight_map<std::string> m;
+  size_t hello = m.get("hello");
+  size_t world = m.get("world");
+  EXPECT_NE(hello, world);
+  EXPECT_EQ(m.get("hello"), hello);
+  EXPECT_EQ(m.get(hello), "hello");
+  EXPECT_EQ(m.get(world), "world");
+}
+
+TEST(ConcurrentFlyweightMap, Ids) {
+  base::concurrent_flyweight_map<std::string> m;
+  size_t hello = m.get("hello");
+  size_t world = m.get("world");
+  EXPECT_NE(hello, world);
+  EXPECT_EQ(m.get("hello"), hello);
+  EXPECT_EQ(m.get(hello), "hello");
+  EXPECT_EQ(m.get(world), "world");
+}
+
+// `std::string` rather than an integral type is used as data so that `get`
+// taking data is never ambiguous with `get` taking an id.
+TEST(ConcurrentFlyweightMap, ReferencesAreStable) {
+  base::concurrent_flyweight_map<std::string> m;
+  std::string const *first = &m.get(m.get("0"));
+  for (int i = 1; i < 1000; ++i) { m.get(std::to_string(i)); }
+  EXPECT_EQ(first, &m.get(m.get("0")));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(m.get(m.get(std::to_string(i))), std::to_string(i));
+  }
+}
+
+TEST(ConcurrentFlyweightMap, Threads) {
+  base::concurrent_flyweight_map<std::string> m;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(m.get(m.get(std::to_string(i))), std::to_string(i));
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  EXPECT_EQ(m.get("999"), m.get("999"));
+}
+
+}  // namespace
@@ -15,23 +15,28 @@
 
 namespace compiler {
 
-WorkItem::Result WorkItem::Process() const {
+WorkItem::Result WorkItem::Process(type::LegacyType const **awaited) const {
   Compiler c(resources);
-  switch (kind) {
-    case Kind::VerifyEnumBody:
-      return c.VerifyBody(&node->as<ast::EnumLiteral>());
-    case Kind::VerifyFunctionBody:
-      return c.VerifyBody(&node->as<ast::FunctionLiteral>());
-    case Kind::VerifyStructBody:
-      return c.VerifyBody(&node->as<ast::StructLiteral>());
-    case Kind::CompleteStructMembers:
-      return c.CompleteStruct(&node->as<ast::StructLiteral>());
-    case Kind::EmitJumpBody: return c.EmitJumpBody(&node->as<ast::Jump>());
-    case Kind::EmitFunctionBody:
-      return c.EmitFunctionBody(&node->as<ast::FunctionLiteral>());
-    case Kind::EmitShortFunctionBody:
-      return c.EmitShortFunctionBody(&node->as<ast::ShortFunctionLiteral>());
-  }
+  Result result = [&] {
+    switch (kind) {
+      case Kind::VerifyEnumBody:
+        return c.VerifyBody(&node->as<ast::EnumLiteral>());
+      case Kind::VerifyFunctionBody:
+        return c.VerifyBody(&node->as<ast::FunctionLiteral>());
+      case Kind::VerifyStructBody:
+        return c.VerifyBody(&node->as<ast::StructLiteral>());
+      case Kind::CompleteStructMembers:
+        return c.CompleteStruct(&node->as<ast::StructLiteral>());
+      case Kind::EmitJumpBody: return c.EmitJumpBody(&node->as<ast::Jump>());
+      case Kind::EmitFunctionBody:
+        return c.EmitFunctionBody(&node->as<ast::FunctionLiteral>());
+      case Kind::EmitShortFunctionBody:
+        return c.EmitShortFunctionBody(&node->as<ast::ShortFunctionLiteral>());
+    }
+    UNREACHABLE();
+  }();
+  *awaited = (result == Result::Deferred) ? c.state_.awaited : nullptr;
+  return result;
 }
 
 Compiler::Compiler(PersistentResources const &resources)
@@ -39,8 +44,8 @@ Compiler::Compiler(PersistentResources const &resources)
 
 void Compiler::CompleteDeferredBodies() { state_.Complete(); }
 
-static std::pair<ir::CompiledFn, base::untyped_buffer> MakeThunk(
-    Compiler &c, ast::Expression const *expr, type::Type type) {
+static ir::CompiledFn &MakeThunk(Compiler &c, ast::Expression const *expr,
+                                 type::Type type) {
   LOG("MakeThunk", "Thunk for %s: %s", expr->DebugString(), type.to_string());
   ir::CompiledFn fn(type::Func({}, {type}),
                     core::Params<type::Typed<ast::Declaration const *>>{});
@@ -80,19 +85,17 @@ static std::pair<ir::CompiledFn, base::untyped_buffer> MakeThunk(
     c.builder().ReturnJump();
   }
 
-  return std::pair<ir::CompiledFn, base::untyped_buffer>(std::move(fn),
-                                                         EmitByteCode(fn));
+  return c.context().FinalizeThunk(std::move(fn));
 }
 
 interpreter::EvaluationResult Compiler::Evaluate(
     type::Typed<ast::Expression const *> expr, bool must_complete) {
-  Compiler c             = MakeChild(resources_);
-  c.state_.must_complete  = must_complete;
-  auto [thunk, byte_code] = MakeThunk(c, *expr, expr.type());
+  Compiler c            = MakeChild(resources_);
+  c.state_.must_complete = must_complete;
+  ir::CompiledFn &thunk  = MakeThunk(c, *expr, expr.type());
   ir::NativeFn::Data data{
-      .fn        = &thunk,
-      .type      = thunk.type(),
-      .byte_code = byte_code.begin(),
+      .fn   = &thunk,
+      .type = thunk.type(),
   };
   c.CompleteWorkQueue();
   c.CompleteDeferredBodies();
@@ -102,12 +105,11 @@ interpreter::EvaluationResult Compiler::Evaluate(
 base::untyped_buffer Compiler::EvaluateToBufferOrDiagnose(
     type::Typed<ast::Expression const *> expr) {
   // TODO: The diagnosis part.
-  Compiler c = MakeChild(resources_);
-  auto [thunk, byte_code] = MakeThunk(c, *expr, expr.type());
+  Compiler c           = MakeChild(resources_);
+  ir::CompiledFn &thunk = MakeThunk(c, *expr, expr.type());
   ir::NativeFn::Data data{
-      .fn        = &thunk,
-      .type      = thunk.type(),
-      .byte_code = byte_code.begin(),
+      .fn   = &thunk,
+      .type = thunk.type(),
   };
   c.CompleteWorkQueue();
   c.CompleteDeferredBodies();
@@ -133,6 +135,10 @@ Context::InsertSubcontextResult Compiler::Instantiate(
                   .context(&context().module());
   LOG("Instantiate", "Instantiating %s: %s", node->DebugString(),
       ctx.DebugString());
+  if (auto const *cached = ctx.CachedInstantiation(node, args)) {
+    return *cached;
+  }
+
   Context scratchpad = ctx.ScratchpadSubcontext();
   Compiler c({
       .data                = scratchpad,
@@ -140,8 +146,10 @@ Context::InsertSubcontextResult Compiler::Instantiate(
       .importer            = importer(),
   });
 
-  return ctx.InsertSubcontext(node, c.ComputeParamsFromArgs(node, args),
-                              std::move(scratchpad));
+  auto result = ctx.InsertSubcontext(node, c.ComputeParamsFromArgs(node, args),
+                                     std::move(scratchpad));
+  ctx.CacheInstantiation(node, args, result);
+  return result;
 }
 
 Context::FindSubcontextResult Compiler::FindInstantiation(
@@ -154,6 +162,15 @@ Context::FindSubcontextResult Compiler::FindInstantiation(
                   .context(&context().module());
   LOG("FindInstantiation", "Finding %s: %s", node->DebugString(),
       ctx.DebugString());
+  if (auto const *cached = ctx.CachedInstantiation(node, args)) {
+    return Context::FindSubcontextResult{
+        .fn_type = type::Func(
+            cached->params.Transform([](auto const &p) { return p.second; }),
+            cached->rets),
+        .context = cached->context,
+    };
+  }
+
   Context scratchpad = ctx.ScratchpadSubcontext();
   Compiler c({
       .data                = scratchpad,
@@ -572,20 +572,53 @@ struct Compiler
   CyclicDependencyTracker cylcic_dependency_tracker_;
 };
 
+inline void WorkQueue::Wake(bool all) {
+  for (auto iter = waiting_.begin(); iter != waiting_.end();) {
+    auto const *awaited = iter->first;
+    bool ready =
+        all or (awaited != nullptr and
+                awaited->completeness() != type::Completeness::Incomplete);
+    if (not ready) {
+      ++iter;
+      continue;
+    }
+    for (auto &item : iter->second) {
+      Count(&Stats::rewoken);
+      items_.push(std::move(item));
+    }
+    waiting_.erase(iter++);
+  }
+}
+
 inline void WorkQueue::ProcessOneItem() {
+  if (items_.empty()) {
+#if defined(ICARUS_DEBUG)
+    // Nothing has completed since the waiting items were last all woken, so
+    // they would all be deferred again.
+    ASSERT(progressed_ == true);
+    progressed_ = false;
+#endif
+    Wake(/*all=*/true);
+  }
+
   ASSERT(items_.empty() == false);
   WorkItem item = std::move(items_.front());
   items_.pop();
-  WorkItem::Result result = item.Process();
-  bool deferred           = (result == WorkItem::Result::Deferred);
-  if (deferred) { items_.push(std::move(item)); }
-#if defined(ICARUS_DEBUG)
-  if (deferred) {
+  Count(&Stats::processed);
+
+  type::LegacyType const *awaited = nullptr;
+  WorkItem::Result result         = item.Process(&awaited);
+  if (result == WorkItem::Result::Deferred) {
     LOG("", "Deferring %s", item.node->DebugString());
-    cycle_breaker_count_ = deferred ? cycle_breaker_count_ + 1 : 0;
+    Count(&Stats::deferred);
+    waiting_[awaited].push_back(std::move(item));
+    return;
   }
-  ASSERT(cycle_breaker_count_ <= items_.size());
+
+#if defined(ICARUS_DEBUG)
+  progressed_ = true;
 #endif
+  if (not waiting_.empty()) { Wake(/*all=*/false); }
 }
 
 }  // namespace compiler
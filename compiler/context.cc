@@ -1,7 +1,77 @@
 #include "compiler/context.h"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/notification.h"
+#include "base/global.h"
+#include "type/array.h"
+#include "type/enum.h"
+#include "type/flags.h"
+#include "type/primitive.h"
+#include "type/provenance.h"
+#include "type/struct.h"
 
 namespace compiler {
+namespace {
+
+// Returns whether values of type `t` hold no addresses, so that their bytes
+// mean the same thing outside of the compiler.
+bool IsPlainData(type::Type t) {
+  if (type::IsNumeric(t) or t == type::Bool or t == type::Char) { return true; }
+  if (t.is<type::Enum>() or t.is<type::Flags>()) { return true; }
+  if (auto const *a = t.if_as<type::Array>()) {
+    return IsPlainData(a->data_type());
+  }
+  if (auto const *s = t.if_as<type::Struct>()) {
+    return std::all_of(
+        s->fields().begin(), s->fields().end(),
+        [](type::Struct::Field const &f) { return IsPlainData(f.type); });
+  }
+  return false;
+}
+
+// A special member function shared by all modules in a build. `written` is
+// notified once the function's byte code has been written, or once the
+// function has been abandoned by whoever inserted it.
+struct SharedSpecialMember {
+  std::tuple<int, type::Type, type::Type> key;
+  std::unique_ptr<ir::CompiledFn> fn;
+  std::unique_ptr<ir::NativeFn::Data> data;
+  absl::Notification written;
+  bool abandoned = false;
+};
+
+struct SharedSpecialMembers {
+  absl::flat_hash_map<std::tuple<int, type::Type, type::Type>,
+                      std::shared_ptr<SharedSpecialMember>>
+      members;
+  absl::flat_hash_map<ir::CompiledFn const *,
+                      std::shared_ptr<SharedSpecialMember>>
+      by_fn;
+  // Abandoned functions may already be referenced from emitted IR, so they are
+  // kept alive even though they can no longer be found.
+  std::vector<std::shared_ptr<SharedSpecialMember>> abandoned;
+};
+
+base::Global<SharedSpecialMembers> shared_special_members;
+
+// Removes the unwritten shared special member `fn` so that the next attempt to
+// insert it starts afresh, and wakes everyone waiting on it.
+void AbandonSharedSpecialMember(ir::CompiledFn const *fn) {
+  auto handle = shared_special_members.lock();
+  auto iter   = handle->by_fn.find(fn);
+  if (iter == handle->by_fn.end()) { return; }
+  auto &member = handle->abandoned.emplace_back(std::move(iter->second));
+  handle->by_fn.erase(iter);
+  handle->members.erase(member->key);
+  member->abandoned = true;
+  member->written.Notify();
+}
+
+}  // namespace
 
 struct Context::Subcontext {
   explicit Subcontext(Context &&context) : context(std::move(context)) {}
@@ -9,14 +79,26 @@ struct Context::Subcontext {
   Context context;
 };
 
-Context::Context(CompiledModule *mod) : mod_(*ASSERT_NOT_NULL(mod)) {}
+Context::Context(CompiledModule *mod) : Context(mod, nullptr) {}
 Context::Context(Context &&) = default;
-Context::~Context()          = default;
 
-Context::Context(CompiledModule *mod, Context *parent) : Context(mod) {
-  tree_.parent = parent;
+Context::~Context() {
+  for (auto const *fn : unwritten_shared_fns_) {
+    AbandonSharedSpecialMember(fn);
+  }
 }
 
+Context::Context(CompiledModule *mod, Context *parent)
+    : mod_(*ASSERT_NOT_NULL(mod)),
+      tree_{.parent = parent},
+      qual_types_(/*dense=*/parent == nullptr),
+      decls_(/*dense=*/parent == nullptr),
+      constants_(/*dense=*/parent == nullptr),
+      imported_modules_(/*dense=*/parent == nullptr),
+      all_overloads_(/*dense=*/parent == nullptr),
+      viable_overloads_(/*dense=*/parent == nullptr),
+      adl_modules_(/*dense=*/parent == nullptr) {}
+
 Context Context::ScratchpadSubcontext() { return Context(&mod_, this); }
 
 std::string Context::DebugString() const {
@@ -60,6 +142,59 @@ Context::InsertSubcontextResult Context::InsertSubcontext(
   };
 }
 
+namespace {
+
+// Only arguments bound to constant parameters affect an instantiation's
+// parameters by value. Any other argument's value would differ at every call
+// site, so only its type is kept in cache keys.
+core::Arguments<type::Typed<ir::Value>> InstantiationKey(
+    ast::ParameterizedExpression const *node,
+    core::Arguments<type::Typed<ir::Value>> const &args) {
+  auto const &params = node->params();
+  auto key = [&](size_t const *index, type::Typed<ir::Value> const &arg) {
+    if (index and *index < params.size() and
+        (params[*index].value->flags() & ast::Declaration::f_IsConst)) {
+      return arg;
+    }
+    return type::Typed<ir::Value>(ir::Value(), arg.type());
+  };
+
+  std::vector<type::Typed<ir::Value>> pos;
+  pos.reserve(args.pos().size());
+  for (size_t i = 0; i < args.pos().size(); ++i) {
+    pos.push_back(key(&i, args[i]));
+  }
+  absl::flat_hash_map<std::string, type::Typed<ir::Value>> named;
+  for (auto const &[name, arg] : args.named()) {
+    named.emplace(name, key(params.at_or_null(name), arg));
+  }
+  return core::Arguments<type::Typed<ir::Value>>(std::move(pos),
+                                                 std::move(named));
+}
+
+}  // namespace
+
+Context::InsertSubcontextResult const *Context::CachedInstantiation(
+    ast::ParameterizedExpression const *node,
+    core::Arguments<type::Typed<ir::Value>> const &args) const {
+  auto iter =
+      instantiations_.find(std::pair(node, InstantiationKey(node, args)));
+  return iter == instantiations_.end() ? nullptr : &iter->second;
+}
+
+void Context::CacheInstantiation(
+    ast::ParameterizedExpression const *node,
+    core::Arguments<type::Typed<ir::Value>> const &args,
+    InsertSubcontextResult const &result) {
+  instantiations_.try_emplace(std::pair(node, InstantiationKey(node, args)),
+                              InsertSubcontextResult{
+                                  .params   = result.params,
+                                  .rets     = result.rets,
+                                  .context  = result.context,
+                                  .inserted = false,
+                              });
+}
+
 Context::FindSubcontextResult Context::FindSubcontext(
     ast::ParameterizedExpression const *node,
     core::Params<std::pair<ir::Value, type::QualType>> const &params) {
@@ -85,36 +220,32 @@ ir::CompiledJump *Context::jump(ast::Jump const *expr) {
 
 absl::Span<type::QualType const> Context::qual_types(
     ast::Expression const *expr) const {
-  auto iter = qual_types_.find(expr);
-  if (iter != qual_types_.end()) { return iter->second; }
+  if (auto const *qts = qual_types_.find(expr)) { return *qts; }
   if (auto const *p = parent()) { return p->qual_types(expr); }
   UNREACHABLE(expr->DebugString());
 }
 
 absl::Span<type::QualType const> Context::maybe_qual_type(
     ast::Expression const *expr) const {
-  auto iter = qual_types_.find(expr);
-  if (iter != qual_types_.end()) { return iter->second; }
+  if (auto const *qts = qual_types_.find(expr)) { return *qts; }
   if (parent()) { return parent()->maybe_qual_type(expr); }
   return absl::Span<type::QualType const>();
 }
 
 absl::Span<type::QualType const> Context::set_qual_types(
     ast::Expression const *expr, absl::Span<type::QualType const> qts) {
-  auto [iter, inserted] = qual_types_.try_emplace(expr, qts.begin(), qts.end());
-  return iter->second;
+  return *qual_types_.try_emplace(expr, qts.begin(), qts.end()).first;
 }
 
 absl::Span<type::QualType const> Context::set_qual_type(
     ast::Expression const *expr, type::QualType r) {
-  auto [iter, inserted] = qual_types_.try_emplace(expr, 1, r);
-  return iter->second;
+  return *qual_types_.try_emplace(expr, 1, r).first;
 }
 
 void Context::CompleteType(ast::Expression const *expr, bool success) {
-  if (auto iter = qual_types_.find(expr); iter != qual_types_.end()) {
+  if (auto *qts = qual_types_.find(expr)) {
     if (not success) {
-      for (auto &qt : iter->second) { qt.MarkError(); }
+      for (auto &qt : *qts) { qt.MarkError(); }
     }
     return;
   }
@@ -124,27 +255,25 @@ void Context::CompleteType(ast::Expression const *expr, bool success) {
 }
 
 ir::ModuleId Context::imported_module(ast::Import const *node) {
-  auto iter = imported_modules_.find(node);
-  if (iter != imported_modules_.end()) { return iter->second; }
+  if (auto const *id = imported_modules_.find(node)) { return *id; }
   if (parent()) { return parent()->imported_module(node); }
   return ir::ModuleId::Invalid();
 }
 
 void Context::set_imported_module(ast::Import const *node,
                                   ir::ModuleId module_id) {
-  imported_modules_.emplace(node, module_id);
+  imported_modules_.try_emplace(node, module_id);
 }
 
 absl::Span<ast::Declaration const *const> Context::decls(
     ast::Identifier const *id) const {
-  auto iter = decls_.find(id);
-  if (iter == decls_.end()) { return ASSERT_NOT_NULL(parent())->decls(id); }
-  return iter->second;
+  if (auto const *decls = decls_.find(id)) { return *decls; }
+  return ASSERT_NOT_NULL(parent())->decls(id);
 }
 
 void Context::set_decls(ast::Identifier const *id,
                         std::vector<ast::Declaration const *> decls) {
-  decls_.emplace(id, std::move(decls));
+  decls_.try_emplace(id, std::move(decls));
 }
 
 type::Struct *Context::get_struct(ast::StructLiteral const *s) const {
@@ -191,44 +320,59 @@ void Context::ClearVerifyBody(ast::Node const *node) {
 }
 
 void Context::CompleteConstant(ast::Declaration::Id const *id) {
-  auto iter = constants_.find(id);
-  ASSERT(iter != constants_.end());
-  iter->second.complete = true;
+  ASSERT_NOT_NULL(constants_.find(id))->complete = true;
 }
 
 ir::Value Context::SetConstant(ast::Declaration::Id const *id,
                                ir::Value const &value, bool complete) {
-  return constants_.try_emplace(id, value, complete).first->second.value();
+  return constants_.try_emplace(id, value, complete).first->value();
 }
 
 ir::Value Context::SetConstant(ast::Declaration::Id const *id,
-                               base::untyped_buffer buffer, bool complete) {
-  return constants_.try_emplace(id, buffer, complete).first->second.value();
+                               base::untyped_buffer buffer, type::Type t,
+                               bool complete) {
+  return constants_.try_emplace(id, std::move(buffer), IsPlainData(t), complete)
+      .first->value();
 }
 
 Context::ConstantValue const *Context::Constant(
    ast::Declaration::Id const *id) const {
-  auto iter = constants_.find(id);
-  return iter != constants_.end() ? &iter->second : nullptr;
+  return constants_.find(id);
 }
 
 void Context::SetAllOverloads(ast::Expression const *callee,
                               ast::OverloadSet os) {
   LOG("SetAllOverloads", "%s", callee->DebugString());
-  [[maybe_unused]] auto [iter, inserted] =
-      all_overloads_.emplace(callee, std::move(os));
+  [[maybe_unused]] auto [overloads, inserted] =
+      all_overloads_.try_emplace(callee, std::move(os));
   ASSERT(inserted == true);
 }
 
 ast::OverloadSet const *Context::AllOverloads(
     ast::Expression const *callee) const {
-  auto iter = all_overloads_.find(callee);
-  if (iter == all_overloads_.end()) {
-    if (parent() == nullptr) { return nullptr; }
-    return parent()->AllOverloads(callee);
-  } else {
-    return &iter->second;
-  }
+  if (auto const *os = all_overloads_.find(callee)) { return os; }
+  if (parent() == nullptr) { return nullptr; }
+  return parent()->AllOverloads(callee);
+}
+
+Context::OverloadResolution const *Context::FindOverloadResolution(
+    absl::Span<ast::Expression const *const> overloads,
+    core::Arguments<type::QualType> const &args) const {
+  auto iter = overload_resolutions_.find(std::pair(
+      std::vector<ast::Expression const *>(overloads.begin(), overloads.end()),
+      args));
+  return iter == overload_resolutions_.end() ? nullptr : &iter->second;
+}
+
+void Context::SetOverloadResolution(
+    absl::Span<ast::Expression const *const> overloads,
+    core::Arguments<type::QualType> const &args,
+    OverloadResolution resolution) {
+  overload_resolutions_.try_emplace(
+      std::pair(std::vector<ast::Expression const *>(overloads.begin(),
+                                                     overloads.end()),
+                args),
+      std::move(resolution));
 }
 
 std::pair<ir::NativeFn, bool> Context::InsertInit(type::Type t) {
@@ -236,14 +380,14 @@ std::pair<ir::NativeFn, bool> Context::InsertInit(type::Type t) {
   auto &entry           = iter->second;
 
   if (inserted) {
-    auto const *data = InsertFunction(
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::Init, t, t,
         type::Func(core::Params<type::QualType>{core::AnonymousParam(
                        type::QualType::NonConstant(type::Ptr(t)))},
                    {}),
         core::Params<type::Typed<ast::Declaration const *>>{
             core::AnonymousParam(
                 type::Typed<ast::Declaration const *>(nullptr, t))});
-    entry = ir::NativeFn(data);
   }
 
   return std::pair(entry, inserted);
@@ -254,14 +398,14 @@ std::pair<ir::NativeFn, bool> Context::InsertDestroy(type::Type t) {
   auto &entry           = iter->second;
 
   if (inserted) {
-    auto const *data = InsertFunction(
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::Destroy, t, t,
         type::Func(core::Params<type::QualType>{core::AnonymousParam(
                        type::QualType::NonConstant(type::Ptr(t)))},
                    {}),
         core::Params<type::Typed<ast::Declaration const *>>{
             core::AnonymousParam(
                 type::Typed<ast::Declaration const *>(nullptr, t))});
-    entry = ir::NativeFn(data);
   }
 
   return std::pair(entry, inserted);
@@ -273,19 +417,20 @@ std::pair<ir::NativeFn, bool> Context::InsertCopyAssign(type::Type to,
   auto &entry           = iter->second;
 
   if (inserted) {
-  auto const *data = InsertFunction(
-      type::Func(
-          core::Params<type::QualType>{
-              core::AnonymousParam(type::QualType::NonConstant(type::Ptr(to))),
-              core::AnonymousParam(
-                  type::QualType::NonConstant(type::Ptr(from)))},
-          {}),
-      core::Params<type::Typed<ast::Declaration const *>>{
-          core::AnonymousParam(
-              type::Typed<ast::Declaration const *>(nullptr, to)),
-          core::AnonymousParam(
-              type::Typed<ast::Declaration const *>(nullptr, from))});
-    entry = ir::NativeFn(data);
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::CopyAssign, to, from,
+        type::Func(
+            core::Params<type::QualType>{
+                core::AnonymousParam(
+                    type::QualType::NonConstant(type::Ptr(to))),
+                core::AnonymousParam(
+                    type::QualType::NonConstant(type::Ptr(from)))},
+            {}),
+        core::Params<type::Typed<ast::Declaration const *>>{
+            core::AnonymousParam(
+                type::Typed<ast::Declaration const *>(nullptr, to)),
+            core::AnonymousParam(
+                type::Typed<ast::Declaration const *>(nullptr, from))});
   }
 
   return std::pair(entry, inserted);
@@ -297,7 +442,8 @@ std::pair<ir::NativeFn, bool> Context::InsertMoveAssign(type::Type to,
   auto &entry           = iter->second;
 
   if (inserted) {
-    auto const *data = InsertFunction(
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::MoveAssign, to, from,
         type::Func(
             core::Params<type::QualType>{
                 core::AnonymousParam(
@@ -310,7 +456,6 @@ std::pair<ir::NativeFn, bool> Context::InsertMoveAssign(type::Type to,
                 type::Typed<ast::Declaration const *>(nullptr, to)),
             core::AnonymousParam(
                 type::Typed<ast::Declaration const *>(nullptr, from))});
-    entry = ir::NativeFn(data);
   }
 
   return std::pair(entry, inserted);
@@ -322,14 +467,14 @@ std::pair<ir::NativeFn, bool> Context::InsertMoveInit(type::Type to,
   auto &entry           = iter->second;
 
   if (inserted) {
-    auto const *data = InsertFunction(
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::MoveInit, to, from,
         type::Func(core::Params<type::QualType>{core::AnonymousParam(
                        type::QualType::NonConstant(type::Ptr(from)))},
                    {to}),
         core::Params<type::Typed<ast::Declaration const *>>{
             core::AnonymousParam(
                 type::Typed<ast::Declaration const *>(nullptr, from))});
-    entry = ir::NativeFn(data);
   }
   return std::pair(entry, inserted);
 }
@@ -340,18 +485,104 @@ std::pair<ir::NativeFn, bool> Context::InsertCopyInit(type::Type to,
   auto &entry           = iter->second;
 
   if (inserted) {
-    auto const *data = InsertFunction(
+    std::tie(entry, inserted) = InsertSpecialMember(
+        SpecialMember::CopyInit, to, from,
         type::Func(core::Params<type::QualType>{core::AnonymousParam(
                        type::QualType::NonConstant(type::Ptr(from)))},
                    {to}),
         core::Params<type::Typed<ast::Declaration const *>>{
             core::AnonymousParam(
                 type::Typed<ast::Declaration const *>(nullptr, from))});
-    entry = ir::NativeFn(data);
   }
   return std::pair(entry, inserted);
 }
 
+std::pair<ir::NativeFn, bool> Context::InsertSpecialMember(
+    SpecialMember kind, type::Type to, type::Type from,
+    type::Function const *fn_type,
+    core::Params<type::Typed<ast::Declaration const *>> params) {
+  if (type::Provenance(to) != nullptr or type::Provenance(from) != nullptr) {
+    return std::pair(ir::NativeFn(InsertFunction(fn_type, std::move(params))),
+                     true);
+  }
+
+  auto key = std::tuple(static_cast<int>(kind), to, from);
+  while (true) {
+    std::shared_ptr<SharedSpecialMember> member;
+    bool inserted;
+    {
+      auto handle = shared_special_members.lock();
+      auto [iter, member_inserted] = handle->members.try_emplace(key);
+      inserted                     = member_inserted;
+      if (inserted) {
+        iter->second = std::make_shared<SharedSpecialMember>();
+        member       = iter->second;
+        member->key  = key;
+        member->fn   = std::make_unique<ir::CompiledFn>(fn_type, params);
+        member->data = std::make_unique<ir::NativeFn::Data>(ir::NativeFn::Data{
+            .fn   = member->fn.get(),
+            .type = fn_type,
+        });
+        handle->by_fn.emplace(member->fn.get(), member);
+      } else {
+        member = iter->second;
+      }
+    }
+
+    // Whoever inserted the function is responsible for writing it. Everyone
+    // else must wait until it is usable, or until it has been abandoned, in
+    // which case they try again.
+    if (not inserted) {
+      member->written.WaitForNotification();
+      if (member->abandoned) { continue; }
+    }
+
+    Context &r = root();
+    if (std::find(r.shared_fns_.begin(), r.shared_fns_.end(),
+                  member->fn.get()) == r.shared_fns_.end()) {
+      r.shared_fns_.push_back(member->fn.get());
+    }
+    if (inserted) { r.unwritten_shared_fns_.push_back(member->fn.get()); }
+    return std::pair(ir::NativeFn(member->data.get()), inserted);
+  }
+}
+
+ir::CompiledFn &Context::FinalizeThunk(ir::CompiledFn fn) {
+  // The byte code determines what the thunk computes, but neither the type it
+  // is evaluated as nor its stack allocations are written to it.
+  base::untyped_buffer key;
+  key.append(fn.type());
+  fn.for_each_alloc([&](type::Type t, ir::Reg r) {
+    key.append(t);
+    key.append(r);
+  });
+  key.write(key.size(), EmitByteCode(fn));
+
+  auto [iter, inserted] =
+      thunks_.try_emplace(std::string(key.raw(0), key.size()));
+  if (inserted) {
+    iter->second = std::make_unique<ir::CompiledFn>(std::move(fn));
+    ByteCode(*iter->second);
+  }
+  return *iter->second;
+}
+
+void Context::WriteByteCode(ir::NativeFn f) {
+  ByteCode(*f);
+
+  std::erase(root().unwritten_shared_fns_, &*f);
+  auto handle = shared_special_members.lock();
+  auto iter   = handle->by_fn.find(&*f);
+  if (iter == handle->by_fn.end()) { return; }
+  iter->second->written.Notify();
+}
+
+void Context::AbandonSpecialMember(ir::NativeFn f) {
+  std::erase(root().shared_fns_, &*f);
+  std::erase(root().unwritten_shared_fns_, &*f);
+  AbandonSharedSpecialMember(&*f);
+}
+
 absl::Span<ast::ReturnStmt const *const> Context::ReturnsTo(
     base::PtrUnion<ast::FunctionLiteral const, ast::ShortFunctionLiteral const>
         node) const {
@@ -3,6 +3,8 @@
 
 #include <forward_list>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -13,11 +15,14 @@
 #include "base/guarded.h"
 #include "compiler/instructions.h"
 #include "compiler/jump_map.h"
+#include "compiler/node_table.h"
+#include "core/arguments.h"
 #include "ir/builder.h"
 #include "ir/compiled_block.h"
 #include "ir/compiled_fn.h"
 #include "ir/compiled_jump.h"
 #include "ir/compiled_scope.h"
+#include "ir/read_only_data.h"
 #include "ir/value/block.h"
 #include "ir/value/reg.h"
 #include "ir/value/scope.h"
@@ -132,6 +137,18 @@ struct Context {
       core::Params<std::pair<ir::Value, type::QualType>> const &params,
       Context &&context);
 
+  // Returns the result of a previous `InsertSubcontext` call for `node` whose
+  // parameters were computed from `args`, as recorded by `CacheInstantiation`,
+  // or a null pointer if there is none. This allows callers to find an
+  // existing instantiation without computing its parameters in a scratchpad.
+  // The `inserted` member of the returned result is always false.
+  InsertSubcontextResult const *CachedInstantiation(
+      ast::ParameterizedExpression const *node,
+      core::Arguments<type::Typed<ir::Value>> const &args) const;
+  void CacheInstantiation(ast::ParameterizedExpression const *node,
+                          core::Arguments<type::Typed<ir::Value>> const &args,
+                          InsertSubcontextResult const &result);
+
   // FindSubcontext:
   //
   // Returns a `FindSubcontextResult`. The `context` reference member refers to
@@ -176,9 +193,21 @@ struct Context {
   }
   ir::Block add_block() { return ir::Block(&blocks_.emplace_front()); }
 
+  // Finalizes the thunk `fn` and returns it, unless a thunk whose byte code
+  // before optimization is identical has already been finalized in this
+  // context, in which case that thunk is returned instead. Thunks for
+  // structurally identical expressions (e.g., repeated `bytes(T)` queries) are
+  // therefore only optimized and emitted once. Their byte code refers to
+  // functions by address, so thunks are kept no longer than this context.
+  ir::CompiledFn &FinalizeThunk(ir::CompiledFn fn);
+
+  // Calls `f` on each function compiled in this context, as well as on each
+  // special member function shared by all modules (see `InsertInit`) which
+  // this context's module references, in the order they were first referenced.
   void ForEachCompiledFn(
       std::invocable<ir::CompiledFn const *> auto &&f) const {
     for (auto const &compiled_fn : fns_) { f(compiled_fn.get()); }
+    for (auto const *compiled_fn : shared_fns_) { f(compiled_fn); }
   }
 
   void ForEachCompiledFn(
@@ -186,6 +215,9 @@ struct Context {
     for (auto const &compiled_fn : fns_) {
       f(compiled_fn.get(), module::Linkage::Internal);
     }
+    for (auto const *compiled_fn : shared_fns_) {
+      f(compiled_fn, module::Linkage::Internal);
+    }
   }
 
 
@@ -232,8 +264,8 @@ struct Context {
   void CompleteType(ast::Expression const *expr, bool success);
 
   ir::Value LoadConstant(ast::Declaration::Id const *id) const {
-    if (auto iter = constants_.find(id); iter != constants_.end()) {
-      ir::Value val = iter->second.value();
+    if (auto const *constant = constants_.find(id)) {
+      ir::Value val = constant->value();
       if (not val.empty()) { return val; }
     }
     if (parent()) { return parent()->LoadConstant(id); }
@@ -285,21 +317,24 @@ struct Context {
   void ClearVerifyBody(ast::Node const *node);
 
   struct ConstantValue {
-    explicit ConstantValue(base::untyped_buffer buffer, bool complete)
-        : complete(complete), is_big(true), buffer_(std::move(buffer)) {}
+    // Big constants consisting only of plain data are interned in the
+    // read-only data segment and referred to by address, so every use of the
+    // constant shares a single copy. Constants holding addresses (e.g.,
+    // pointers, slices, or functions) are only meaningful within the compiler
+    // and keep a buffer of their own.
+    explicit ConstantValue(base::untyped_buffer buffer, bool plain_data,
+                           bool complete)
+        : complete(complete),
+          is_big(true),
+          buffer_(plain_data ? base::untyped_buffer() : std::move(buffer)),
+          value_(plain_data
+                     ? ir::Value(ir::GlobalReadOnlyData.lock()->Intern(
+                           std::string_view(buffer.raw(0), buffer.size())))
+                     : ir::Value(const_cast<char *>(buffer_.raw(0)))) {}
     explicit ConstantValue(ir::Value const &v, bool complete)
-        : complete(complete), is_big(false) {
-      buffer_.append(v);
-    }
+        : complete(complete), is_big(false), value_(v) {}
 
-    // TODO: This is essentially a small-buffer optimization for Value-sized
-    // things. Maybe we should do that explicitly.
-    ir::Value value() const {
-      // TODO: Do we need to track constness of addresses in the type system
-      // too?
-      return is_big ? ir::Value(const_cast<char *>(buffer_.raw(0)))
-                    : ir::Value(buffer_.get<ir::Value>(0));
-    }
+    ir::Value value() const { return value_; }
 
     // Whether or not the held value is complete. This may be a struct or
     // function whose body has not been emit yet.
@@ -308,12 +343,14 @@ struct Context {
 
    private:
     base::untyped_buffer buffer_;
+    ir::Value value_;
   };
   void CompleteConstant(ast::Declaration::Id const *id);
   ir::Value SetConstant(ast::Declaration::Id const *id, ir::Value const &value,
                         bool complete = false);
   ir::Value SetConstant(ast::Declaration::Id const *id,
-                        base::untyped_buffer buffer, bool complete = false);
+                        base::untyped_buffer buffer, type::Type t,
+                        bool complete = false);
 
   ConstantValue const *Constant(ast::Declaration::Id const *id) const;
 
@@ -321,36 +358,53 @@ struct Context {
   ast::OverloadSet const *AllOverloads(ast::Expression const *callee) const;
 
   void SetViableOverloads(ast::Expression const *callee, ast::OverloadSet os) {
-    viable_overloads_.emplace(callee, std::move(os));
+    viable_overloads_.try_emplace(callee, std::move(os));
   }
 
   void SetAdlModules(ast::Identifier const *callee,
                      absl::flat_hash_set<CompiledModule const *> modules) {
-    adl_modules_.emplace(callee, std::move(modules));
+    adl_modules_.try_emplace(callee, std::move(modules));
   }
   absl::flat_hash_set<CompiledModule const *> const *AdlModules(
       ast::Identifier const *callee) {
-    auto iter = adl_modules_.find(callee);
-    if (iter == adl_modules_.end()) {
-      if (parent()) { return parent()->AdlModules(callee); }
-      return nullptr;
-    } else {
-      return &iter->second;
-    }
+    if (auto const *modules = adl_modules_.find(callee)) { return modules; }
+    if (parent()) { return parent()->AdlModules(callee); }
+    return nullptr;
   }
 
   ast::OverloadSet const &ViableOverloads(ast::Expression const *callee) const {
-    auto iter = viable_overloads_.find(callee);
-    if (iter == viable_overloads_.end()) {
-      if (parent() == nullptr) {
-        UNREACHABLE("Failed to find any overloads for ", callee->DebugString());
-      }
-      return parent()->ViableOverloads(callee);
-    } else {
-      return iter->second;
+    if (auto const *os = viable_overloads_.find(callee)) { return *os; }
+    if (parent() == nullptr) {
+      UNREACHABLE("Failed to find any overloads for ", callee->DebugString());
     }
+    return parent()->ViableOverloads(callee);
   }
 
+  // The overload selected for a call whose callee is an overload set with the
+  // given members, along with the qualified types of the call.
+  struct OverloadResolution {
+    ast::Expression const *callee;
+    std::vector<type::QualType> qual_types;
+  };
+
+  // Returns the result of a previous overload resolution recorded in this
+  // context via `SetOverloadResolution` for the given overload set members
+  // and argument types, or a null pointer if there is none.
+  OverloadResolution const *FindOverloadResolution(
+      absl::Span<ast::Expression const *const> overloads,
+      core::Arguments<type::QualType> const &args) const;
+  void SetOverloadResolution(absl::Span<ast::Expression const *const> overloads,
+                             core::Arguments<type::QualType> const &args,
+                             OverloadResolution resolution);
+
+  // Returns the special member function of the given kind along with a bool
+  // which is true if and only if the caller is responsible for emitting its
+  // body and writing its byte code. Special members of types which do not
+  // depend on any module (e.g., arrays of primitives) are shared by every
+  // module in the build, so they are emitted only once. Callers which did not
+  // insert such a function block until its byte code has been written. If the
+  // inserting caller fails to write it, it must call `AbandonSpecialMember` so
+  // that one of the blocked callers can take over.
   std::pair<ir::NativeFn, bool> InsertInit(type::Type t);
   std::pair<ir::NativeFn, bool> InsertDestroy(type::Type t);
   std::pair<ir::NativeFn, bool> InsertCopyAssign(type::Type to,
@@ -360,11 +414,14 @@ struct Context {
   std::pair<ir::NativeFn, bool> InsertCopyInit(type::Type to, type::Type from);
   std::pair<ir::NativeFn, bool> InsertMoveInit(type::Type to, type::Type from);
 
-  void WriteByteCode(ir::NativeFn f) {
-    auto byte_code            = EmitByteCode(*f);
-    fn_data_.at(f)->byte_code = byte_code.begin();
-    byte_code_.push_back(std::move(byte_code));
-  }
+  void WriteByteCode(ir::NativeFn f);
+
+  // Releases the responsibility for emitting `f`, a special member function
+  // returned by one of the `Insert*` functions above whose byte code will not
+  // be written. Callers blocked on `f` are woken and retry the insertion. Any
+  // special member still unwritten when this context is destroyed is
+  // abandoned implicitly.
+  void AbandonSpecialMember(ir::NativeFn f);
 
   void TrackJumps(ast::Node const *p) { jumps_.TrackJumps(p); }
 
@@ -382,6 +439,19 @@ struct Context {
       type::Function const *fn_type,
       core::Params<type::Typed<ast::Declaration const *>> params);
 
+  enum class SpecialMember {
+    Init,
+    Destroy,
+    CopyAssign,
+    MoveAssign,
+    CopyInit,
+    MoveInit
+  };
+  std::pair<ir::NativeFn, bool> InsertSpecialMember(
+      SpecialMember kind, type::Type to, type::Type from,
+      type::Function const *fn_type,
+      core::Params<type::Typed<ast::Declaration const *>> params);
+
   CompiledModule &mod_;
 
   // Each Context is an intrusive node in a tree structure. Each Context has a
@@ -396,12 +466,19 @@ struct Context {
                             std::unique_ptr<Subcontext>>>
         children;
   } tree_;
+  absl::flat_hash_map<
+      std::pair<ast::ParameterizedExpression const *,
+                core::Arguments<type::Typed<ir::Value>>>,
+      InsertSubcontextResult>
+      instantiations_;
   constexpr Context *parent() { return tree_.parent; }
   constexpr Context const *parent() const { return tree_.parent; }
 
+  // Data computed about syntax tree nodes is held in `NodeTable`s, which are
+  // dense in the root context and sparse in subcontexts.
+
   // Types of the expressions in this context.
-  absl::flat_hash_map<ast::Expression const *, std::vector<type::QualType>>
-      qual_types_;
+  NodeTable<ast::Expression, std::vector<type::QualType>> qual_types_;
 
   // Stores the types of argument bound to the parameter with the given name.
   absl::flat_hash_map<std::string_view, type::Type> arg_type_;
@@ -409,13 +486,11 @@ struct Context {
 
   // A map from each identifier to all possible declarations that the identifier
   // might refer to.
-  absl::flat_hash_map<ast::Identifier const *,
-                      std::vector<ast::Declaration const *>>
-      decls_;
+  NodeTable<ast::Identifier, std::vector<ast::Declaration const *>> decls_;
 
   // Map of all constant declarations to their values within this dependent
   // context.
-  absl::flat_hash_map<ast::Declaration::Id const *, ConstantValue> constants_;
+  NodeTable<ast::Declaration::Id, ConstantValue> constants_;
 
   absl::flat_hash_map<ast::StructLiteral const *, type::Struct *> structs_;
   absl::flat_hash_map<ast::ParameterizedStructLiteral const *, type::Struct *>
@@ -423,39 +498,49 @@ struct Context {
   absl::flat_hash_map<type::Struct *, ast::Expression const *> reverse_structs_;
 
   // Colleciton of modules imported by this one.
-  absl::flat_hash_map<ast::Import const *, ir::ModuleId> imported_modules_;
+  NodeTable<ast::Import, ir::ModuleId> imported_modules_;
 
   // TODO: I'm not sure anymore if this is necessary/what we want.
   absl::flat_hash_set<ast::Node const *> body_verification_complete_;
 
   // Overloads for a callable expression, including overloads that are not
   // callable based on the call-site arguments.
-  absl::flat_hash_map<ast::Expression const *, ast::OverloadSet> all_overloads_;
+  NodeTable<ast::Expression, ast::OverloadSet> all_overloads_;
 
   // Overloads for a callable expression, keeping only the ones that are viable
   // based on the call-site arguments.
-  absl::flat_hash_map<ast::Expression const *, ast::OverloadSet>
-      viable_overloads_;
+  NodeTable<ast::Expression, ast::OverloadSet> viable_overloads_;
+
+  // Overload resolutions, keyed on the members of the overload set and the
+  // argument types. Only resolutions which depend on nothing else (i.e., those
+  // for which no member of the overload set is generic) are recorded.
+  absl::flat_hash_map<std::pair<std::vector<ast::Expression const *>,
+                                core::Arguments<type::QualType>>,
+                      OverloadResolution>
+      overload_resolutions_;
 
   // All functions, whether they're directly compiled or generated by a generic.
   std::vector<std::unique_ptr<ir::CompiledFn>> fns_;
+
+  // Finalized thunks, keyed on their byte code before optimization.
+  absl::flat_hash_map<std::string, std::unique_ptr<ir::CompiledFn>> thunks_;
+
+  // Special member functions shared by all modules which are referenced from
+  // this context, recorded on the root context in the order they were first
+  // referenced. Those which this context is responsible for writing but has
+  // not yet written are also held in `unwritten_shared_fns_`.
+  std::vector<ir::CompiledFn const *> shared_fns_;
+  std::vector<ir::CompiledFn const *> unwritten_shared_fns_;
   absl::flat_hash_map<ir::NativeFn, std::unique_ptr<ir::NativeFn::Data>>
       fn_data_;
   absl::node_hash_map<ast::ParameterizedExpression const *, ir::NativeFn>
       ir_funcs_;
 
-  // Holds the byte code for each function defined in this context. The buffer
-  // itself, once inserted into the map, should never be modified. Iterators may
-  // reference into the buffer. As this map is further modified, the mapped
-  // values may be moved, but iterators will remain valid.
-  std::vector<base::untyped_buffer> byte_code_;
-
   // All jumps, whether they're directly compiled or generated by a generic.
   absl::node_hash_map<ast::Jump const *, ir::CompiledJump> ir_jumps_;
 
   // The modules in which to look up a callee.
-  absl::flat_hash_map<ast::Identifier const *,
-                      absl::flat_hash_set<CompiledModule const *>>
+  NodeTable<ast::Identifier, absl::flat_hash_set<CompiledModule const *>>
       adl_modules_;
 
   // This forward_list is never iterated over, we only require pointer
@@ -0,0 +1,37 @@
+#include "compiler/context.h"
+
+#include "gtest/gtest.h"
+#include "ir/builder.h"
+#include "ir/compiled_fn.h"
+#include "ir/instruction/core.h"
+#include "test/module.h"
+#include "type/function.h"
+#include "type/primitive.h"
+
+namespace compiler {
+namespace {
+
+// Returns a thunk returning `n` as a value of type `t`.
+template <typename T>
+ir::CompiledFn Thunk(type::Type t, T n) {
+  ir::CompiledFn fn(type::Func({}, {t}),
+                    core::Params<type::Typed<ast::Declaration const *>>{});
+  ir::Builder bldr;
+  bldr.CurrentGroup() = &fn;
+  bldr.CurrentBlock() = fn.entry();
+  bldr.CurrentBlock()->Append(
+      ir::SetReturnInstruction<T>{.index = 0, .value = n});
+  bldr.ReturnJump();
+  return fn;
+}
+
+TEST(FinalizeThunk, SharesStructurallyIdenticalThunks) {
+  test::TestModule mod;
+  ir::CompiledFn &three = mod.context().FinalizeThunk(Thunk(type::I64, int64_t{3}));
+  EXPECT_TRUE(three.complete());
+  EXPECT_EQ(&mod.context().FinalizeThunk(Thunk(type::I64, int64_t{3})), &three);
+  EXPECT_NE(&mod.context().FinalizeThunk(Thunk(type::I64, int64_t{4})), &three);
+}
+
+}  // namespace
+}  // namespace compiler
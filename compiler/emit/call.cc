@@ -124,6 +124,50 @@ ir::Value EmitBuiltinCall(Compiler &c, ast::BuiltinFn const *callee,
     case ir::BuiltinFn::Which::Abort:
       c.current_block()->Append(ir::AbortInstruction{});
       return ir::Value();
+
+    // The memory intrinsics operate on bytes and are executed natively rather
+    // than through a foreign function call.
+    case ir::BuiltinFn::Which::MemCopy: {
+      auto to    = c.EmitValue(&args[0].expr()).get<ir::RegOr<ir::addr_t>>();
+      auto from  = c.EmitValue(&args[1].expr()).get<ir::RegOr<ir::addr_t>>();
+      auto bytes = c.EmitValue(&args[2].expr()).get<ir::RegOr<uint64_t>>();
+      c.current_block()->Append(ir::MemCopyInstruction{
+          .from = from, .to = to, .type = type::U8, .count = bytes});
+      c.current_block()->load_store_cache().clear();
+      return ir::Value();
+    }
+    case ir::BuiltinFn::Which::MemSet: {
+      auto to    = c.EmitValue(&args[0].expr()).get<ir::RegOr<ir::addr_t>>();
+      auto value = c.EmitValue(&args[1].expr()).get<ir::RegOr<uint8_t>>();
+      auto bytes = c.EmitValue(&args[2].expr()).get<ir::RegOr<uint64_t>>();
+      c.current_block()->Append(ir::MemSetInstruction{
+          .to = to, .value = value, .type = type::U8, .count = bytes});
+      c.current_block()->load_store_cache().clear();
+      return ir::Value();
+    }
+    case ir::BuiltinFn::Which::MemCompare: {
+      auto lhs   = c.EmitValue(&args[0].expr()).get<ir::RegOr<ir::addr_t>>();
+      auto rhs   = c.EmitValue(&args[1].expr()).get<ir::RegOr<ir::addr_t>>();
+      auto bytes = c.EmitValue(&args[2].expr()).get<ir::RegOr<uint64_t>>();
+      return ir::Value(c.current_block()->Append(ir::MemCompareInstruction{
+          .lhs    = lhs,
+          .rhs    = rhs,
+          .bytes  = bytes,
+          .result = c.builder().CurrentGroup()->Reserve()}));
+    }
+    case ir::BuiltinFn::Which::Malloc: {
+      auto maybe_type = c.EvaluateOrDiagnoseAs<type::Type>(&args[0].expr());
+      if (not maybe_type) { return ir::Value(); }
+      auto count = c.EmitValue(&args[1].expr()).get<ir::RegOr<uint64_t>>();
+      return ir::Value(c.current_block()->Append(ir::MallocInstruction{
+          .type   = *maybe_type,
+          .count  = count,
+          .result = c.builder().CurrentGroup()->Reserve()}));
+    }
+    case ir::BuiltinFn::Which::Free:
+      c.current_block()->Append(ir::FreeInstruction{
+          .addr = c.EmitValue(&args[0].expr()).get<ir::RegOr<ir::addr_t>>()});
+      return ir::Value();
   }
   UNREACHABLE();
 }
@@ -18,6 +18,8 @@ TEST_P(CallTest, Call) {
   test::TestModule mod;
   mod.AppendCode(R"(
   identity ::= (x: ~`T) => x
+  square ::= (n :: i64) => n * n
+  scale ::= (k :: i64, n: i64) => k * n
   )");
 
   auto const *e = mod.Append<ast::Expression>(expr);
@@ -94,6 +96,15 @@ INSTANTIATE_TEST_SUITE_P(
         TestCase{.description = "Instantiate the same generic more than once.",
                  .expr        = R"((identity(2) as f64) + identity(1.0))",
                  .expected    = ir::Value(3.0)},
+        TestCase{.description = "Reuse an instantiation with the same types.",
+                 .expr        = R"(identity(2) + identity(3))",
+                 .expected    = ir::Value(int64_t{5})},
+        TestCase{.description = "Instantiate once per constant argument.",
+                 .expr        = R"(square(2) + square(3))",
+                 .expected    = ir::Value(int64_t{13})},
+        TestCase{.description = "Key instantiations only on constant values.",
+                 .expr        = R"(scale(2, 3) + scale(2, 4) + scale(3, 1))",
+                 .expected    = ir::Value(int64_t{17})},
 
         // Value to pointer casts
         TestCase{
@@ -117,6 +128,21 @@ INSTANTIATE_TEST_SUITE_P(
             .expected = ir::Value(int64_t{12}),
         },
 
+        // Memory intrinsics
+        TestCase{
+            .expr     = R"((() -> i32 {
+                             a := builtin_malloc(u8, 4 as u64)
+                             builtin_memset(a, 7 as u8, 4 as u64)
+                             b := builtin_malloc(u8, 4 as u64)
+                             builtin_memcpy(b, a, 4 as u64)
+                             result := builtin_memcmp(a, b, 4 as u64)
+                             builtin_free(a)
+                             builtin_free(b)
+                             return result
+                           })())",
+            .expected = ir::Value(int32_t{0}),
+        },
+
         // TODO: Value to pointer casts with structs and with designated
         // initializers.
         TestCase{
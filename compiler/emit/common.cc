@@ -357,6 +357,10 @@ std::optional<ir::CompiledFn> StructCompletionFn(
       if (user_dtor) { dtor = *user_dtor; }
     }
 
+    bool user_defined_copy_or_move =
+        not(move_inits.empty() and copy_inits.empty() and
+            move_assignments.empty() and copy_assignments.empty());
+
     if (move_inits.empty() and copy_inits.empty()) {
       move_inits.push_back(InsertGeneratedMoveInit(c, s, ir_fields));
       copy_inits.push_back(InsertGeneratedCopyInit(c, s, ir_fields));
@@ -375,7 +379,9 @@ std::optional<ir::CompiledFn> StructCompletionFn(
                                 .copy_inits       = std::move(copy_inits),
                                 .move_assignments = std::move(move_assignments),
                                 .copy_assignments = std::move(copy_assignments),
-                                .dtor             = dtor});
+                                .dtor             = dtor,
+                                .user_defined_copy_or_move =
+                                    user_defined_copy_or_move});
     c.builder().ReturnJump();
   }
 
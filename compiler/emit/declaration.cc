@@ -52,7 +52,8 @@ ir::Value EmitConstantDeclaration(Compiler &c, ast::Declaration const *node) {
 
         LOG("EmitConstantDeclaration", "Setting slot = %s", value_buffer);
         // TODO: Support multiple declarations
-        return c.context().SetConstant(&node->ids()[0], std::move(value_buffer));
+        return c.context().SetConstant(&node->ids()[0],
+                                       std::move(value_buffer), t);
       } else {
         auto maybe_val = c.Evaluate(
             type::Typed<ast::Expression const *>(node->initial_value(), t),
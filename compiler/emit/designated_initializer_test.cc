@@ -19,6 +19,8 @@ TEST_P(DesignatedInitializerTest, DesignatedInitializer) {
   Int ::= struct { n := 3 }
   Pair ::= struct { a: i64 \\ b: bool }
   Wrap ::= struct (T ::= i64) { x: T }
+  Loose ::= struct { a: bool \\ b: f64 \\ c: bool }
+  Compact ::= #{compact} struct { a: bool \\ b: f64 \\ c: bool }
 
   f ::= () -> (i64, bool) { return 3, true }
   )");
@@ -63,6 +65,16 @@ INSTANTIATE_TEST_SUITE_P(
                  .expected = ir::Value(double{0})},
         TestCase{.expr     = R"(Wrap(f64).{x = 3.1}.x)",
                  .expected = ir::Value(3.1)},
+        TestCase{.expr     = R"(bytes(Loose))",
+                 .expected = ir::Value(uint64_t{24})},
+        TestCase{.expr     = R"(bytes(Compact))",
+                 .expected = ir::Value(uint64_t{16})},
+        TestCase{.expr     = R"(Compact.{a = true \\ b = 2.5}.a)",
+                 .expected = ir::Value(true)},
+        TestCase{.expr     = R"(Compact.{a = true \\ b = 2.5}.b)",
+                 .expected = ir::Value(2.5)},
+        TestCase{.expr     = R"(Compact.{a = true \\ b = 2.5}.c)",
+                 .expected = ir::Value(false)},
 
         // TODO: Enable these tests once you allow simultaneous assignments.
         // TestCase{.expr     = R"(Pair.{ (a, b) = 'f }.a)",
@@ -26,8 +26,8 @@ ir::Value Compiler::EmitValue(ast::PatternMatch const *node) {
   };
   if (PatternMatch(&node->pattern(), pmc)) {
     for (auto &[name, buffer] : pmc.bindings) {
-      auto const *id =
-          module::AllVisibleDeclsTowardsRoot(node->scope(), name)[0];
+      auto const *id = module::AllVisibleDeclsTowardsRoot(
+          node->scope(), ast::Symbol(std::string(name)))[0];
       context().SetConstant(id, std::move(buffer));
     }
   } else {
@@ -3,16 +3,58 @@
 #include "compiler/instructions.h"
 #include "ir/instruction/instructions.h"
 
-// TODO: Currently inserting these always at the root. There are a couple of
-// reason why this is wrong. First, If this is generated due to a temporary
-// subcontext, we probably want to drop it, as we can't verify the constructed
-// type is valid in any way. Second, For types like arrays of primitives, we
-// only need to generate the code for them once, rather than per module.
+// TODO: Currently inserting these always at the root. If this is generated due
+// to a temporary subcontext, we probably want to drop it, as we can't verify
+// the constructed type is valid in any way.
+//
+// Special members of types which do not depend on any module (e.g., arrays of
+// primitives) are shared across modules, and their byte code is written only
+// once. Because other modules may use such a function as soon as its byte code
+// is written, the function must be attached to its type before then.
 
 namespace compiler {
 namespace {
 enum Kind{ Move, Copy };
 
+// Array types copy the flags of their element type when they are created, at
+// which point a struct element may not yet be complete. Properties of an array
+// are therefore read from its innermost element type instead.
+type::Type InnermostElementType(type::Array const *a) {
+  type::Type t = a->data_type();
+  while (auto const *inner = t.if_as<type::Array>()) { t = inner->data_type(); }
+  return t;
+}
+
+// Trivially copyable structs are copied and moved inline rather than by calling
+// their generated special member functions. A struct's flags are only final
+// once it is complete: until its user-defined special members are attached it
+// may still claim to be trivially copyable.
+bool CopiesBytes(type::Struct const *s) {
+  return s->completeness() == type::Completeness::Complete and
+         s->IsTriviallyCopyable();
+}
+
+// Arrays whose elements are trivially copyable are copied and moved with a
+// single bulk memory copy rather than a loop over their elements.
+bool CopiesBytes(type::Array const *a) {
+  type::Type t = InnermostElementType(a);
+  if (auto const *s = t.if_as<type::Struct>()) { return CopiesBytes(s); }
+  return t.get()->IsTriviallyCopyable();
+}
+
+void EmitArrayMemCopy(Compiler &c, type::Array const *a,
+                      ir::RegOr<ir::addr_t> from, ir::RegOr<ir::addr_t> to) {
+  c.current_block()->Append(ir::MemCopyInstruction{
+      .from = from, .to = to, .type = a->data_type(), .count = a->length()});
+  c.current_block()->load_store_cache().clear();
+}
+
+void EmitStructMemCopy(Compiler &c, type::Struct const *s,
+                       ir::RegOr<ir::addr_t> from, ir::RegOr<ir::addr_t> to) {
+  c.current_block()->Append(
+      ir::MemCopyInstruction{.from = from, .to = to, .type = s, .count = 1});
+  c.current_block()->load_store_cache().clear();
+}
 
 template <Kind K>
 void EmitArrayAssignment(Compiler &c, type::Array const *to,
@@ -134,6 +176,16 @@ void EmitArrayInit(Compiler &c, type::Array const *to,
 }  // namespace
 
 void Compiler::EmitDefaultInit(type::Typed<ir::Reg, type::Array> const &r) {
+  if (InnermostElementType(r.type()).get()->IsZeroInitializable()) {
+    current_block()->Append(
+        ir::MemSetInstruction{.to    = *r,
+                              .value = 0,
+                              .type  = r.type()->data_type(),
+                              .count = r.type()->length()});
+    current_block()->load_store_cache().clear();
+    return;
+  }
+
   auto [fn, inserted] = context().root().InsertInit(r.type());
   if (inserted) {
     ICARUS_SCOPE(ir::SetCurrent(fn, builder())) {
@@ -143,9 +195,9 @@ void Compiler::EmitDefaultInit(type::Typed<ir::Reg, type::Array> const &r) {
       });
       builder().ReturnJump();
     }
-    context().root().WriteByteCode(fn);
     // TODO: Remove const_cast.
     const_cast<type::Array *>(r.type())->SetInitializer(fn);
+    context().root().WriteByteCode(fn);
   }
 
   current_block()->Append(ir::InitInstruction{.type = r.type(), .reg = *r});
@@ -162,9 +214,9 @@ void Compiler::EmitDestroy(type::Typed<ir::Reg, type::Array> const &r) {
       });
       builder().ReturnJump();
     }
-    context().root().WriteByteCode(fn);
     // TODO: Remove const_cast.
     const_cast<type::Array *>(r.type())->SetDestructor(fn);
+    context().root().WriteByteCode(fn);
   }
   current_block()->Append(ir::DestroyInstruction{.type = r.type(), .reg = *r});
 }
@@ -183,10 +235,10 @@ void SetArrayInits(Compiler &c, type::Array const *array_type) {
       EmitArrayInit<Move>(c, array_type, array_type);
     }
 
-    c.context().root().WriteByteCode(copy_fn);
-    c.context().root().WriteByteCode(move_fn);
     // TODO: Remove const_cast.
     const_cast<type::Array *>(array_type)->SetInits(copy_fn, move_fn);
+    c.context().root().WriteByteCode(copy_fn);
+    c.context().root().WriteByteCode(move_fn);
   }
 }
 
@@ -204,16 +256,21 @@ void SetArrayAssignments(Compiler &c, type::Array const *array_type) {
       EmitArrayAssignment<Move>(c, array_type, array_type);
     }
 
-    c.context().root().WriteByteCode(copy_fn);
-    c.context().root().WriteByteCode(move_fn);
     // TODO: Remove const_cast.
     const_cast<type::Array *>(array_type)->SetAssignments(copy_fn, move_fn);
+    c.context().root().WriteByteCode(copy_fn);
+    c.context().root().WriteByteCode(move_fn);
   }
 }
 
 void Compiler::EmitMoveInit(type::Typed<ir::Reg, type::Array> to,
                             type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitArrayMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                     *to);
+    return;
+  }
   SetArrayInits(*this, to.type());
   current_block()->Append(ir::MoveInitInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
@@ -223,6 +280,11 @@ void Compiler::EmitMoveInit(type::Typed<ir::Reg, type::Array> to,
 void Compiler::EmitCopyInit(type::Typed<ir::Reg, type::Array> to,
                             type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitArrayMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                     *to);
+    return;
+  }
   SetArrayInits(*this, to.type());
   current_block()->Append(ir::CopyInitInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
@@ -233,6 +295,11 @@ void Compiler::EmitCopyAssign(
     type::Typed<ir::RegOr<ir::addr_t>, type::Array> const &to,
     type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitArrayMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                     *to);
+    return;
+  }
   SetArrayAssignments(*this, &to.type()->as<type::Array>());
   builder().Copy(to, type::Typed<ir::Reg>(from->get<ir::Reg>(), from.type()));
 }
@@ -241,6 +308,11 @@ void Compiler::EmitMoveAssign(
     type::Typed<ir::RegOr<ir::addr_t>, type::Array> const &to,
     type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitArrayMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                     *to);
+    return;
+  }
   SetArrayAssignments(*this, &to.type()->as<type::Array>());
   builder().Move(to, type::Typed<ir::Reg>(from->get<ir::Reg>(), from.type()));
 }
@@ -468,6 +540,11 @@ void Compiler::EmitMoveAssign(
 void Compiler::EmitMoveInit(type::Typed<ir::Reg, type::Struct> to,
                             type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitStructMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                      *to);
+    return;
+  }
   current_block()->Append(ir::MoveInitInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
   current_block()->load_store_cache().clear();
@@ -476,6 +553,11 @@ void Compiler::EmitMoveInit(type::Typed<ir::Reg, type::Struct> to,
 void Compiler::EmitCopyInit(type::Typed<ir::Reg, type::Struct> to,
                             type::Typed<ir::Value> const &from) {
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitStructMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                      *to);
+    return;
+  }
   current_block()->Append(ir::CopyInitInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
   current_block()->load_store_cache().clear();
@@ -486,6 +568,11 @@ void Compiler::EmitCopyAssign(
     type::Typed<ir::Value> const &from) {
   // TODO: Support mixed types and user-defined assignments.
   ASSERT(type::Type(to.type()) == from.type());
+  if (CopiesBytes(to.type())) {
+    EmitStructMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                      *to);
+    return;
+  }
   current_block()->Append(ir::CopyInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
   current_block()->load_store_cache().clear();
@@ -494,6 +581,11 @@ void Compiler::EmitCopyAssign(
 void Compiler::EmitMoveAssign(
     type::Typed<ir::RegOr<ir::addr_t>, type::Struct> const &to,
     type::Typed<ir::Value> const &from) {
+  if (CopiesBytes(to.type())) {
+    EmitStructMemCopy(*this, to.type(), from->get<ir::RegOr<ir::addr_t>>(),
+                      *to);
+    return;
+  }
   current_block()->Append(ir::MoveInstruction{
       .type = to.type(), .from = from->get<ir::Reg>(), .to = *to});
   current_block()->load_store_cache().clear();
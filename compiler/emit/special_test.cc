@@ -1,6 +1,10 @@
+#include <thread>
+
+#include "absl/container/flat_hash_set.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/module.h"
+#include "type/array.h"
 #include "type/primitive.h"
 
 namespace compiler {
@@ -125,12 +129,168 @@ INSTANTIATE_TEST_SUITE_P(All, SpecialTest,
                              )",
                                       .expected = ir::Value(int64_t{3})},
 
-                             // TODO: Tests for tuples and arrays
+                             TestCase{.expr     = R"((() -> {
+                               // Test zero-initialization of arrays
+                               a: [3; i64]
+                               return a[2]
+                             })()
+                             )",
+                                      .expected = ir::Value(int64_t{0})},
+
+                             TestCase{.expr     = R"((() -> {
+                               // Test element-wise array initialization
+                               a: [2; S]
+                               return a[1].n
+                             })()
+                             )",
+                                      .expected = ir::Value(int64_t{3})},
+
+                             TestCase{.expr     = R"((() -> {
+                               // Test bulk array copies
+                               a: [3; i64]
+                               a[1] = 4
+                               b := a
+                               b[0] = 7
+                               c: [3; i64]
+                               c = b
+                               return a[0] + c[0] + c[1]
+                             })()
+                             )",
+                                      .expected = ir::Value(int64_t{11})},
+
+                             TestCase{.expr     = R"((() -> {
+                               // Test trivial struct copies
+                               s: S
+                               s.n = 5
+                               t := s
+                               t.n = 9
+                               u: S
+                               u = t
+                               return s.n + u.n
+                             })()
+                             )",
+                                      .expected = ir::Value(int64_t{14})},
+
+                             TestCase{.expr     = R"((() -> {
+                               // Test copies from read-only constants
+                               K ::= [1, 2, 3]
+                               a := K
+                               a[0] = 4
+                               b := K
+                               return a[0] + b[0] + b[2]
+                             })()
+                             )",
+                                      .expected = ir::Value(int64_t{8})},
+
+                             // TODO: Tests for tuples
                              // TODO: Tests for struct destructors, including
                              //       nested in arrays, tuples or other structs.
                              // TODO: Copy/move assignment tests
 
                          }));
 
+TEST(SpecialMembers, SharedAcrossModules) {
+  // Arrays of `type` are neither zero-initializable nor trivially copyable, but
+  // depend on no module, so their special members are synthesized by whichever
+  // module needs them first and then reused by every other module.
+  for (int i = 0; i < 2; ++i) {
+    test::TestModule mod;
+    auto const *e = mod.Append<ast::Expression>(R"((() -> {
+      a: [2; type]
+      a[1] = bool
+      b := a
+      return b[1]
+    })()
+    )");
+    auto t = mod.context().qual_types(e)[0].type();
+    ASSERT_TRUE(t.valid());
+    auto result =
+        mod.compiler.Evaluate(type::Typed<ast::Expression const *>(e, t));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, ir::Value(type::Type(type::Bool)));
+  }
+}
+
+TEST(SpecialMembers, UserDefinedCopiesAreNotMemCopied) {
+  // `S` holds only an integer, so its fields alone would make it trivially
+  // copyable, but its user-defined copy must run for each copied value, whether
+  // on its own or as an array element.
+  constexpr char const kStruct[] = R"(
+  S ::= struct {
+    n := 0
+    (copy) ::= (from: *S) -> S { return S.{ n = from.n + 1 } }
+  }
+  )";
+  for (char const *expr : {
+           R"((() -> i64 {
+             s: S
+             t := copy s
+             return t.n
+           })()
+           )",
+           R"((() -> i64 {
+             a: [2; S]
+             b := copy a
+             return b[1].n
+           })()
+           )",
+       }) {
+    test::TestModule mod;
+    mod.AppendCode(kStruct);
+    auto const *e = mod.Append<ast::Expression>(expr);
+    auto t        = mod.context().qual_types(e)[0].type();
+    ASSERT_TRUE(t.valid());
+    auto result =
+        mod.compiler.Evaluate(type::Typed<ast::Expression const *>(e, t));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, ir::Value(int64_t{1})) << expr;
+  }
+}
+
+TEST(SpecialMembers, OnlyReferencedSharedMembersAreEmitted) {
+  test::TestModule uses_array;
+  auto const *e = uses_array.Append<ast::Expression>(R"((() -> {
+    a: [3; type]
+    b := a
+    return b[0]
+  })()
+  )");
+  auto t = uses_array.context().qual_types(e)[0].type();
+  ASSERT_TRUE(t.valid());
+  ASSERT_TRUE(uses_array.compiler.Evaluate(
+      type::Typed<ast::Expression const *>(e, t)));
+
+  absl::flat_hash_set<ir::CompiledFn const *> referenced;
+  uses_array.context().ForEachCompiledFn(
+      [&](ir::CompiledFn const *fn) { referenced.insert(fn); });
+
+  test::TestModule unrelated;
+  unrelated.AppendCode(R"(
+  g ::= () -> i64 { return 3 }
+  )");
+  unrelated.context().ForEachCompiledFn(
+      [&](ir::CompiledFn const *fn) { EXPECT_FALSE(referenced.contains(fn)); });
+}
+
+TEST(SpecialMembers, AbandonedSharedMembersWakeWaiters) {
+  type::Type t = type::Arr(5, type::Arr(7, type::Type_));
+  test::TestModule inserter;
+  auto [fn, inserted] = inserter.context().InsertInit(t);
+  ASSERT_TRUE(inserted);
+
+  test::TestModule waiter;
+  bool waiter_inserted = false;
+  std::thread thread([&] {
+    auto [waiter_fn, waiter_inserted_fn] = waiter.context().InsertInit(t);
+    waiter_inserted                      = waiter_inserted_fn;
+    waiter.context().AbandonSpecialMember(waiter_fn);
+  });
+  inserter.context().AbandonSpecialMember(fn);
+  thread.join();
+
+  // Whoever waited on the abandoned function must have taken over emitting it.
+  EXPECT_TRUE(waiter_inserted);
+}
+
 }  // namespace
 }  // namespace compiler
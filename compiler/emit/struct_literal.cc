@@ -26,8 +26,10 @@ ir::Value Compiler::EmitValue(ast::StructLiteral const *node) {
   type::Struct *s = type::Allocate<type::Struct>(
       &context().module(),
       type::Struct::Options{
-          .is_copyable = not node->hashtags.contains(ir::Hashtag::Uncopyable),
-          .is_movable  = not node->hashtags.contains(ir::Hashtag::Immovable),
+          .is_copyable =
+              not node->hashtags.contains(ir::Hashtag::Uncopyable),
+          .is_movable = not node->hashtags.contains(ir::Hashtag::Immovable),
+          .reorder_fields = node->hashtags.contains(ir::Hashtag::Compact),
       });
 
   LOG("struct", "Allocating a new struct %p for %p on context %p", s, node,
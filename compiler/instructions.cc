@@ -7,6 +7,7 @@
 #include "ir/interpreter/evaluate.h"
 #include "ir/value/char.h"
 #include "ir/value/value.h"
+#include "opt/pipeline.h"
 #include "type/array.h"
 #include "type/enum.h"
 #include "type/flags.h"
@@ -106,8 +107,11 @@ struct instruction_set_t
           ir::StructIndexInstruction, ir::PtrIncrInstruction,
           ir::TypeInfoInstruction, ir::InitInstruction, ir::DestroyInstruction,
           ir::MoveInitInstruction, ir::CopyInitInstruction, ir::MoveInstruction,
-          ir::CopyInstruction, type::SliceLengthInstruction,
-          type::SliceDataInstruction, ir::DebugIrInstruction,
+          ir::CopyInstruction, ir::MemCopyInstruction, ir::MemSetInstruction,
+          ir::MemCompareInstruction, ir::MallocInstruction,
+          ir::FreeInstruction, type::SliceLengthInstruction,
+          type::SliceDataInstruction,
+          ir::DebugIrInstruction,
           ir::AbortInstruction, TypeConstructorInstructions> {};
 
 void WriteByteCode(ir::ByteCodeWriter& writer, ir::BasicBlock const& block) {
@@ -145,12 +149,17 @@ base::untyped_buffer EmitByteCode(ir::CompiledFn const& fn) {
   return byte_code;
 }
 
-void InterpretAtCompileTime(ir::CompiledFn const& fn) {
-  auto byte_code = EmitByteCode(fn);
+base::untyped_buffer const& ByteCode(ir::CompiledFn& fn) {
+  if (auto const* byte_code = fn.byte_code()) { return *byte_code; }
+  opt::Optimize(&fn);
+  return fn.Finalize(EmitByteCode(fn));
+}
+
+void InterpretAtCompileTime(ir::CompiledFn& fn) {
+  ByteCode(fn);
   ir::NativeFn::Data data{
-      .fn        = &const_cast<ir::CompiledFn&>(fn),
-      .type      = fn.type(),
-      .byte_code = byte_code.begin(),
+      .fn   = &fn,
+      .type = fn.type(),
   };
   InterpretAtCompileTime(ir::NativeFn(&data));
 }
@@ -35,11 +35,16 @@
 namespace compiler {
 
 void InterpretAtCompileTime(ir::NativeFn f);
-void InterpretAtCompileTime(ir::CompiledFn const &fn);
+void InterpretAtCompileTime(ir::CompiledFn &fn);
 base::untyped_buffer EvaluateAtCompileTimeToBuffer(ir::NativeFn fn);
 interpreter::EvaluationResult EvaluateAtCompileTime(ir::NativeFn fn);
 base::untyped_buffer EmitByteCode(ir::CompiledFn const &fn);
 
+// Returns the byte code for `fn`. If `fn` is not yet complete, it is first
+// optimized, and then its byte code is emitted and `fn` is finalized. `fn` must
+// not be modified afterwards.
+base::untyped_buffer const &ByteCode(ir::CompiledFn &fn);
+
 namespace internal_type {
 template <typename T>
 bool Compare(::type::Type t) {
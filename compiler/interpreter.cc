@@ -1,5 +1,6 @@
 #include <dlfcn.h>
 
+#include <cstdio>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -20,6 +21,7 @@
 #include "compiler/executable_module.h"
 #include "compiler/instructions.h"
 #include "compiler/module.h"
+#include "compiler/transient_state.h"
 #include "diagnostic/consumer/streaming.h"
 #include "frontend/parse.h"
 #include "frontend/source/file_name.h"
@@ -34,7 +36,12 @@ ABSL_FLAG(std::vector<std::string>, log, {},
 ABSL_FLAG(std::string, link, "",
           "Library to be dynamically loaded by the compiler to be used "
           "at compile-time. Libraries will not be unloaded.");
-ABSL_FLAG(bool, opt_ir, false, "Optimize intermediate representation.");
+ABSL_FLAG(bool, opt_ir, false,
+          "Also merge and remove trivial blocks and calls in `main`. Every "
+          "function is optimized as it is finalized regardless.");
+ABSL_FLAG(bool, work_queue_stats, false,
+          "Print the number of work items processed, deferred and re-woken "
+          "during compilation to stderr.");
 ABSL_FLAG(std::vector<std::string>, module_paths, {},
           "Comma-separated list of paths to search when importing modules. "
           "Defaults to $ICARUS_MODULE_PATH.");
@@ -80,6 +87,10 @@ int Interpret(frontend::FileName const &file_name) {
   if (absl::GetFlag(FLAGS_opt_ir)) { opt::RunAllOptimizations(&main_fn); }
   InterpretAtCompileTime(main_fn);
 
+  if (absl::GetFlag(FLAGS_work_queue_stats)) {
+    std::fputs(WorkQueueReport().c_str(), stderr);
+  }
+
   return 0;
 }
 
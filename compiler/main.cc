@@ -1,10 +1,19 @@
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/debugging/failure_signal_handler.h"
 #include "absl/debugging/symbolize.h"
 #include "absl/flags/flag.h"
@@ -12,13 +21,16 @@
 #include "absl/flags/usage.h"
 #include "absl/flags/usage_config.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
+#include "backend/baseline.h"
 #include "backend/llvm.h"
 #include "base/log.h"
 #include "base/no_destructor.h"
 #include "base/untyped_buffer.h"
 #include "compiler/executable_module.h"
 #include "compiler/module.h"
+#include "compiler/transient_state.h"
 #include "diagnostic/consumer/streaming.h"
 #include "frontend/parse.h"
 #include "frontend/source/file_name.h"
@@ -26,12 +38,20 @@
 #include "ir/compiled_fn.h"
 #include "ir/interpreter/execution_context.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Analysis/CGSCCPassManager.h"
+#include "llvm/Analysis/LoopAnalysisManager.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/CodeGen.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
@@ -54,6 +74,28 @@ ABSL_FLAG(
     "Name of the output file to which the generated output should be written.");
 ABSL_FLAG(std::vector<std::string>, implicitly_embedded_modules, {},
           "Comma-separated list of modules that are embedded implicitly.");
+ABSL_FLAG(int, O, 0,
+          "Optimization level (0-3) used when generating object files. May "
+          "also be spelled -O0, -O1, -O2, or -O3.");
+ABSL_FLAG(std::string, cpu, "generic",
+          "The CPU for which code should be generated. \"native\" selects "
+          "the host CPU and enables each feature it supports.");
+ABSL_FLAG(int, codegen_partitions, 1,
+          "Number of partitions into which generated code is split. Each "
+          "partition is optimized and compiled on its own thread. Partition 0 "
+          "is written to --output and each partition i > 0 is written to "
+          "<output>.i. All of these object files must be linked together.");
+ABSL_FLAG(std::string, backend, "llvm",
+          "The code generator used to produce object files. \"llvm\" "
+          "optimizes through LLVM. \"baseline\" emits unoptimized x86-64 "
+          "machine code directly, which is much faster to generate, and "
+          "ignores --O, --cpu, and --codegen_partitions.");
+ABSL_FLAG(bool, work_queue_stats, false,
+          "Print the number of work items processed, deferred and re-woken "
+          "during compilation to stderr.");
+ABSL_FLAG(int, error_limit, 100,
+          "Maximum number of diagnostics printed per module. Further "
+          "diagnostics are counted but not printed. 0 means no limit.");
 
 namespace compiler {
 namespace {
@@ -70,15 +112,123 @@ struct InvalidTargetTriple {
   std::string message;
 };
 
-int CompileToObjectFile(ExecutableModule const &module,
-                        llvm::TargetMachine *target_machine) {
+struct InvalidOptimizationLevel {
+  static constexpr std::string_view kCategory = "option-error";
+  static constexpr std::string_view kName     = "invalid-optimization-level";
+
+  diagnostic::DiagnosticMessage ToMessage(frontend::Source const *src) const {
+    return diagnostic::DiagnosticMessage(diagnostic::Text(
+        "Invalid optimization level %d. Must be between 0 and 3.", level));
+  }
+
+  int level;
+};
+
+llvm::CodeGenOpt::Level CodeGenOptLevel(int level) {
+  switch (level) {
+    case 0: return llvm::CodeGenOpt::None;
+    case 1: return llvm::CodeGenOpt::Less;
+    case 2: return llvm::CodeGenOpt::Default;
+    default: return llvm::CodeGenOpt::Aggressive;
+  }
+}
+
+// Returns the CPU name and feature string with which to configure the target
+// machine for `--cpu=<cpu>`.
+std::pair<std::string, std::string> CpuAndFeatures(std::string const &cpu) {
+  if (cpu != "native") { return {cpu, ""}; }
+  llvm::SubtargetFeatures features;
+  llvm::StringMap<bool> host_features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    for (auto const &feature : host_features) {
+      features.AddFeature(feature.first(), feature.second);
+    }
+  }
+  return {llvm::sys::getHostCPUName().str(), features.getString()};
+}
+
+// Runs LLVM's default mid-level optimization pipeline for `level` over
+// `llvm_module`. At level 0 the module is left untouched.
+void OptimizeModule(llvm::Module &llvm_module,
+                    llvm::TargetMachine *target_machine, int level) {
+  if (level == 0) { return; }
+  llvm::PipelineTuningOptions tuning_options;
+  tuning_options.LoopVectorization = level >= 2;
+  tuning_options.SLPVectorization  = level >= 2;
+
+  llvm::PassBuilder pass_builder(target_machine, tuning_options);
+  llvm::LoopAnalysisManager loop_analyses;
+  llvm::FunctionAnalysisManager function_analyses;
+  llvm::CGSCCAnalysisManager cgscc_analyses;
+  llvm::ModuleAnalysisManager module_analyses;
+  pass_builder.registerModuleAnalyses(module_analyses);
+  pass_builder.registerCGSCCAnalyses(cgscc_analyses);
+  pass_builder.registerFunctionAnalyses(function_analyses);
+  pass_builder.registerLoopAnalyses(loop_analyses);
+  pass_builder.crossRegisterProxies(loop_analyses, function_analyses,
+                                    cgscc_analyses, module_analyses);
+
+  using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+  OptimizationLevel optimization_level = level == 1   ? OptimizationLevel::O1
+                                         : level == 2 ? OptimizationLevel::O2
+                                                      : OptimizationLevel::O3;
+  llvm::ModulePassManager passes =
+      pass_builder.buildPerModuleDefaultPipeline(optimization_level);
+  passes.run(llvm_module, module_analyses);
+}
+
+using TargetMachineFactory =
+    std::function<std::unique_ptr<llvm::TargetMachine>()>;
+
+// Splits the functions of `module` into `num_partitions` sets of roughly equal
+// size, measured in instructions. The module's `main` function is always
+// emitted with the first partition.
+std::vector<absl::flat_hash_set<ir::CompiledFn const *>> PartitionFunctions(
+    ExecutableModule const &module, int num_partitions) {
+  auto size = [](ir::CompiledFn const &fn) {
+    size_t n = 0;
+    for (auto const *block : fn.blocks()) { n += block->instructions().size(); }
+    return n;
+  };
+
+  std::vector<std::pair<size_t, ir::CompiledFn const *>> fns;
+  module.context().ForEachCompiledFn(
+      [&](ir::CompiledFn const *fn) { fns.emplace_back(size(*fn), fn); });
+  std::stable_sort(fns.begin(), fns.end(), [](auto const &l, auto const &r) {
+    return l.first > r.first;
+  });
+
+  std::vector<absl::flat_hash_set<ir::CompiledFn const *>> partitions(
+      num_partitions);
+  std::vector<size_t> partition_sizes(num_partitions, 0);
+  partition_sizes[0] = size(module.main());
+  for (auto [fn_size, fn] : fns) {
+    size_t smallest = std::min_element(partition_sizes.begin(),
+                                       partition_sizes.end()) -
+                      partition_sizes.begin();
+    partitions[smallest].insert(fn);
+    partition_sizes[smallest] += fn_size;
+  }
+  return partitions;
+}
+
+// Emits, optimizes, and compiles to `output` those functions of `module` which
+// are in `partition`. Every other function is declared so that it may be
+// referenced. Each partition has its own `llvm::LLVMContext` and target
+// machine, so partitions may be compiled concurrently.
+int CompilePartition(
+    ExecutableModule const &module,
+    absl::flat_hash_set<ir::CompiledFn const *> const &partition,
+    bool emit_main, std::optional<module::Linkage> linkage,
+    TargetMachineFactory const &make_target_machine, int opt_level,
+    std::string const &output) {
+  std::unique_ptr<llvm::TargetMachine> target_machine = make_target_machine();
   llvm::LLVMContext context;
   llvm::Module llvm_module("module", context);
   llvm_module.setDataLayout(target_machine->createDataLayout());
 
   std::error_code error_code;
-  llvm::raw_fd_ostream destination(absl::GetFlag(FLAGS_output), error_code,
-                                   llvm::sys::fs::OF_None);
+  llvm::raw_fd_ostream destination(output, error_code, llvm::sys::fs::OF_None);
   llvm::legacy::PassManager pass;
   auto file_type = llvm::LLVMTargetMachine::CGFT_ObjectFile;
 
@@ -94,16 +244,68 @@ int CompileToObjectFile(ExecutableModule const &module,
 
   backend::LlvmEmitter emitter(builder, &llvm_module);
 
-  emitter.EmitModule(module);
-  auto *f = emitter.EmitFunction(&module.main(), module::Linkage::External);
-  f->setName("main");
+  emitter.EmitModule(
+      module, [&](ir::CompiledFn const *fn) { return partition.contains(fn); },
+      linkage);
+  if (emit_main) {
+    auto *f = emitter.EmitFunction(&module.main(), module::Linkage::External);
+    f->setName("main");
+  }
 
+  OptimizeModule(llvm_module, target_machine.get(), opt_level);
   pass.run(llvm_module);
 
   destination.flush();
   return 0;
 }
 
+int CompileToObjectFile(ExecutableModule const &module,
+                        TargetMachineFactory const &make_target_machine,
+                        int opt_level, int num_partitions) {
+  std::string const output = absl::GetFlag(FLAGS_output);
+  if (num_partitions <= 1) {
+    return CompilePartition(
+        module, PartitionFunctions(module, 1)[0], /*emit_main=*/true,
+        std::nullopt, make_target_machine, opt_level, output);
+  }
+
+  // Functions defined in one partition may be called from another, so every
+  // function must be externally visible.
+  auto partitions = PartitionFunctions(module, num_partitions);
+  std::vector<int> results(num_partitions);
+  std::vector<std::thread> threads;
+  threads.reserve(num_partitions);
+  for (int i = 0; i < num_partitions; ++i) {
+    threads.emplace_back([&, i] {
+      results[i] = CompilePartition(
+          module, partitions[i], /*emit_main=*/i == 0,
+          module::Linkage::External, make_target_machine, opt_level,
+          i == 0 ? output : absl::StrCat(output, ".", i));
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  return std::accumulate(results.begin(), results.end(), 0);
+}
+
+int CompileWithBaseline(ExecutableModule const &module) {
+  backend::BaselineModule baseline_module;
+  backend::BaselineEmitter emitter(&baseline_module);
+  emitter.EmitModule(module);
+  emitter.EmitFunction(&module.main(), module::Linkage::External)->name =
+      "main";
+
+  std::ofstream output(absl::GetFlag(FLAGS_output),
+                       std::ios::out | std::ios::binary);
+  output << baseline_module.ObjectFile();
+  return output.good() ? 0 : 1;
+}
+
+size_t ErrorLimit() {
+  int limit = absl::GetFlag(FLAGS_error_limit);
+  return limit <= 0 ? diagnostic::ConsoleRenderer::kUnlimited
+                    : static_cast<size_t>(limit);
+}
+
 int Compile(frontend::FileName const &file_name) {
   llvm::InitializeAllTargetInfos();
   llvm::InitializeAllTargets();
@@ -132,15 +334,24 @@ int Compile(frontend::FileName const &file_name) {
     return 1;
   }
 
-  char const cpu[]      = "generic";
-  char const features[] = "";
-  llvm::TargetOptions target_options;
-  llvm::Optional<llvm::Reloc::Model> relocation_model;
-  llvm::TargetMachine *target_machine = target->createTargetMachine(
-      target_triple, cpu, features, target_options, relocation_model);
+  int opt_level = absl::GetFlag(FLAGS_O);
+  if (opt_level < 0 or opt_level > 3) {
+    diag.Consume(InvalidOptimizationLevel{.level = opt_level});
+    return 1;
+  }
+
+  auto [cpu, features] = CpuAndFeatures(absl::GetFlag(FLAGS_cpu));
+  TargetMachineFactory make_target_machine = [&, cpu = cpu,
+                                              features = features] {
+    llvm::TargetOptions target_options;
+    llvm::Optional<llvm::Reloc::Model> relocation_model;
+    return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+        target_triple, cpu, features, target_options, relocation_model,
+        llvm::None, CodeGenOptLevel(opt_level)));
+  };
 
   auto *src = &*maybe_file_src;
-  diag      = diagnostic::StreamingConsumer(stderr, src);
+  diag      = diagnostic::StreamingConsumer(stderr, src, ErrorLimit());
   module::FileImporter<LibraryModule> importer;
   importer.module_lookup_paths = absl::GetFlag(FLAGS_module_paths);
   if (not importer.SetImplicitlyEmbeddedModules(
@@ -149,15 +360,23 @@ int Compile(frontend::FileName const &file_name) {
   }
 
   compiler::ExecutableModule exec_mod;
-  exec_mod.set_diagnostic_consumer<diagnostic::StreamingConsumer>(stderr, src);
+  exec_mod.set_diagnostic_consumer<diagnostic::StreamingConsumer>(
+      stderr, src, ErrorLimit());
   for (ir::ModuleId embedded_id : importer.implicitly_embedded_modules()) {
     exec_mod.embed(importer.get(embedded_id));
   }
 
   exec_mod.AppendNodes(frontend::Parse(src->buffer(), diag), diag, importer);
+  if (absl::GetFlag(FLAGS_work_queue_stats)) {
+    std::fputs(WorkQueueReport().c_str(), stderr);
+  }
   if (diag.num_consumed() != 0) { return 1; }
 
-  return CompileToObjectFile(exec_mod, target_machine);
+  if (absl::GetFlag(FLAGS_backend) == "baseline") {
+    return CompileWithBaseline(exec_mod);
+  }
+  return CompileToObjectFile(exec_mod, make_target_machine, opt_level,
+                             absl::GetFlag(FLAGS_codegen_partitions));
 }
 
 }  // namespace
@@ -178,6 +397,22 @@ int main(int argc, char *argv[]) {
   flag_config.contains_help_flags      = &HelpFilter;
   absl::SetFlagsUsageConfig(flag_config);
   absl::SetProgramUsageMessage("Icarus compiler");
+
+  // Accept the conventional spelling of optimization levels (e.g., "-O2") by
+  // rewriting them as "--O=2" before parsing flags.
+  std::vector<std::string> rewritten_opt_levels;
+  rewritten_opt_levels.reserve(argc);
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--") { break; }
+    if (arg.size() == 3 and absl::StartsWith(arg, "-O") and
+        arg[2] >= '0' and arg[2] <= '9') {
+      int level = arg[2] - '0';
+      std::string &flag =
+          rewritten_opt_levels.emplace_back(absl::StrCat("--O=", level));
+      argv[i] = flag.data();
+    }
+  }
   std::vector<char *> args = absl::ParseCommandLine(argc, argv);
   absl::InitializeSymbolizer(args[0]);
   absl::FailureSignalHandlerOptions opts;
@@ -188,6 +423,18 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
+  if (std::string backend = absl::GetFlag(FLAGS_backend);
+      backend != "llvm" and backend != "baseline") {
+    std::cerr << "--backend must be either \"llvm\" or \"baseline\".";
+    return 1;
+  }
+#if not(defined(__x86_64__) and defined(__ELF__))
+  if (absl::GetFlag(FLAGS_backend) == "baseline") {
+    std::cerr << "--backend=baseline is only supported on x86-64 ELF hosts.";
+    return 1;
+  }
+#endif
+
   std::vector<std::string> log_keys = absl::GetFlag(FLAGS_log);
   for (absl::string_view key : log_keys) { base::EnableLogging(key); }
 
@@ -0,0 +1,82 @@
+#ifndef ICARUS_COMPILER_NODE_TABLE_H
+#define ICARUS_COMPILER_NODE_TABLE_H
+
+#include <deque>
+#include <optional>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "ast/node.h"
+
+namespace compiler {
+
+// NodeTable:
+//
+// Associates a value with syntax tree nodes of type `N`. A dense table stores
+// values in a deque indexed by `ast::Node::index()`, so that lookups require no
+// hashing. This is appropriate for the root context of a module, which holds
+// data for nearly every node in the module. A sparse table stores values in a
+// hash map keyed on the node, which is appropriate for subcontexts holding data
+// only for the few nodes dependent on some generic parameters. Node indices are
+// only unique within a module, so nodes that are unindexed or whose slot is
+// already taken by a node from another module fall back to the hash map even
+// in a dense table.
+//
+// As with `absl::flat_hash_map`, pointers to values are not stable.
+template <typename N, typename V>
+struct NodeTable {
+  explicit NodeTable(bool dense) : dense_(dense) {}
+
+  // Returns a pointer to the value associated with `node` if one exists and a
+  // null pointer otherwise.
+  V const *find(N const *node) const {
+    if (dense_ and node->index() != ast::Node::kUnindexed) {
+      if (node->index() >= entries_.size()) { return nullptr; }
+      Entry const &entry = entries_[node->index()];
+      if (entry.node == node) { return &*entry.value; }
+      if (entry.node == nullptr) { return nullptr; }
+    }
+    if (sparse_.empty()) { return nullptr; }
+    auto iter = sparse_.find(node);
+    return iter == sparse_.end() ? nullptr : &iter->second;
+  }
+  V *find(N const *node) {
+    return const_cast<V *>(std::as_const(*this).find(node));
+  }
+
+  // Constructs a value associated with `node` from `args` if no such value
+  // already exists. Returns a pointer to the value associated with `node` and
+  // a bool indicating whether an insertion took place.
+  template <typename... Args>
+  std::pair<V *, bool> try_emplace(N const *node, Args &&... args) {
+    if (dense_ and node->index() != ast::Node::kUnindexed) {
+      if (node->index() >= entries_.size()) {
+        entries_.resize(node->index() + 1);
+      }
+      Entry &entry = entries_[node->index()];
+      if (entry.node == node) { return std::pair(&*entry.value, false); }
+      if (entry.node == nullptr) {
+        entry.node = node;
+        entry.value.emplace(std::forward<Args>(args)...);
+        return std::pair(&*entry.value, true);
+      }
+    }
+    auto [iter, inserted] =
+        sparse_.try_emplace(node, std::forward<Args>(args)...);
+    return std::pair(&iter->second, inserted);
+  }
+
+ private:
+  struct Entry {
+    N const *node = nullptr;
+    std::optional<V> value;
+  };
+
+  bool dense_;
+  std::deque<Entry> entries_;
+  absl::flat_hash_map<N const *, V> sparse_;
+};
+
+}  // namespace compiler
+
+#endif  // ICARUS_COMPILER_NODE_TABLE_H
@@ -0,0 +1,72 @@
+#include "compiler/node_table.h"
+
+#include "ast/ast.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace compiler {
+namespace {
+
+using ::testing::IsNull;
+using ::testing::Pointee;
+
+TEST(NodeTable, Unindexed) {
+  ast::Identifier a(frontend::SourceRange(), "a");
+  ast::Identifier b(frontend::SourceRange(), "b");
+  ASSERT_EQ(a.index(), ast::Node::kUnindexed);
+
+  for (bool dense : {false, true}) {
+    NodeTable<ast::Identifier, int> table(dense);
+    EXPECT_THAT(table.find(&a), IsNull());
+
+    auto [value, inserted] = table.try_emplace(&a, 3);
+    EXPECT_TRUE(inserted);
+    EXPECT_THAT(value, Pointee(3));
+    EXPECT_THAT(table.find(&a), Pointee(3));
+    EXPECT_THAT(table.find(&b), IsNull());
+  }
+}
+
+TEST(NodeTable, Indexed) {
+  ast::Identifier a(frontend::SourceRange(), "a");
+  ast::Identifier b(frontend::SourceRange(), "b");
+  ast::Node::Initializer initializer;
+  a.Initialize(initializer);
+  b.Initialize(initializer);
+  ASSERT_EQ(a.index(), 0u);
+  ASSERT_EQ(b.index(), 1u);
+
+  for (bool dense : {false, true}) {
+    NodeTable<ast::Identifier, int> table(dense);
+    EXPECT_THAT(table.find(&b), IsNull());
+
+    EXPECT_TRUE(table.try_emplace(&b, 4).second);
+    EXPECT_THAT(table.find(&a), IsNull());
+    EXPECT_THAT(table.find(&b), Pointee(4));
+
+    auto [value, inserted] = table.try_emplace(&b, 5);
+    EXPECT_FALSE(inserted);
+    EXPECT_THAT(value, Pointee(4));
+  }
+}
+
+TEST(NodeTable, NodesFromDifferentModulesShareAnIndex) {
+  // Node indices are only unique within a module, so these nodes, initialized
+  // separately, have the same index.
+  ast::Identifier a(frontend::SourceRange(), "a");
+  ast::Identifier b(frontend::SourceRange(), "b");
+  ast::Node::Initializer a_initializer, b_initializer;
+  a.Initialize(a_initializer);
+  b.Initialize(b_initializer);
+  ASSERT_EQ(a.index(), b.index());
+
+  NodeTable<ast::Identifier, int> table(/*dense=*/true);
+  EXPECT_TRUE(table.try_emplace(&a, 3).second);
+  EXPECT_THAT(table.find(&b), IsNull());
+  EXPECT_TRUE(table.try_emplace(&b, 4).second);
+  EXPECT_THAT(table.find(&a), Pointee(3));
+  EXPECT_THAT(table.find(&b), Pointee(4));
+}
+
+}  // namespace
+}  // namespace compiler
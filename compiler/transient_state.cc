@@ -0,0 +1,43 @@
+#include "compiler/transient_state.h"
+
+#include <atomic>
+
+#include "absl/strings/str_format.h"
+
+namespace compiler {
+namespace {
+
+struct TotalStatistics {
+  std::atomic<size_t> processed{0};
+  std::atomic<size_t> deferred{0};
+  std::atomic<size_t> rewoken{0};
+};
+
+TotalStatistics totals;
+
+}  // namespace
+
+void WorkQueue::Count(size_t Stats::*counter) {
+  ++(stats_.*counter);
+  std::atomic<size_t> &total = counter == &Stats::processed  ? totals.processed
+                               : counter == &Stats::deferred ? totals.deferred
+                                                             : totals.rewoken;
+  total.fetch_add(1, std::memory_order_relaxed);
+}
+
+WorkQueue::Stats WorkQueue::TotalStats() {
+  return Stats{
+      .processed = totals.processed.load(std::memory_order_relaxed),
+      .deferred  = totals.deferred.load(std::memory_order_relaxed),
+      .rewoken   = totals.rewoken.load(std::memory_order_relaxed),
+  };
+}
+
+std::string WorkQueueReport() {
+  WorkQueue::Stats stats = WorkQueue::TotalStats();
+  return absl::StrFormat(
+      "work queue: %d processed, %d deferred, %d rewoken\n", stats.processed,
+      stats.deferred, stats.rewoken);
+}
+
+}  // namespace compiler
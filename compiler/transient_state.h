@@ -2,9 +2,11 @@
 #define ICARUS_COMPILER_TRANSIENT_STATE_H
 
 #include <iterator>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/span.h"
 #include "ast/ast.h"
 #include "compiler/resources.h"
@@ -26,30 +28,70 @@ struct WorkItem {
     EmitJumpBody,
   };
 
-  Result Process() const;
+  // Processes this work item. If the item is deferred until some type is no
+  // longer incomplete, that type is written to `*awaited`; otherwise
+  // `*awaited` is set to null.
+  Result Process(type::LegacyType const **awaited) const;
 
   Kind kind;
   ast::Node const *node;
   PersistentResources &resources;
 };
 
+// A queue of work items. Items which are deferred are parked until what they
+// are waiting on resolves rather than being retried immediately, so that
+// modules with many mutually referencing structs do not repeatedly re-process
+// items which cannot yet make progress.
 struct WorkQueue {
-  bool empty() const { return items_.empty(); }
+  struct Stats {
+    // Number of times an item was processed, whatever the result.
+    size_t processed = 0;
+    // Number of times an item was deferred.
+    size_t deferred = 0;
+    // Number of times a deferred item was made ready to be processed again.
+    size_t rewoken = 0;
+  };
+
+  bool empty() const { return items_.empty() and waiting_.empty(); }
 
   void Enqueue(WorkItem item) { items_.push(std::move(item)); }
 
   void ProcessOneItem();
 
+  Stats const &stats() const { return stats_; }
+
+  // Returns the statistics accumulated over every work queue in the process.
+  static Stats TotalStats();
+
  private:
-  bool Process(WorkItem const &item);
+  // Increments `counter` both in the statistics of this queue and in the
+  // process-wide totals.
+  void Count(size_t Stats::*counter);
+
+  // Makes ready every waiting item whose awaited type is no longer incomplete.
+  // If `all` is true, every waiting item is made ready regardless.
+  void Wake(bool all);
 
   std::queue<WorkItem> items_;
 
+  // Deferred items, keyed on the type they are waiting on. Items deferred for
+  // some other reason are keyed on null and only made ready once every ready
+  // item has been processed.
+  absl::flat_hash_map<type::LegacyType const *, std::vector<WorkItem>>
+      waiting_;
+
+  Stats stats_;
+
 #if defined(ICARUS_DEBUG)
-  size_t cycle_breaker_count_ = 0;
+  // Whether any item has completed since every waiting item was last made
+  // ready. If not, waking them all again would loop forever.
+  bool progressed_ = true;
 #endif
 };
 
+// Returns a human-readable summary of `WorkQueue::TotalStats()`.
+std::string WorkQueueReport();
+
 // Compiler state that needs to be tracked during the compilation of a single
 // function or jump, but otherwise does not need to be saved.
 struct TransientState {
@@ -75,6 +117,9 @@ struct TransientState {
   absl::flat_hash_map<ast::YieldStmt const *, core::Arguments<ir::Value>>
       yields;
   bool must_complete = true;
+
+  // The incomplete type the most recently deferred work item is waiting on.
+  type::LegacyType const *awaited = nullptr;
 };
 
 }  // namespace compiler
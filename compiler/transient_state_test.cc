@@ -0,0 +1,39 @@
+#include "compiler/transient_state.h"
+
+#include "compiler/compiler.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/module.h"
+
+namespace compiler {
+namespace {
+
+using ::testing::IsEmpty;
+
+TEST(WorkQueue, MutuallyDependentItemsAreParkedRatherThanRetried) {
+  WorkQueue::Stats before = WorkQueue::TotalStats();
+
+  // The bodies of `f` and `g` cannot be verified until both `A` and `B` are
+  // complete, and each struct refers to the other.
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  f ::= (a: A) -> *B { return a.b_ptr }
+  g ::= (b: B) -> *A { return b.a_ptr }
+  A ::= struct { b_ptr: *B }
+  B ::= struct { a_ptr: *A }
+  )");
+  mod.compiler.CompleteWorkQueue();
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+
+  WorkQueue::Stats after = WorkQueue::TotalStats();
+  size_t deferred        = after.deferred - before.deferred;
+  size_t rewoken         = after.rewoken - before.rewoken;
+
+  // Each deferred item is parked until what it awaits is complete and then
+  // woken exactly once, so neither function body is deferred more than once.
+  EXPECT_EQ(rewoken, deferred);
+  EXPECT_LE(deferred, 2u);
+}
+
+}  // namespace
+}  // namespace compiler
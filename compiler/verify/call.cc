@@ -377,6 +377,140 @@ type::QualType VerifyAbortCall(
   return qt;
 }
 
+// Diagnoses calls to the built-in function `name` which do not pass exactly
+// `num_args` positional arguments.
+bool VerifyBuiltinArity(
+    Compiler *c, frontend::SourceRange const &range, std::string_view name,
+    size_t num_args, core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  if (not arg_vals.named().empty()) {
+    c->diag().Consume(BuiltinError{
+        .range   = range,
+        .message = absl::StrCat("Built-in function `", name,
+                                "` cannot be called with named arguments."),
+    });
+    return false;
+  }
+
+  if (size_t size = arg_vals.size(); size != num_args) {
+    c->diag().Consume(BuiltinError{
+        .range   = range,
+        .message = absl::StrCat("Built-in function `", name, "` takes exactly ",
+                                num_args, " argument(s) (You provided ", size,
+                                ")."),
+    });
+    return false;
+  }
+  return true;
+}
+
+// Diagnoses arguments to the built-in function `name` which are not pointers.
+bool VerifyPointerArgument(
+    Compiler *c, frontend::SourceRange const &range, std::string_view name,
+    size_t index, core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  if (arg_vals[index].type().is<type::Pointer>()) { return true; }
+  c->diag().Consume(BuiltinError{
+      .range   = range,
+      .message = absl::StrCat("Argument ", index + 1, " to `", name,
+                              "` must be a pointer (You provided a(n) ",
+                              arg_vals[index].type().to_string(), ")."),
+  });
+  return false;
+}
+
+// Diagnoses arguments to the built-in function `name` which are not of type
+// `t`.
+bool VerifyArgumentType(
+    Compiler *c, frontend::SourceRange const &range, std::string_view name,
+    size_t index, type::Type t,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  if (arg_vals[index].type() == t) { return true; }
+  c->diag().Consume(BuiltinError{
+      .range   = range,
+      .message = absl::StrCat("Argument ", index + 1, " to `", name,
+                              "` must be a(n) `", t.to_string(),
+                              "` (You provided a(n) ",
+                              arg_vals[index].type().to_string(), ")."),
+  });
+  return false;
+}
+
+type::QualType VerifyMemCopyCall(
+    Compiler *c, frontend::SourceRange const &range,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  auto qt = type::QualType::NonConstant(type::Void);
+  if (not VerifyBuiltinArity(c, range, "builtin_memcpy", 3, arg_vals)) {
+    qt.MarkError();
+    return qt;
+  }
+  bool ok = VerifyPointerArgument(c, range, "builtin_memcpy", 0, arg_vals);
+  ok &= VerifyPointerArgument(c, range, "builtin_memcpy", 1, arg_vals);
+  ok &= VerifyArgumentType(c, range, "builtin_memcpy", 2, type::U64, arg_vals);
+  if (not ok) { qt.MarkError(); }
+  return qt;
+}
+
+type::QualType VerifyMemSetCall(
+    Compiler *c, frontend::SourceRange const &range,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  auto qt = type::QualType::NonConstant(type::Void);
+  if (not VerifyBuiltinArity(c, range, "builtin_memset", 3, arg_vals)) {
+    qt.MarkError();
+    return qt;
+  }
+  bool ok = VerifyPointerArgument(c, range, "builtin_memset", 0, arg_vals);
+  ok &= VerifyArgumentType(c, range, "builtin_memset", 1, type::U8, arg_vals);
+  ok &= VerifyArgumentType(c, range, "builtin_memset", 2, type::U64, arg_vals);
+  if (not ok) { qt.MarkError(); }
+  return qt;
+}
+
+type::QualType VerifyMemCompareCall(
+    Compiler *c, frontend::SourceRange const &range,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  auto qt = type::QualType::NonConstant(type::I32);
+  if (not VerifyBuiltinArity(c, range, "builtin_memcmp", 3, arg_vals)) {
+    qt.MarkError();
+    return qt;
+  }
+  bool ok = VerifyPointerArgument(c, range, "builtin_memcmp", 0, arg_vals);
+  ok &= VerifyPointerArgument(c, range, "builtin_memcmp", 1, arg_vals);
+  ok &= VerifyArgumentType(c, range, "builtin_memcmp", 2, type::U64, arg_vals);
+  if (not ok) { qt.MarkError(); }
+  return qt;
+}
+
+type::QualType VerifyMallocCall(
+    Compiler *c, frontend::SourceRange const &range,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  if (not VerifyBuiltinArity(c, range, "builtin_malloc", 2, arg_vals)) {
+    return type::QualType::Error();
+  }
+  bool ok =
+      VerifyArgumentType(c, range, "builtin_malloc", 0, type::Type_, arg_vals);
+  ok &= VerifyArgumentType(c, range, "builtin_malloc", 1, type::U64, arg_vals);
+  if (not ok) { return type::QualType::Error(); }
+
+  auto const *t = arg_vals[0]->get_if<type::Type>();
+  if (not t) {
+    c->diag().Consume(BuiltinError{
+        .range   = range,
+        .message = "First argument to `builtin_malloc` must be a constant."});
+    return type::QualType::Error();
+  }
+  return type::QualType::NonConstant(type::BufPtr(*t));
+}
+
+type::QualType VerifyFreeCall(
+    Compiler *c, frontend::SourceRange const &range,
+    core::Arguments<type::Typed<ir::Value>> const &arg_vals) {
+  auto qt = type::QualType::NonConstant(type::Void);
+  if (not VerifyBuiltinArity(c, range, "builtin_free", 1, arg_vals) or
+      not VerifyPointerArgument(c, range, "builtin_free", 0, arg_vals)) {
+    qt.MarkError();
+  }
+  return qt;
+}
+
 }  // namespace
 
 absl::Span<type::QualType const> Compiler::VerifyType(ast::Call const *node) {
@@ -434,6 +568,21 @@ not_an_interface:
       case ir::BuiltinFn::Which::Abort: {
         qt = VerifyAbortCall(this, b->range(), arg_vals);
       } break;
+      case ir::BuiltinFn::Which::MemCopy: {
+        qt = VerifyMemCopyCall(this, b->range(), arg_vals);
+      } break;
+      case ir::BuiltinFn::Which::MemSet: {
+        qt = VerifyMemSetCall(this, b->range(), arg_vals);
+      } break;
+      case ir::BuiltinFn::Which::MemCompare: {
+        qt = VerifyMemCompareCall(this, b->range(), arg_vals);
+      } break;
+      case ir::BuiltinFn::Which::Malloc: {
+        qt = VerifyMallocCall(this, b->range(), arg_vals);
+      } break;
+      case ir::BuiltinFn::Which::Free: {
+        qt = VerifyFreeCall(this, b->range(), arg_vals);
+      } break;
       case ir::BuiltinFn::Which::DebugIr: {
         // This is for debugging the compiler only, so there's no need to
         // write decent errors here.
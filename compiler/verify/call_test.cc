@@ -258,6 +258,79 @@ TEST(BuiltinAlignment, WrongType) {
               UnorderedElementsAre(Pair("type-error", "builtin-error")));
 }
 
+TEST(BuiltinMemCopy, Success) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  p: [*]u8
+  q: *i64
+  )");
+  auto const *call  = mod.Append<ast::Call>("builtin_memcpy(p, q, 8 as u64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_EQ(qt, type::QualType::NonConstant(type::Void));
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
+TEST(BuiltinMemCopy, NonPointer) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  p: [*]u8
+  )");
+  auto const *call  = mod.Append<ast::Call>("builtin_memcpy(p, 3, 8 as u64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_TRUE(qt.HasErrorMark());
+  EXPECT_THAT(mod.consumer.diagnostics(),
+              UnorderedElementsAre(Pair("type-error", "builtin-error")));
+}
+
+TEST(BuiltinMemSet, WrongValueType) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  p: [*]u8
+  )");
+  auto const *call  = mod.Append<ast::Call>("builtin_memset(p, 0, 8 as u64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_TRUE(qt.HasErrorMark());
+  EXPECT_THAT(mod.consumer.diagnostics(),
+              UnorderedElementsAre(Pair("type-error", "builtin-error")));
+}
+
+TEST(BuiltinMemCompare, Success) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  p: [*]u8
+  )");
+  auto const *call  = mod.Append<ast::Call>("builtin_memcmp(p, p, 8 as u64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_EQ(qt, type::QualType::NonConstant(type::I32));
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
+TEST(BuiltinMalloc, Success) {
+  test::TestModule mod;
+  auto const *call  = mod.Append<ast::Call>("builtin_malloc(i64, 3 as u64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_EQ(qt, type::QualType::NonConstant(type::BufPtr(type::I64)));
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
+TEST(BuiltinMalloc, TooFewArguments) {
+  test::TestModule mod;
+  auto const *call  = mod.Append<ast::Call>("builtin_malloc(i64)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_EQ(qt, type::QualType::Error());
+  EXPECT_THAT(mod.consumer.diagnostics(),
+              UnorderedElementsAre(Pair("type-error", "builtin-error")));
+}
+
+TEST(BuiltinFree, NonPointer) {
+  test::TestModule mod;
+  auto const *call  = mod.Append<ast::Call>("builtin_free(3)");
+  type::QualType qt = mod.context().qual_types(call)[0];
+  EXPECT_TRUE(qt.HasErrorMark());
+  EXPECT_THAT(mod.consumer.diagnostics(),
+              UnorderedElementsAre(Pair("type-error", "builtin-error")));
+}
+
 TEST(Call, Uncallable) {
   test::TestModule mod;
   auto const *call  = mod.Append<ast::Call>("3()");
@@ -354,6 +427,35 @@ TEST(Call, CrossModuleWithADLWithoutExport) {
       UnorderedElementsAre(Pair("type-error", "undeclared-identifier")));
 }
 
+TEST(Call, RepeatedOverloadResolution) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  f ::= (b: bool) => true
+  f ::= (n: i64) => n
+  )");
+  auto const *call1 = mod.Append<ast::Call>("f(1)");
+  auto const *call2 = mod.Append<ast::Call>("f(2)");
+  auto const *call3 = mod.Append<ast::Call>("f(false)");
+  EXPECT_EQ(mod.context().qual_types(call1)[0],
+            type::QualType::NonConstant(type::I64));
+  EXPECT_EQ(mod.context().qual_types(call2)[0],
+            type::QualType::NonConstant(type::I64));
+  EXPECT_EQ(mod.context().qual_types(call3)[0],
+            type::QualType::NonConstant(type::Bool));
+
+  // Each call site records its own selected overload, even when the selection
+  // is reused from an earlier call with the same argument types.
+  auto const &os1 = mod.context().ViableOverloads(call1->callee());
+  auto const &os2 = mod.context().ViableOverloads(call2->callee());
+  auto const &os3 = mod.context().ViableOverloads(call3->callee());
+  ASSERT_EQ(os1.members().size(), 1u);
+  ASSERT_EQ(os2.members().size(), 1u);
+  ASSERT_EQ(os3.members().size(), 1u);
+  EXPECT_EQ(os1.members()[0], os2.members()[0]);
+  EXPECT_NE(os1.members()[0], os3.members()[0]);
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
 struct TestCase {
   std::string context;
   std::string expr;
@@ -418,17 +418,43 @@ Compiler::VerifyCall(
                          core::Params<type::QualType>>>
       overload_params;
 
+  // TODO: Take a type::Typed<ir::Value> instead.
+  type::Quals quals = type::Quals::Const();
+  auto args_qt      = args.Transform([&](auto const &typed_value) {
+    auto qt = typed_value->empty()
+                  ? type::QualType::NonConstant(typed_value.type())
+                  : type::QualType::Constant(typed_value.type());
+    quals &= qt.quals();
+    return qt;
+  });
+
   // TODO: Is it possible that the returned references in `AllOverloads` is
   // invalidated during some computation of `ExtractParams`? Maybe if something
   // else is inserted into the map. I believe not even if something is inserted
   // the iterator into members is still valid because there's an extra layer of
   // indirection in the overload set. Do we really want to rely on this?!
+  absl::Span<ast::Expression const *const> members;
   if (auto const *overloads = context().AllOverloads(call_expr->callee())) {
-    for (auto const *callee : overloads->members()) {
-      type::QualType qt = RetrieveQualTypes(context(), callee)[0];
-      ExtractParams(callee, &qt.type().as<type::Callable>(), args,
-                    overload_params, errors);
-    }
+    members = overloads->members();
+  }
+
+  if (auto const *resolution =
+          context().FindOverloadResolution(members, args_qt)) {
+    LOG("VerifyCall", "Reusing overload resolution");
+    ast::OverloadSet os;
+    os.insert(resolution->callee);
+    context().SetViableOverloads(call_expr->callee(), std::move(os));
+    return resolution->qual_types;
+  }
+
+  // Overload resolution depends only on the types of the arguments unless some
+  // overload is generic, in which case it may depend on their values as well.
+  bool depends_only_on_types = true;
+  for (auto const *callee : members) {
+    type::QualType qt = RetrieveQualTypes(context(), callee)[0];
+    depends_only_on_types &= qt.type().is<type::Function>();
+    ExtractParams(callee, &qt.type().as<type::Callable>(), args,
+                  overload_params, errors);
   }
 
   LOG("VerifyCall", "%u overloads", overload_params.size());
@@ -436,16 +462,6 @@ Compiler::VerifyCall(
   // TODO: Expansion is relevant too.
   std::vector<std::vector<type::Type>> return_types;
 
-  // TODO: Take a type::Typed<ir::Value> instead.
-  type::Quals quals = type::Quals::Const();
-  auto args_qt      = args.Transform([&](auto const &typed_value) {
-    auto qt = typed_value->empty()
-                  ? type::QualType::NonConstant(typed_value.type())
-                  : type::QualType::Constant(typed_value.type());
-    quals &= qt.quals();
-    return qt;
-  });
-
   ast::OverloadSet os;
   for (auto const &expansion : ExpandedArguments(args_qt)) {
     for (auto const &[callee, callable_type, params] : overload_params) {
@@ -506,12 +522,19 @@ Compiler::VerifyCall(
   next_expansion:;
   }
 
-  context().SetViableOverloads(call_expr->callee(), std::move(os));
-
   ASSERT(return_types.size() == 1u);
   std::vector<type::QualType> qts;
   qts.reserve(return_types.front().size());
   for (type::Type t : return_types.front()) { qts.emplace_back(t, quals); }
+
+  if (depends_only_on_types) {
+    context().SetOverloadResolution(members, args_qt,
+                                    Context::OverloadResolution{
+                                        .callee     = os.members()[0],
+                                        .qual_types = qts,
+                                    });
+  }
+  context().SetViableOverloads(call_expr->callee(), std::move(os));
   return qts;
 }
 
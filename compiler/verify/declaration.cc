@@ -444,7 +444,7 @@ absl::Span<type::QualType const> Compiler::VerifyType(
     // TODO: struct field decls shouldn't have issues with shadowing local
     // variables.
     for (auto const *accessible_id :
-         module::AllAccessibleDeclIds(node->scope(), id.name())) {
+         module::AllAccessibleDeclIds(node->scope(), id.symbol())) {
       if (&id == accessible_id) { continue; }
       auto qts = context().maybe_qual_type(accessible_id);
       if (not qts.data()) { continue; }
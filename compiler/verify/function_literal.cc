@@ -275,11 +275,13 @@ WorkItem::Result Compiler::VerifyBody(ast::FunctionLiteral const *node) {
   for (auto const &param : fn_type.params()) {
     if (param.value.type().get()->completeness() ==
         type::Completeness::Incomplete) {
+      state_.awaited = param.value.type().get();
       return WorkItem::Result::Deferred;
     }
   }
   for (type::Type ret : fn_type.return_types()) {
     if (ret.get()->completeness() == type::Completeness::Incomplete) {
+      state_.awaited = ret.get();
       return WorkItem::Result::Deferred;
     }
   }
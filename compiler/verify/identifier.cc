@@ -104,7 +104,7 @@ absl::Span<type::QualType const> Compiler::VerifyType(ast::Identifier const *nod
   std::vector<std::pair<ast::Declaration::Id const *, type::QualType>>
       potential_decl_ids;
   for (auto const *id :
-       module::AllVisibleDeclsTowardsRoot(node->scope(), node->name())) {
+       module::AllVisibleDeclsTowardsRoot(node->scope(), node->symbol())) {
     if (type::QualType const *prev_qt = context().maybe_qual_type(id).data()) {
       qt = *prev_qt;
     } else {
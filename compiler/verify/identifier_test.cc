@@ -46,6 +46,24 @@ TEST(Identifier, UndeclaredDoesNotRepeat) {
       UnorderedElementsAre(Pair("type-error", "undeclared-identifier")));
 }
 
+TEST(Identifier, SeesDeclarationsAppendedLater) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  f ::= () => 3
+  )");
+  auto const *id1 = mod.Append<ast::Identifier>("f");
+  EXPECT_THAT(mod.context().decls(id1), SizeIs(1));
+
+  // Lookups of `f` from the module scope are cached, but appending another
+  // declaration must invalidate the cached result.
+  mod.AppendCode(R"(
+  f ::= (b: bool) => 4
+  )");
+  auto const *id2 = mod.Append<ast::Identifier>("f");
+  EXPECT_THAT(mod.context().decls(id2), SizeIs(2));
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
 TEST(Identifier, OverloadSetSuccess) {
   test::TestModule mod;
   mod.AppendCode(R"(
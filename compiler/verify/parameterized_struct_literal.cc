@@ -38,10 +38,12 @@ absl::Span<type::QualType const> Compiler::VerifyType(
 
       type::Struct *s = type::Allocate<type::Struct>(
           &compiler.context().module(),
-          type::Struct::Options{.is_copyable = not node->hashtags.contains(
-                                    ir::Hashtag::Uncopyable),
-                                .is_movable = not node->hashtags.contains(
-                                    ir::Hashtag::Immovable)});
+          type::Struct::Options{
+              .is_copyable =
+                  not node->hashtags.contains(ir::Hashtag::Uncopyable),
+              .is_movable = not node->hashtags.contains(ir::Hashtag::Immovable),
+              .reorder_fields = node->hashtags.contains(ir::Hashtag::Compact),
+          });
 
       LOG("ParameterizedStructLiteral",
           "Allocating a new (parameterized) struct %p for %p", s, node);
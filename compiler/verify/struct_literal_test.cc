@@ -2,6 +2,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/module.h"
+#include "type/array.h"
 #include "type/pointer.h"
 #include "type/struct.h"
 
@@ -114,5 +115,31 @@ TEST(StructLiteral, DISABLED_MutuallyReferentialError) {
               UnorderedElementsAre(Pair("type-error", "incomplete-field"),
                                    Pair("type-error", "incomplete-field")));
 }
+
+TEST(StructLiteral, FlagsOfArraysOverIncompleteStructs) {
+  test::TestModule mod;
+  mod.AppendCode(R"(
+  T ::= struct { ss: [2; [3; S]] }
+  S ::= struct { n := 3 }
+  t: T
+  )");
+  auto qts = mod.context().qual_types(mod.Append<ast::Identifier>("t"));
+  type::Struct const *t = qts[0].type().if_as<type::Struct>();
+  ASSERT_NE(t, nullptr);
+  type::Struct::Field const *field = t->field("ss");
+  ASSERT_NE(field, nullptr);
+  auto const *outer = field->type.if_as<type::Array>();
+  ASSERT_NE(outer, nullptr);
+  auto const *inner = outer->data_type().if_as<type::Array>();
+  ASSERT_NE(inner, nullptr);
+  auto const *s = inner->data_type().if_as<type::Struct>();
+  ASSERT_NE(s, nullptr);
+  EXPECT_FALSE(s->IsZeroInitializable());
+  EXPECT_FALSE(inner->IsZeroInitializable());
+  EXPECT_FALSE(outer->IsZeroInitializable());
+  EXPECT_FALSE(t->IsZeroInitializable());
+  EXPECT_THAT(mod.consumer.diagnostics(), IsEmpty());
+}
+
 }  // namespace
 }  // namespace compiler
@@ -122,6 +122,21 @@ void ConsoleRenderer::WriteSourceQuote(frontend::SourceBuffer const &buffer,
   }
 }
 
+void ConsoleRenderer::Add(frontend::Source const *source, Category cat,
+                          Diagnostic const &diag) {
+  if (num_rendered_ == limit_) {
+    if (num_suppressed_++ == 0) {
+      has_data_ = true;
+      absl::FPrintF(out_,
+                    "\033[1mToo many errors; further diagnostics are "
+                    "suppressed.\033[0m\n");
+    }
+    return;
+  }
+  ++num_rendered_;
+  Add(source, cat, diag.message(source));
+}
+
 void ConsoleRenderer::Add(frontend::Source const *source, Category cat,
                           DiagnosticMessage const &diag) {
   has_data_ = true;
@@ -1,7 +1,9 @@
 #ifndef ICARUS_DIAGNOSTIC_CONSOLE_RENDERER_H
 #define ICARUS_DIAGNOSTIC_CONSOLE_RENDERER_H
 
+#include <cstddef>
 #include <cstdio>
+#include <limits>
 #include <type_traits>
 
 #include "diagnostic/message.h"
@@ -9,23 +11,36 @@
 namespace diagnostic {
 
 struct ConsoleRenderer {
-  // Assumes the file is already open.
-  constexpr explicit ConsoleRenderer(std::FILE* out) : out_(out) {}
+  static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
 
-  void AddError(frontend::Source const* source, DiagnosticMessage const& diag) {
+  // Assumes the file is already open. At most `limit` diagnostics are
+  // rendered. Once the limit is reached, a single note is printed and any
+  // further diagnostics are counted but never formatted.
+  constexpr explicit ConsoleRenderer(std::FILE* out, size_t limit = kUnlimited)
+      : out_(out), limit_(limit) {}
+
+  void AddError(frontend::Source const* source, Diagnostic const& diag) {
     Add(source, Category::Error, diag);
   }
 
+  void Add(frontend::Source const* source, Category cat,
+           Diagnostic const& diag);
   void Add(frontend::Source const* source, Category cat,
            DiagnosticMessage const& diag);
   void Flush();
 
+  // The number of diagnostics dropped because the limit had been reached.
+  size_t num_suppressed() const { return num_suppressed_; }
+
  private:
   void WriteSourceQuote(frontend::SourceBuffer const& buffer,
                         SourceQuote const& quote);
 
   bool has_data_ = false;
   std::FILE* out_;
+  size_t limit_;
+  size_t num_rendered_   = 0;
+  size_t num_suppressed_ = 0;
 };
 
 }  // namespace diagnostic
@@ -0,0 +1,68 @@
+#include "diagnostic/console_renderer.h"
+
+#include <cstdio>
+#include <string_view>
+
+#include "diagnostic/consumer/tracking.h"
+#include "diagnostic/message.h"
+#include "frontend/source/string.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace diagnostic {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+struct CountedDiagnostic {
+  static constexpr std::string_view kCategory = "category";
+  static constexpr std::string_view kName     = "name";
+
+  DiagnosticMessage ToMessage(frontend::Source const *) const {
+    ++*num_rendered;
+    return DiagnosticMessage(Text("Rendered."));
+  }
+
+  int *num_rendered;
+};
+
+TEST(Diagnostic, RendersOnlyOnRequest) {
+  int num_rendered = 0;
+  CountedDiagnostic d{.num_rendered = &num_rendered};
+  Diagnostic diag(d);
+  EXPECT_EQ(diag.category(), "category");
+  EXPECT_EQ(diag.name(), "name");
+  EXPECT_EQ(num_rendered, 0);
+
+  diag.message(nullptr);
+  EXPECT_EQ(num_rendered, 1);
+}
+
+TEST(TrackingConsumer, DoesNotRender) {
+  int num_rendered = 0;
+  TrackingConsumer consumer;
+  consumer.Consume(CountedDiagnostic{.num_rendered = &num_rendered});
+  consumer.Consume(CountedDiagnostic{.num_rendered = &num_rendered});
+  EXPECT_EQ(num_rendered, 0);
+  EXPECT_EQ(consumer.num_consumed(), 2);
+  EXPECT_THAT(consumer.diagnostics(),
+              ElementsAre(Pair("category", "name"), Pair("category", "name")));
+}
+
+TEST(ConsoleRenderer, Limit) {
+  std::FILE *out = std::tmpfile();
+  ASSERT_NE(out, nullptr);
+  frontend::StringSource source("");
+  int num_rendered = 0;
+  CountedDiagnostic d{.num_rendered = &num_rendered};
+
+  ConsoleRenderer renderer(out, /*limit=*/2);
+  for (int i = 0; i < 5; ++i) { renderer.AddError(&source, Diagnostic(d)); }
+  EXPECT_EQ(num_rendered, 2);
+  EXPECT_EQ(renderer.num_suppressed(), 3);
+  std::fclose(out);
+}
+
+}  // namespace
+}  // namespace diagnostic
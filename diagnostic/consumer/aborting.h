@@ -15,8 +15,7 @@ struct AbortingConsumer : DiagnosticConsumer {
       : DiagnosticConsumer(src), renderer_(stderr) {}
   ~AbortingConsumer() override {}
 
-  void ConsumeImpl(std::string_view category, std::string_view name,
-                   DiagnosticMessage&& diag) override {
+  void ConsumeImpl(Diagnostic const& diag) override {
     renderer_.AddError(source(), diag);
     std::abort();
   }
@@ -11,7 +11,7 @@ struct DiagnosticConsumer : base::Cast<DiagnosticConsumer> {
 
   template <typename Diag>
   void Consume(Diag const& diag) {
-    ConsumeImpl(Diag::kCategory, Diag::kName, diag.ToMessage(src_));
+    ConsumeImpl(Diagnostic(diag));
     ++num_consumed_;
   }
 
@@ -23,8 +23,9 @@ struct DiagnosticConsumer : base::Cast<DiagnosticConsumer> {
   constexpr size_t num_consumed() const { return num_consumed_; }
 
  protected:
-  virtual void ConsumeImpl(std::string_view category, std::string_view name,
-                           DiagnosticMessage&& diag) = 0;
+  // Called once for each consumed diagnostic. `diag` is only valid for the
+  // duration of the call, and its message is not built unless requested.
+  virtual void ConsumeImpl(Diagnostic const& diag) = 0;
 
  private:
   frontend::Source const* src_;
@@ -1,6 +1,7 @@
 #ifndef ICARUS_DIAGNOSTIC_CONSUMER_STREAMING_H
 #define ICARUS_DIAGNOSTIC_CONSUMER_STREAMING_H
 
+#include <cstddef>
 #include <cstdio>
 
 #include "base/debug.h"
@@ -12,12 +13,14 @@
 namespace diagnostic {
 
 struct StreamingConsumer : DiagnosticConsumer {
-  explicit StreamingConsumer(std::FILE* file, frontend::Source const* src)
-      : DiagnosticConsumer(ASSERT_NOT_NULL(src)), renderer_(file) {}
+  // At most `limit` diagnostics are written to `file`. All of them are still
+  // counted by `num_consumed`.
+  explicit StreamingConsumer(std::FILE* file, frontend::Source const* src,
+                             size_t limit = ConsoleRenderer::kUnlimited)
+      : DiagnosticConsumer(ASSERT_NOT_NULL(src)), renderer_(file, limit) {}
   ~StreamingConsumer() override {}
 
-  void ConsumeImpl(std::string_view category, std::string_view name,
-                   DiagnosticMessage&& diag) override {
+  void ConsumeImpl(Diagnostic const& diag) override {
     renderer_.AddError(source(), diag);
   }
 
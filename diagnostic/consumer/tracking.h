@@ -17,9 +17,8 @@ struct TrackingConsumer : DiagnosticConsumer {
   explicit TrackingConsumer() : DiagnosticConsumer(nullptr) {}
   ~TrackingConsumer() override {}
 
-  void ConsumeImpl(std::string_view category, std::string_view name,
-                   DiagnosticMessage&&) override {
-    diagnostics_.emplace_back(category, name);
+  void ConsumeImpl(Diagnostic const& diag) override {
+    diagnostics_.emplace_back(diag.category(), diag.name());
   }
 
   absl::Span<std::pair<std::string, std::string> const> diagnostics() const {
@@ -11,8 +11,7 @@ struct TrivialConsumer : DiagnosticConsumer {
   ~TrivialConsumer() override {}
 
  protected:
-  void ConsumeImpl(std::string_view category, std::string_view name,
-                   DiagnosticMessage&& diag) override {}
+  void ConsumeImpl(Diagnostic const& diag) override {}
 };
 
 }  // namespace diagnostic
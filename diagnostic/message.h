@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include "absl/strings/str_format.h"
@@ -113,6 +114,35 @@ struct DiagnosticMessage {
   std::vector<Component> components_;
 };
 
+// A compact, type-erased reference to a diagnostic. The category and name are
+// available immediately, but the message is only built when `message` is
+// called, so that consumers which never display a diagnostic do not pay for
+// quoting source or formatting text. A `Diagnostic` refers to the object from
+// which it was constructed and must not outlive it.
+struct Diagnostic {
+  template <typename Diag>
+  explicit Diagnostic(Diag const& diag)
+      : category_(Diag::kCategory),
+        name_(Diag::kName),
+        diag_(&diag),
+        render_([](void const* d, frontend::Source const* src) {
+          return static_cast<Diag const*>(d)->ToMessage(src);
+        }) {}
+
+  std::string_view category() const { return category_; }
+  std::string_view name() const { return name_; }
+
+  DiagnosticMessage message(frontend::Source const* src) const {
+    return render_(diag_, src);
+  }
+
+ private:
+  std::string_view category_;
+  std::string_view name_;
+  void const* diag_;
+  DiagnosticMessage (*render_)(void const*, frontend::Source const*);
+};
+
 }  // namespace diagnostic
 
 #endif  // ICARUS_DIAGNOSTIC_MESSAGE_H
@@ -107,6 +107,17 @@ void BasicBlock::Append(BasicBlock &&b) {
   jump_ = std::move(b.jump_);
 }
 
+void BasicBlock::SplitAfter(size_t n, BasicBlock *b) {
+  ASSERT(n <= instructions_.size());
+  b->RemoveOutgoingJumps();
+  b->ExchangeJumps(this);
+  b->instructions_.insert(b->instructions_.end(),
+                          std::make_move_iterator(instructions_.begin() + n),
+                          std::make_move_iterator(instructions_.end()));
+  instructions_.erase(instructions_.begin() + n, instructions_.end());
+  b->jump_ = std::exchange(jump_, JumpCmd::Unreachable());
+}
+
 void BasicBlock::ReplaceJumpTargets(BasicBlock *old_target,
                                     BasicBlock *new_target) {
   jump_.Visit([&](auto &j) {
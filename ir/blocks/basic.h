@@ -48,6 +48,11 @@ struct BasicBlock {
   void ReplaceJumpTargets(BasicBlock *old_target, BasicBlock *new_target);
   void Append(BasicBlock &&b);
 
+  // Moves every instruction after the first `n`, along with the jump, onto the
+  // end of `b`. This block is left with an unreachable jump. Phi instructions
+  // in successors are not updated.
+  void SplitAfter(size_t n, BasicBlock *b);
+
   // All `BasicBlocks` which can jump to this one. Some may jump unconditionally
   // whereas others may jump only conditionally.
   auto const &incoming() const { return incoming_; }
@@ -67,6 +72,11 @@ struct BasicBlock {
   absl::Span<Inst> instructions() { return absl::MakeSpan(instructions_); }
   absl::Span<Inst const> instructions() const { return instructions_; }
 
+  // Removes any instructions which have been set to null.
+  void RemoveNullInstructions() {
+    std::erase_if(instructions_, [](Inst const &inst) { return not inst; });
+  }
+
   void Append(VoidReturningInstruction auto inst) {
     instructions_.push_back(Inst{std::move(inst)});
   }
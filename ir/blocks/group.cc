@@ -15,7 +15,26 @@ BlockGroupBase::BlockGroupBase(
   b->insert_incoming(b);
 }
 
-Reg BlockGroupBase::Alloca(type::Type t) { return alloc_.StackAllocate(t); }
+BlockGroupBase::BlockGroupBase(BlockGroupBase &&g)
+    : params_(std::move(g.params_)),
+      blocks_(std::move(g.blocks_)),
+      alloc_(std::move(g.alloc_)),
+      byte_code_(std::move(g.byte_code_)),
+      complete_(g.complete()) {}
+
+BlockGroupBase &BlockGroupBase::operator=(BlockGroupBase &&g) {
+  params_    = std::move(g.params_);
+  blocks_    = std::move(g.blocks_);
+  alloc_     = std::move(g.alloc_);
+  byte_code_ = std::move(g.byte_code_);
+  complete_.store(g.complete(), std::memory_order_release);
+  return *this;
+}
+
+Reg BlockGroupBase::Alloca(type::Type t) {
+  ASSERT(complete() == false);
+  return alloc_.StackAllocate(t);
+}
 
 std::ostream &operator<<(std::ostream &os, BlockGroupBase const &b) {
   os << "\n" << b.alloc_;
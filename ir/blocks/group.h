@@ -1,14 +1,18 @@
 #ifndef ICARUS_IR_BLOCKS_GROUP_H
 #define ICARUS_IR_BLOCKS_GROUP_H
 
+#include <atomic>
 #include <concepts>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "ast/ast_fwd.h"
+#include "base/debug.h"
 #include "base/ptr_span.h"
 #include "base/strong_types.h"
+#include "base/untyped_buffer.h"
 #include "core/alignment.h"
 #include "core/bytes.h"
 #include "core/params.h"
@@ -32,9 +36,9 @@ struct BlockGroupBase {
   // TODO We should not need to store anything to do with the AST here.
   // TODO blocks need to know how to handle initial values for their parameters.
   BlockGroupBase(BlockGroupBase const &) = delete;
-  BlockGroupBase(BlockGroupBase &&)      = default;
+  BlockGroupBase(BlockGroupBase &&);
   BlockGroupBase &operator=(BlockGroupBase const &) = delete;
-  BlockGroupBase &operator=(BlockGroupBase &&) = default;
+  BlockGroupBase &operator=(BlockGroupBase &&);
 
   explicit BlockGroupBase(
       core::Params<type::Typed<ast::Declaration const *>> params,
@@ -42,13 +46,17 @@ struct BlockGroupBase {
 
   base::PtrSpan<BasicBlock const> blocks() const { return blocks_; }
   base::PtrSpan<BasicBlock> blocks() { return blocks_; }
-  auto &mutable_blocks() { return blocks_; }
+  auto &mutable_blocks() {
+    ASSERT(complete() == false);
+    return blocks_;
+  }
 
   BasicBlock const *entry() const { return blocks()[0]; }
   BasicBlock *entry() { return blocks()[0]; }
 
   template <typename... Args>
   BasicBlock *AppendBlock(Args &&... args) {
+    ASSERT(complete() == false);
     return blocks_
         .emplace_back(std::make_unique<BasicBlock>(std::forward<Args>(args)...))
         .get();
@@ -63,13 +71,37 @@ struct BlockGroupBase {
     alloc_.for_each_alloc(std::forward<Fn>(f));
   }
 
-  Reg Reserve() { return alloc_.Reserve(); }
+  Reg Reserve() {
+    ASSERT(complete() == false);
+    return alloc_.Reserve();
+  }
   Reg Alloca(type::Type t);
 
   constexpr size_t num_regs() const { return alloc_.num_regs(); }
   constexpr size_t num_args() const { return alloc_.num_args(); }
   size_t num_allocs() const { return alloc_.num_allocs(); }
 
+  // A group is complete once it has been optimized and its byte code written;
+  // its blocks must not change again. Groups may be observed by other threads
+  // (e.g., as inlining candidates or callees) while they are still being
+  // emitted, so this is the only reliable signal that they may be inspected.
+  bool complete() const { return complete_.load(std::memory_order_acquire); }
+
+  // Returns the byte code for this group, or a null pointer if the group is not
+  // yet complete. Byte code is only ever written by `Finalize`, so it is safe
+  // to read concurrently once it has been observed.
+  base::untyped_buffer const *byte_code() const {
+    return complete() ? &*byte_code_ : nullptr;
+  }
+
+  // Stores the byte code for this group and marks it as complete.
+  base::untyped_buffer const &Finalize(base::untyped_buffer byte_code) {
+    ASSERT(complete() == false);
+    byte_code_.emplace(std::move(byte_code));
+    complete_.store(true, std::memory_order_release);
+    return *byte_code_;
+  }
+
   friend std::ostream &operator<<(std::ostream &os, BlockGroupBase const &b);
 
  private:
@@ -78,6 +110,8 @@ struct BlockGroupBase {
   core::Params<type::Typed<ast::Declaration const *>> params_;
   std::vector<std::unique_ptr<BasicBlock>> blocks_;
   RegisterAllocator alloc_;
+  std::optional<base::untyped_buffer> byte_code_;
+  std::atomic<bool> complete_ = false;
 };
 
 }  // namespace internal
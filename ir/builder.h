@@ -253,8 +253,8 @@ struct Builder {
   // upfront, but sometimes it is useful to construct a phi instruction without
   // having set its inputs.
   //
-  // TODO: Right now we are relying on the fact that Inst stores values on the
-  // heap, but this may not always be the case.
+  // The returned pointer remains valid as further instructions are appended
+  // because `PhiInstruction`s opt out of inline storage in `Inst`.
   template <typename T>
   PhiInstruction<T>* PhiInst() {
     PhiInstruction<T> inst;
@@ -1,21 +1,149 @@
 #ifndef ICARUS_IR_BYTE_CODE_WRITER_H
 #define ICARUS_IR_BYTE_CODE_WRITER_H
 
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
 #include "absl/container/flat_hash_map.h"
 #include "base/debug.h"
 #include "base/meta.h"
 #include "base/untyped_buffer.h"
+#include "ir/value/reg.h"
+#include "ir/value/reg_or.h"
+#include "ir/value/value.h"
 
 namespace ir {
 struct BasicBlock;
 
+// Byte code may be written in one of two encodings, chosen at build time. By
+// default every operand is written at its native width. When
+// `ICARUS_COMPACT_BYTE_CODE` is defined, registers and 16-bit integers (op
+// codes, lengths, indices) are LEB128-encoded, register-or-immediate operands
+// are prefixed with a one-byte tag and use a LEB128 form for small integer
+// immediates, and jump targets are stored as 32-bit offsets from the start of
+// the function. Byte code must always be read with `ReadFromByteCode` (directly
+// or via `ReadFromByteCodeExtension`) so that either encoding is decoded
+// correctly.
+#if defined(ICARUS_COMPACT_BYTE_CODE)
+inline constexpr bool kCompactByteCode = true;
+#else
+inline constexpr bool kCompactByteCode = false;
+#endif  // defined(ICARUS_COMPACT_BYTE_CODE)
+
+// The type used to encode the offset of a basic block from the start of the
+// function's byte code.
+using block_offset_t =
+    std::conditional_t<kCompactByteCode, uint32_t, uintptr_t>;
+
+namespace internal {
+
+enum class OperandTag : uint8_t { Reg, Immediate, SmallImmediate };
+
+template <typename T>
+constexpr bool HasSmallImmediateForm =
+    std::is_integral_v<T> and not std::is_same_v<T, bool> and sizeof(T) > 1;
+
+inline void WriteLeb128(base::untyped_buffer* buf, uint64_t n) {
+  do {
+    uint8_t byte = n & 0x7f;
+    n >>= 7;
+    if (n != 0) { byte |= 0x80; }
+    buf->append(byte);
+  } while (n != 0);
+}
+
+inline uint64_t ReadLeb128(base::untyped_buffer::const_iterator* iter) {
+  uint64_t result = 0;
+  int shift       = 0;
+  uint8_t byte;
+  do {
+    byte = iter->read<uint8_t>();
+    result |= uint64_t{byte & 0x7fu} << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return result;
+}
+
+constexpr size_t Leb128Size(uint64_t n) {
+  size_t size = 1;
+  while (n >>= 7) { ++size; }
+  return size;
+}
+
+// The kind of a register is held in its two high bits. Rotating them into the
+// low bits keeps value-registers (the overwhelmingly common case) small.
+inline uint64_t EncodeReg(Reg r) {
+  return std::rotl(std::bit_cast<uint64_t>(r), 2);
+}
+inline Reg DecodeReg(uint64_t n) {
+  return std::bit_cast<Reg>(std::rotr(n, 2));
+}
+
+template <typename T>
+uint64_t ZigZag(T n) {
+  if constexpr (std::is_signed_v<T>) {
+    int64_t m = n;
+    return (static_cast<uint64_t>(m) << 1) ^ static_cast<uint64_t>(m >> 63);
+  } else {
+    return n;
+  }
+}
+
+template <typename T>
+T UnZigZag(uint64_t n) {
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<T>(static_cast<int64_t>(n >> 1) ^
+                          -static_cast<int64_t>(n & 1));
+  } else {
+    return static_cast<T>(n);
+  }
+}
+
+}  // namespace internal
+
+// Reads a single value of type `T` written by `ByteCodeWriter::Write`.
+template <typename T>
+T ReadFromByteCode(base::untyped_buffer::const_iterator* iter) {
+  if constexpr (not kCompactByteCode) {
+    return iter->read<T>().get();
+  } else if constexpr (base::meta<T> == base::meta<Reg>) {
+    return internal::DecodeReg(internal::ReadLeb128(iter));
+  } else if constexpr (base::meta<T> == base::meta<uint16_t>) {
+    return static_cast<uint16_t>(internal::ReadLeb128(iter));
+  } else if constexpr (base::meta<T>.template is_a<RegOr>()) {
+    using type             = typename T::type;
+    internal::OperandTag tag = iter->read<internal::OperandTag>();
+    switch (tag) {
+      case internal::OperandTag::Reg: return ReadFromByteCode<Reg>(iter);
+      case internal::OperandTag::Immediate: return iter->read<type>().get();
+      case internal::OperandTag::SmallImmediate:
+        if constexpr (internal::HasSmallImmediateForm<type>) {
+          return internal::UnZigZag<type>(internal::ReadLeb128(iter));
+        }
+        [[fallthrough]];
+      default: UNREACHABLE();
+    }
+  } else if constexpr (base::meta<T> == base::meta<Value>) {
+    internal::OperandTag tag = iter->read<internal::OperandTag>();
+    switch (tag) {
+      case internal::OperandTag::Reg:
+        return Value(ReadFromByteCode<Reg>(iter));
+      case internal::OperandTag::Immediate: return iter->read<Value>().get();
+      default: UNREACHABLE();
+    }
+  } else {
+    return iter->read<T>().get();
+  }
+}
+
 namespace internal {
 
 template <typename T>
 void ReadInto(T& ref, base::untyped_buffer::const_iterator* iter) {
   if constexpr (base::meta<T>.template is_a<absl::flat_hash_map>()) {
     ASSERT(ref.size() == 0u);
-    uint16_t num_entries = iter->read<uint16_t>();
+    uint16_t num_entries = ReadFromByteCode<uint16_t>(iter);
     ref.reserve(num_entries);
     for (uint16_t i = 0; i < num_entries; ++i) {
       std::pair<typename T::key_type, typename T::mapped_type> entry;
@@ -29,19 +157,19 @@ void ReadInto(T& ref, base::untyped_buffer::const_iterator* iter) {
 
   } else if constexpr (base::meta<T>.template is_a<std::vector>()) {
     ASSERT(ref.size() == 0u);
-    uint16_t num_entries = iter->read<uint16_t>();
+    uint16_t num_entries = ReadFromByteCode<uint16_t>(iter);
     ref.reserve(num_entries);
     for (uint16_t i = 0; i < num_entries; ++i) {
       ReadInto(ref.emplace_back(), iter);
     }
   } else if constexpr (base::meta<T> == base::meta<std::string>) {
     ASSERT(ref.size() == 0u);
-    uint16_t num_chars = iter->read<uint16_t>();
+    uint16_t num_chars = ReadFromByteCode<uint16_t>(iter);
     ref.reserve(num_chars);
     ref = std::string(static_cast<char const*>(iter->raw()), num_chars);
     iter->skip(num_chars);
   } else {
-    ref = iter->read<T>();
+    ref = ReadFromByteCode<T>(iter);
   }
 }
 }  // namespace internal
@@ -56,21 +184,53 @@ struct ByteCodeWriter {
                              int> = 0>
   void Write(T const& val) {
     if constexpr (base::meta<T>.template is_a<std::vector>()) {
-      buf_->append<uint16_t>(val.size());
+      Write<uint16_t>(val.size());
       for (auto const& element : val) { Write(element); }
     } else if constexpr (base::meta<T>.template is_a<std::pair>()) {
       Write(val.first);
       Write(val.second);
     } else if constexpr (base::meta<T> == base::meta<std::string>) {
-      buf_->append<uint16_t>(val.size());
+      Write<uint16_t>(val.size());
       for (char c : val) { Write(c); }
 
     } else if constexpr (base::meta<T>.template is_a<absl::flat_hash_map>()) {
-      buf_->append<uint16_t>(val.size());
+      Write<uint16_t>(val.size());
       for (auto const& [k, v] : val) {
         Write(k);
         Write(v);
       }
+    } else if constexpr (not kCompactByteCode) {
+      buf_->append(val);
+    } else if constexpr (base::meta<T> == base::meta<Reg>) {
+      internal::WriteLeb128(buf_, internal::EncodeReg(val));
+    } else if constexpr (base::meta<T> == base::meta<uint16_t>) {
+      internal::WriteLeb128(buf_, val);
+    } else if constexpr (base::meta<T>.template is_a<RegOr>()) {
+      using type = typename T::type;
+      if (val.is_reg()) {
+        buf_->append(internal::OperandTag::Reg);
+        Write(val.reg());
+      } else if constexpr (internal::HasSmallImmediateForm<type>) {
+        uint64_t n = internal::ZigZag(val.value());
+        if (internal::Leb128Size(n) < sizeof(type)) {
+          buf_->append(internal::OperandTag::SmallImmediate);
+          internal::WriteLeb128(buf_, n);
+        } else {
+          buf_->append(internal::OperandTag::Immediate);
+          buf_->append(val.value());
+        }
+      } else {
+        buf_->append(internal::OperandTag::Immediate);
+        buf_->append(val.value());
+      }
+    } else if constexpr (base::meta<T> == base::meta<Value>) {
+      if (auto const* r = val.template get_if<Reg>()) {
+        buf_->append(internal::OperandTag::Reg);
+        Write(*r);
+      } else {
+        buf_->append(internal::OperandTag::Immediate);
+        buf_->append(val);
+      }
     } else {
       buf_->append(val);
     }
@@ -78,7 +238,7 @@ struct ByteCodeWriter {
 
   void Write(BasicBlock const* block) {
     replacements_[block].push_back(buf_->size());
-    buf_->append_bytes(sizeof(BasicBlock*));
+    buf_->append_bytes(sizeof(block_offset_t));
   }
 
   void StartBlock(BasicBlock const* b) { offsets_.emplace(b, buf_->size()); }
@@ -87,7 +247,9 @@ struct ByteCodeWriter {
     for (auto const& [block, locs] : replacements_) {
       auto iter = offsets_.find(block);
       ASSERT(iter != offsets_.end());
-      for (size_t loc : locs) { buf_->set(loc, iter->second); }
+      for (size_t loc : locs) {
+        buf_->set(loc, static_cast<block_offset_t>(iter->second));
+      }
     }
     replacements_.clear();
   }
@@ -0,0 +1,71 @@
+#include "ir/byte_code_writer.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+template <typename T>
+T RoundTrip(T const& value) {
+  base::untyped_buffer buffer;
+  ir::ByteCodeWriter writer(&buffer);
+  writer.Write(value);
+  auto iter = buffer.cbegin();
+  T result{};
+  ir::internal::ReadInto(result, &iter);
+  EXPECT_EQ(iter, buffer.cend());
+  return result;
+}
+
+TEST(ByteCodeWriter, Reg) {
+  EXPECT_EQ(RoundTrip(ir::Reg(0)), ir::Reg(0));
+  EXPECT_EQ(RoundTrip(ir::Reg(1234567)), ir::Reg(1234567));
+  EXPECT_EQ(RoundTrip(ir::Reg::Arg(3)), ir::Reg::Arg(3));
+  EXPECT_EQ(RoundTrip(ir::Reg::Out(5)), ir::Reg::Out(5));
+  EXPECT_EQ(RoundTrip(ir::Reg()), ir::Reg());
+}
+
+TEST(ByteCodeWriter, RegOr) {
+  EXPECT_EQ(RoundTrip(ir::RegOr<int64_t>(ir::Reg(17))),
+            ir::RegOr<int64_t>(ir::Reg(17)));
+  EXPECT_EQ(RoundTrip(ir::RegOr<int64_t>(3)), ir::RegOr<int64_t>(3));
+  EXPECT_EQ(RoundTrip(ir::RegOr<int64_t>(-3)), ir::RegOr<int64_t>(-3));
+  EXPECT_EQ(RoundTrip(ir::RegOr<int64_t>(std::numeric_limits<int64_t>::min())),
+            ir::RegOr<int64_t>(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ(RoundTrip(ir::RegOr<uint32_t>(4000000000u)),
+            ir::RegOr<uint32_t>(4000000000u));
+  EXPECT_EQ(RoundTrip(ir::RegOr<bool>(true)), ir::RegOr<bool>(true));
+  EXPECT_EQ(RoundTrip(ir::RegOr<double>(1.5)), ir::RegOr<double>(1.5));
+}
+
+TEST(ByteCodeWriter, Value) {
+  EXPECT_EQ(RoundTrip(ir::Value(ir::Reg(4))), ir::Value(ir::Reg(4)));
+  EXPECT_EQ(RoundTrip(ir::Value(int64_t{4})), ir::Value(int64_t{4}));
+}
+
+TEST(ByteCodeWriter, Containers) {
+  EXPECT_EQ(RoundTrip(std::string("hello")), "hello");
+  EXPECT_THAT(RoundTrip(std::vector<ir::Reg>{ir::Reg(1), ir::Reg(200)}),
+              testing::ElementsAre(ir::Reg(1), ir::Reg(200)));
+  std::vector<uint16_t> v(300, 7);
+  EXPECT_EQ(RoundTrip(v), v);
+}
+
+TEST(ByteCodeWriter, CompactEncodingIsSmaller) {
+  base::untyped_buffer buffer;
+  ir::ByteCodeWriter writer(&buffer);
+  writer.Write(ir::RegOr<int64_t>(ir::Reg(3)));
+  writer.Write(ir::RegOr<int64_t>(1));
+  writer.Write(ir::Reg(4));
+  if constexpr (ir::kCompactByteCode) {
+    EXPECT_EQ(buffer.size(), 5);
+  } else {
+    EXPECT_EQ(buffer.size(),
+              2 * sizeof(ir::RegOr<int64_t>) + sizeof(ir::Reg));
+  }
+}
+
+}  // namespace
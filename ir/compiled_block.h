@@ -3,6 +3,7 @@
 
 #include "absl/container/flat_hash_set.h"
 #include "ast/ast.h"
+#include "ir/byte_code_writer.h"
 #include "ir/instruction/op_codes.h"
 #include "ir/instruction/set.h"
 #include "ir/value/block.h"
@@ -15,20 +16,18 @@ namespace ir {
 
 inline NativeFn TrivialFunction() {
   // TODO: Avoid the delayed static here.
-  static base::NoDestructor<base::untyped_buffer> byte_code = [] {
-    base::untyped_buffer result;
-    result.append(internal::kReturnInstruction);
-    return result;
-  }();
   static base::NoDestructor<NativeFn::Data> data = [] {
     auto fn_type = type::Func({}, {});
     auto *f      = new CompiledFn(
         fn_type, core::Params<type::Typed<ast::Declaration const *>>{});
     f->entry()->set_jump(JumpCmd::Return());
+    base::untyped_buffer byte_code;
+    ByteCodeWriter writer(&byte_code);
+    writer.Write(internal::kReturnInstruction);
+    f->Finalize(std::move(byte_code));
     return NativeFn::Data{
-        .fn        = f,
-        .type      = fn_type,
-        .byte_code = byte_code->begin(),
+        .fn   = f,
+        .type = fn_type,
     };
   }();
   return NativeFn(&*data);
@@ -21,6 +21,7 @@ struct AddInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = add %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   num_type Resolve() const { return lhs.value() + rhs.value(); }
 
@@ -35,6 +36,7 @@ struct SubInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = sub %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   num_type Resolve() const { return lhs.value() - rhs.value(); }
   RegOr<num_type> lhs;
@@ -48,6 +50,7 @@ struct MulInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = mul %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   num_type Resolve() const { return lhs.value() * rhs.value(); }
 
@@ -56,6 +59,8 @@ struct MulInstruction
   Reg result;
 };
 
+// Division and modulus are not marked pure: dividing by zero must trap even if
+// the result is unused.
 template <typename NumType>
 struct DivInstruction
     : base::Extend<DivInstruction<NumType>>::template With<
@@ -90,6 +95,7 @@ struct NegInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%2$s = neg %1$s";
+  static constexpr bool kPure                    = true;
 
   num_type Resolve() const { return Apply(operand.value()); }
   static num_type Apply(num_type operand) { return -operand; }
@@ -2,18 +2,33 @@
 #define ICARUS_IR_INSTRUCTION_BASE_H
 
 #include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <optional>
 #include <string>
-
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/hash/hash.h"
 #include "base/cast.h"
 #include "base/meta.h"
 #include "base/untyped_buffer.h"
 #include "ir/value/reg.h"
+#include "ir/value/reg_or.h"
+#include "ir/value/value.h"
 
 // TODO rename this file so that when you forget that for dependency reasons you
 // should try to include this instead of instructions.h, you reach for this one
 // anyway.
 namespace ir {
 
+struct BasicBlock;
 struct InstructionInliner;
 struct ByteCodeWriter;
 
@@ -35,13 +50,262 @@ concept ReturningInstruction = Instruction<T> and requires (T t) {
 
 template <typename T>
 concept VoidReturningInstruction = Instruction<T> and not ReturningInstruction<T>;
+
+// A `PureInstruction` has no effect other than writing its result register,
+// and the value it writes depends only on its operands. Instructions opt in by
+// defining `static constexpr bool kPure = true`. Pure instructions may be
+// removed when their result is unused and deduplicated when they have equal
+// operands. If they also have a `Resolve()` member function, they will be
+// evaluated at compile-time when all of their operands are immediates, unless
+// they opt out by defining `static constexpr bool kFoldable = false`.
+template <typename T>
+concept PureInstruction = ReturningInstruction<T> and T::kPure;
 // clang-format on
 
+// Instructions are stored inline in an `Inst` (and therefore contiguously in
+// the `std::vector<Inst>` owned by a `BasicBlock`) whenever they are small
+// enough to fit. Larger instructions, or those which explicitly request a
+// stable address by defining `static constexpr bool kRequiresStableAddress =
+// true`, are allocated on the heap.
+inline constexpr size_t kInlineInstructionBytes     = 48;
+inline constexpr size_t kInlineInstructionAlignment = alignof(std::max_align_t);
+
+namespace internal_instruction {
+
+template <typename T>
+concept RequiresStableAddress = T::kRequiresStableAddress;
+
+template <typename T>
+constexpr bool StoredInline = sizeof(T) <= kInlineInstructionBytes and
+                              alignof(T) <= kInlineInstructionAlignment and
+                              std::is_nothrow_move_constructible_v<T> and
+                              not RequiresStableAddress<T>;
+
+template <typename T>
+concept HasFieldRefs = requires(T t) { t.field_refs(); };
+
+template <typename T>
+concept NotFoldable = not T::kFoldable;
+
+template <typename T>
+concept Foldable = PureInstruction<T> and HasFieldRefs<T> and
+                   not NotFoldable<T> and requires(T const t) { t.Resolve(); };
+
+template <typename T>
+concept HasReplaceUses =
+    requires(T t, absl::FunctionRef<Value(Reg)> f) {
+  { t.ReplaceUses(f) } -> std::same_as<bool>;
+};
+
+template <typename T>
+concept HasSimplify = requires(T const t) {
+  { t.Simplify() } -> std::same_as<Value>;
+};
+
+template <typename T>
+concept HasReplaceIncomingBlocks =
+    requires(T t,
+             absl::FunctionRef<BasicBlock const*(BasicBlock const*)> f) {
+  t.ReplaceIncomingBlocks(f);
+};
+
+template <typename T>
+concept Hashable = requires(T const& t) {
+  { absl::Hash<T>{}(t) } -> std::convertible_to<size_t>;
+};
+
+// Types which are known not to hold any registers.
+template <typename T>
+concept RegisterFree =
+    std::is_scalar_v<T> or base::meta<T> == base::meta<std::string> or
+    base::meta<T> == base::meta<std::string_view> or
+    internal_value::HoldableInValue<T, Value::value_size_v, Value::alignment_v>;
+
+// Whether all registers held in a `T` can be enumerated by
+// `ReplaceOperandUses`.
+template <typename T>
+constexpr bool EnumerableOperand = [] {
+  constexpr auto type = base::meta<T>;
+  if constexpr (type == base::meta<Reg> or type == base::meta<Value> or
+                type.template is_a<RegOr>()) {
+    return true;
+  } else if constexpr (type.template is_a<std::vector>()) {
+    return EnumerableOperand<typename T::value_type>;
+  } else if constexpr (type.template is_a<std::pair>()) {
+    return EnumerableOperand<typename T::first_type> and
+           EnumerableOperand<typename T::second_type>;
+  } else if constexpr (type.template is_a<absl::flat_hash_map>()) {
+    return RegisterFree<typename T::key_type> and
+           EnumerableOperand<typename T::mapped_type>;
+  } else {
+    return RegisterFree<T>;
+  }
+}();
+
+// Calls `f` on each register read through `field`. Whenever `f` returns a
+// register, or an immediate of the type the operand holds, the operand is
+// replaced with it.
+template <typename T>
+void ReplaceOperandUses(T& field, absl::FunctionRef<Value(Reg)> f) {
+  constexpr auto type = base::meta<T>;
+  if constexpr (type == base::meta<Reg>) {
+    Value v = f(field);
+    if (auto const* r = v.template get_if<Reg>()) { field = *r; }
+  } else if constexpr (type.template is_a<RegOr>()) {
+    if (not field.is_reg()) { return; }
+    Value v = f(field.reg());
+    if (auto const* r = v.template get_if<Reg>()) {
+      field = *r;
+    } else if (auto const* imm = v.template get_if<typename T::type>()) {
+      field = *imm;
+    }
+  } else if constexpr (type == base::meta<Value>) {
+    auto const* r = field.template get_if<Reg>();
+    if (not r) { return; }
+    Value v = f(*r);
+    if (not v.empty()) { field = v; }
+  } else if constexpr (type.template is_a<std::vector>()) {
+    for (auto& elem : field) { ReplaceOperandUses(elem, f); }
+  } else if constexpr (type.template is_a<std::pair>()) {
+    ReplaceOperandUses(field.first, f);
+    ReplaceOperandUses(field.second, f);
+  } else if constexpr (type.template is_a<absl::flat_hash_map>()) {
+    for (auto& [k, v] : field) { ReplaceOperandUses(v, f); }
+  }
+}
+
+template <typename FieldRefs>
+constexpr bool EnumerableFields = false;
+template <typename... Ts>
+constexpr bool EnumerableFields<std::tuple<Ts...>> =
+    (EnumerableOperand<std::decay_t<Ts>> and ...);
+
+// Applies `ReplaceOperandUses` to every field of `t` other than its result.
+// Returns `false` without calling `f` if some field may hold registers which
+// cannot be enumerated.
+template <HasFieldRefs T>
+bool ReplaceFieldUses(T& t, absl::FunctionRef<Value(Reg)> f) {
+  if constexpr (not EnumerableFields<decltype(t.field_refs())>) {
+    return false;
+  } else {
+    std::apply(
+        [&](auto&... fields) {
+          (
+              [&](auto& field) {
+                if constexpr (ReturningInstruction<T> and
+                              base::meta<std::decay_t<decltype(field)>> ==
+                                  base::meta<Reg>) {
+                  if (&field == &t.result) { return; }
+                }
+                ReplaceOperandUses(field, f);
+              }(fields),
+              ...);
+        },
+        t.field_refs());
+    return true;
+  }
+}
+
+// Floating-point immediates are compared bitwise so that, for instance, `0.0`
+// and `-0.0` are not considered interchangeable.
+template <typename T>
+bool SameOperand(T const& lhs, T const& rhs) {
+  if constexpr (base::meta<T>.template is_a<RegOr>()) {
+    if constexpr (std::is_floating_point_v<typename T::type>) {
+      if (lhs.is_reg() or rhs.is_reg()) { return lhs == rhs; }
+      auto l = lhs.value();
+      auto r = rhs.value();
+      return std::memcmp(&l, &r, sizeof(l)) == 0;
+    } else {
+      return lhs == rhs;
+    }
+  } else {
+    return lhs == rhs;
+  }
+}
+
+template <typename FieldRefs>
+constexpr bool ComparableFields = false;
+template <typename... Ts>
+constexpr bool ComparableFields<std::tuple<Ts...>> =
+    ((Hashable<std::decay_t<Ts>> and
+      std::equality_comparable<std::decay_t<Ts>>)and...);
+
+template <typename T>
+concept ValueNumberable =
+    PureInstruction<T> and HasFieldRefs<T> and
+    ComparableFields<decltype(std::declval<T const&>().field_refs())>;
+
+template <typename T>
+size_t HashOperands(T const& t) {
+  return std::apply(
+      [&](auto const&... fields) {
+        size_t h = 0;
+        (
+            [&](auto const& field) {
+              if constexpr (base::meta<std::decay_t<decltype(field)>> ==
+                            base::meta<Reg>) {
+                if (&field == &t.result) { return; }
+              }
+              using field_type = std::decay_t<decltype(field)>;
+              h = absl::Hash<std::pair<size_t, size_t>>{}(
+                  std::pair(h, absl::Hash<field_type>{}(field)));
+            }(fields),
+            ...);
+        return h;
+      },
+      t.field_refs());
+}
+
+template <typename T>
+bool SameOperands(T const& lhs, T const& rhs) {
+  auto lhs_fields = lhs.field_refs();
+  auto rhs_fields = rhs.field_refs();
+  return [&]<size_t... Ns>(std::index_sequence<Ns...>) {
+    return ([&](auto const& l, auto const& r) {
+      if constexpr (base::meta<std::decay_t<decltype(l)>> == base::meta<Reg>) {
+        if (&l == &lhs.result) { return true; }
+      }
+      return SameOperand(l, r);
+    }(std::get<Ns>(lhs_fields), std::get<Ns>(rhs_fields)) and
+            ...);
+  }(std::make_index_sequence<std::tuple_size_v<decltype(lhs_fields)>>{});
+}
+
+template <typename T>
+Value Simplify(T const& t) {
+  if constexpr (HasSimplify<T>) {
+    return t.Simplify();
+  } else if constexpr (Foldable<T>) {
+    using result_type = decltype(t.Resolve());
+    if constexpr (std::constructible_from<Value, result_type const&>) {
+      bool all_immediate = true;
+      bool enumerable    = ReplaceFieldUses(const_cast<T&>(t), [&](Reg) {
+        all_immediate = false;
+        return Value();
+      });
+      if (enumerable and all_immediate) { return Value(t.Resolve()); }
+    }
+    return Value();
+  } else {
+    return Value();
+  }
+}
+
+}  // namespace internal_instruction
+
 struct InstructionVTable {
-  void* (*copy_construct)(void const*) = [](void const*) -> void* {
-    return nullptr;
-  };
-  void* (*move_construct)(void*) = [](void*) -> void* { return nullptr; };
+  // Constructs a copy of the instruction at `from`, either in `buffer` or on
+  // the heap, and returns a pointer to it.
+  void* (*copy_construct)(void const* from, void* buffer) =
+      [](void const*, void*) -> void* { return nullptr; };
+
+  // Transfers ownership of the instruction at `from` and returns a pointer to
+  // it. Inline instructions are moved into `buffer` and the original is
+  // destroyed; heap-allocated instructions simply have their allocation
+  // stolen. Either way, `from` must not be destroyed after this call.
+  void* (*move_construct)(void* from, void* buffer) =
+      [](void*, void*) -> void* { return nullptr; };
   void (*copy_assign)(void const*, void*) = [](void const*, void*) {};
   void (*move_assign)(void*, void*)       = [](void*, void*) {};
   void (*destroy)(void*)                  = [](void*) {};
@@ -59,17 +323,64 @@ struct InstructionVTable {
         UNREACHABLE("Inline is unimplemented");
       };
 
+  // The hooks below are used by the optimizer (see //opt). Their defaults are
+  // conservative, so instructions which do not support them are left alone.
+
+  std::optional<Reg> (*result)(void const*) =
+      [](void const*) -> std::optional<Reg> { return std::nullopt; };
+
+  // Whether the instruction satisfies `PureInstruction`.
+  bool pure = false;
+
+  // Calls the given function on each register the instruction reads (never
+  // including its result), replacing operands as described in
+  // `internal_instruction::ReplaceOperandUses`. Returns `false` if the
+  // instruction's operands cannot all be enumerated. Null instructions read
+  // nothing.
+  bool (*ReplaceUses)(void*, absl::FunctionRef<Value(Reg)>) =
+      [](void*, absl::FunctionRef<Value(Reg)>) { return true; };
+
+  // Returns a register or immediate known to be equal to the instruction's
+  // result, or an empty `Value` if none is known.
+  Value (*Simplify)(void const*) = [](void const*) { return Value(); };
+
+  // Hash and equality of everything but the result of a pure instruction, so
+  // that instructions computing the same value can be identified. Null unless
+  // the instruction satisfies `ValueNumberable`.
+  size_t (*HashOperands)(void const*)            = nullptr;
+  bool (*SameOperands)(void const*, void const*) = nullptr;
+
+  // Replaces each incoming block `b` the instruction refers to with `f(b)`,
+  // dropping the corresponding entry when `f(b)` is null. Returns `false` if
+  // the instruction does not refer to incoming blocks.
+  bool (*ReplaceIncomingBlocks)(
+      void*, absl::FunctionRef<BasicBlock const*(BasicBlock const*)>) =
+      [](void*, absl::FunctionRef<BasicBlock const*(BasicBlock const*)>) {
+        return false;
+      };
+
   base::MetaValue rtti;
 };
 inline constexpr InstructionVTable DefaultInstructionVTable;
 
 template <typename T>
 InstructionVTable InstructionVTableFor{
-    .copy_construct = [](void const* from) -> void* {
-      return new T(*reinterpret_cast<T const*>(from));
+    .copy_construct = [](void const* from, void* buffer) -> void* {
+      if constexpr (internal_instruction::StoredInline<T>) {
+        return new (buffer) T(*reinterpret_cast<T const*>(from));
+      } else {
+        return new T(*reinterpret_cast<T const*>(from));
+      }
     },
-    .move_construct = [](void* from) -> void* {
-      return new T(std::move(*reinterpret_cast<T*>(from)));
+    .move_construct = [](void* from, void* buffer) -> void* {
+      if constexpr (internal_instruction::StoredInline<T>) {
+        T* f     = reinterpret_cast<T*>(from);
+        void* to = new (buffer) T(std::move(*f));
+        f->~T();
+        return to;
+      } else {
+        return from;
+      }
     },
     .copy_assign =
         [](void const* from, void* to) {
@@ -79,7 +390,14 @@ InstructionVTable InstructionVTableFor{
         [](void* from, void* to) {
           *reinterpret_cast<T*>(to) = std::move(*reinterpret_cast<T*>(from));
         },
-    .destroy = [](void* self) { delete reinterpret_cast<T*>(self); },
+    .destroy =
+        [](void* self) {
+          if constexpr (internal_instruction::StoredInline<T>) {
+            reinterpret_cast<T*>(self)->~T();
+          } else {
+            delete reinterpret_cast<T*>(self);
+          }
+        },
 
     .WriteByteCode =
         [](void* self, ByteCodeWriter* writer) {
@@ -95,22 +413,90 @@ InstructionVTable InstructionVTableFor{
         [](void* self, InstructionInliner const& inliner) {
           return reinterpret_cast<T*>(self)->Inline(inliner);
         },
+
+    .result = [](void const* self) -> std::optional<Reg> {
+      if constexpr (ReturningInstruction<T>) {
+        return reinterpret_cast<T const*>(self)->result;
+      } else {
+        return std::nullopt;
+      }
+    },
+    .pure = PureInstruction<T>,
+    .ReplaceUses =
+        [](void* self, absl::FunctionRef<Value(Reg)> f) {
+          if constexpr (internal_instruction::HasReplaceUses<T>) {
+            return reinterpret_cast<T*>(self)->ReplaceUses(f);
+          } else if constexpr (internal_instruction::HasFieldRefs<T>) {
+            return internal_instruction::ReplaceFieldUses(
+                *reinterpret_cast<T*>(self), f);
+          } else {
+            return false;
+          }
+        },
+    .Simplify =
+        [](void const* self) {
+          return internal_instruction::Simplify(
+              *reinterpret_cast<T const*>(self));
+        },
+    .HashOperands = [] {
+      size_t (*f)(void const*) = nullptr;
+      if constexpr (internal_instruction::ValueNumberable<T>) {
+        f = [](void const* self) {
+          return internal_instruction::HashOperands(
+              *reinterpret_cast<T const*>(self));
+        };
+      }
+      return f;
+    }(),
+    .SameOperands = [] {
+      bool (*f)(void const*, void const*) = nullptr;
+      if constexpr (internal_instruction::ValueNumberable<T>) {
+        f = [](void const* lhs, void const* rhs) {
+          return internal_instruction::SameOperands(
+              *reinterpret_cast<T const*>(lhs),
+              *reinterpret_cast<T const*>(rhs));
+        };
+      }
+      return f;
+    }(),
+    .ReplaceIncomingBlocks =
+        [](void* self,
+           absl::FunctionRef<BasicBlock const*(BasicBlock const*)> f) {
+          if constexpr (internal_instruction::HasReplaceIncomingBlocks<T>) {
+            reinterpret_cast<T*>(self)->ReplaceIncomingBlocks(f);
+            return true;
+          } else {
+            return false;
+          }
+        },
     .rtti = base::meta<T>,
 };
 
 struct Inst {
   template <typename T>
-  Inst(T&& inst) noexcept
-      : data_(new std::decay_t<T>(std::forward<T>(inst))),
-        vtable_(&InstructionVTableFor<std::decay_t<T>>) {}
+  static constexpr bool stored_inline =
+      internal_instruction::StoredInline<std::decay_t<T>>;
+
+  template <typename T>
+  Inst(T&& inst) noexcept : vtable_(&InstructionVTableFor<std::decay_t<T>>) {
+    using type = std::decay_t<T>;
+    if constexpr (stored_inline<type>) {
+      data_ = new (buffer_) type(std::forward<T>(inst));
+    } else {
+      data_ = new type(std::forward<T>(inst));
+    }
+  }
 
   Inst(Inst const& inst) noexcept
-      : data_(inst.vtable_->copy_construct(inst.data_)),
+      : data_(inst.vtable_->copy_construct(inst.data_, buffer_)),
         vtable_(inst.vtable_) {}
 
   Inst(Inst&& inst) noexcept
-      : data_(std::exchange(inst.data_, nullptr)),
-        vtable_(std::exchange(inst.vtable_, &DefaultInstructionVTable)) {}
+      : data_(inst.vtable_->move_construct(inst.data_, buffer_)),
+        vtable_(inst.vtable_) {
+    inst.data_   = nullptr;
+    inst.vtable_ = &DefaultInstructionVTable;
+  }
 
   Inst& operator=(Inst const& inst) noexcept {
     if (vtable_ == inst.vtable_) {
@@ -118,7 +504,7 @@ struct Inst {
     } else {
       vtable_->destroy(data_);
       vtable_ = inst.vtable_;
-      data_   = vtable_->copy_construct(inst.data_);
+      data_   = vtable_->copy_construct(inst.data_, buffer_);
     }
     return *this;
   }
@@ -128,8 +514,9 @@ struct Inst {
       vtable_->move_assign(inst.data_, data_);
     } else {
       vtable_->destroy(data_);
-      vtable_ = inst.vtable_;
-      data_   = vtable_->move_construct(inst.data_);
+      vtable_    = std::exchange(inst.vtable_, &DefaultInstructionVTable);
+      data_      = vtable_->move_construct(inst.data_, buffer_);
+      inst.data_ = nullptr;
     }
     return *this;
   }
@@ -189,6 +576,50 @@ struct Inst {
 
   base::MetaValue rtti() const { return vtable_->rtti; }
 
+  // The register written by this instruction, if any.
+  std::optional<Reg> result() const { return vtable_->result(data_); }
+
+  // Whether the held instruction is a `PureInstruction`.
+  bool pure() const { return vtable_->pure; }
+
+  // Calls `f` on each register read by this instruction, replacing the operand
+  // whenever `f` returns a register or an immediate of the operand's type.
+  // Returns `false` if this instruction's operands cannot all be enumerated,
+  // in which case it must be assumed to read any register.
+  bool ReplaceUses(absl::FunctionRef<Value(Reg)> f) {
+    return vtable_->ReplaceUses(data_, f);
+  }
+
+  // Calls `f` on each register read by this instruction. Returns `false` if
+  // this instruction's operands cannot all be enumerated.
+  bool ForEachUse(absl::FunctionRef<void(Reg)> f) const {
+    return vtable_->ReplaceUses(data_, [&](Reg r) {
+      f(r);
+      return Value();
+    });
+  }
+
+  // Returns a register or immediate known to hold the same value as this
+  // instruction's result, or an empty `Value` if there is none.
+  Value Simplify() const { return vtable_->Simplify(data_); }
+
+  // Whether two instructions are known to compute the same value, regardless
+  // of which register they write it to.
+  bool value_numberable() const { return vtable_->SameOperands != nullptr; }
+  size_t HashOperands() const { return vtable_->HashOperands(data_); }
+  bool SameOperands(Inst const& inst) const {
+    return vtable_ == inst.vtable_ and
+           vtable_->SameOperands(data_, inst.data_);
+  }
+
+  // Replaces each incoming block `b` this instruction refers to with `f(b)`,
+  // dropping the corresponding entry when `f(b)` is null. Returns `false` if
+  // this instruction does not depend on the incoming block.
+  bool ReplaceIncomingBlocks(
+      absl::FunctionRef<BasicBlock const*(BasicBlock const*)> f) {
+    return vtable_->ReplaceIncomingBlocks(data_, f);
+  }
+
   Inst* operator->() { return this; }
   Inst const* operator->() const { return this; }
 
@@ -196,8 +627,11 @@ struct Inst {
   Inst const& operator*() const { return *this; }
 
  private:
+  // Points either into `buffer_` or to a heap allocation, depending on whether
+  // the held instruction is `stored_inline`.
   void* data_;
   InstructionVTable const* vtable_;
+  alignas(kInlineInstructionAlignment) char buffer_[kInlineInstructionBytes];
 };
 
 }  // namespace ir
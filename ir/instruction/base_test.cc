@@ -1,12 +1,20 @@
 #include "ir/instruction/base.h"
 
+#include <optional>
 #include <string>
+#include <vector>
 
+#include "base/extend.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ir/value/reg.h"
+#include "ir/value/reg_or.h"
+#include "ir/value/value.h"
 
 namespace {
 
+using ::testing::ElementsAre;
+
 template <int N>
 struct MockInstruction {
   explicit MockInstruction(std::string s) : str_(std::move(s)) {}
@@ -58,4 +66,163 @@ TEST(Inst, CopyConstructionAndAssignment) {
   EXPECT_EQ(inst.if_as<MockInstruction<1>>(), nullptr);
 }
 
+struct LargeInstruction {
+  std::string to_string() const { return "large"; }
+
+  void Inline(ir::InstructionInliner const& inliner) {}
+
+  void WriteByteCode(ir::ByteCodeWriter* writer) const {}
+
+  char data[ir::kInlineInstructionBytes + 1];
+};
+
+struct StableInstruction {
+  static constexpr bool kRequiresStableAddress = true;
+
+  std::string to_string() const { return "stable"; }
+
+  void Inline(ir::InstructionInliner const& inliner) {}
+
+  void WriteByteCode(ir::ByteCodeWriter* writer) const {}
+};
+
+TEST(Inst, Storage) {
+  EXPECT_TRUE(ir::Inst::stored_inline<MockInstruction<1>>);
+  EXPECT_FALSE(ir::Inst::stored_inline<LargeInstruction>);
+  EXPECT_FALSE(ir::Inst::stored_inline<StableInstruction>);
+
+  ir::Inst inst = MockInstruction<1>("hello");
+  auto const* p = reinterpret_cast<char const*>(&inst);
+  auto const* q =
+      reinterpret_cast<char const*>(inst.if_as<MockInstruction<1>>());
+  EXPECT_GE(q, p);
+  EXPECT_LT(q, p + sizeof(ir::Inst));
+}
+
+TEST(Inst, StableAddressSurvivesMove) {
+  std::vector<ir::Inst> insts;
+  insts.push_back(StableInstruction{});
+  auto* p = insts.back().if_as<StableInstruction>();
+  for (int i = 0; i < 100; ++i) { insts.push_back(MockInstruction<1>("x")); }
+  EXPECT_EQ(insts.front().if_as<StableInstruction>(), p);
+}
+
+TEST(Inst, MixedStorageInVector) {
+  std::vector<ir::Inst> insts;
+  for (int i = 0; i < 10; ++i) {
+    if (i % 2 == 0) {
+      insts.push_back(MockInstruction<1>(std::string(i, 'a')));
+    } else {
+      insts.push_back(LargeInstruction{});
+    }
+  }
+
+  std::vector<ir::Inst> copy = insts;
+  copy[0]                    = std::move(copy[1]);
+  copy[2]                    = copy[3];
+  copy[3]                    = MockInstruction<2>("world");
+
+  EXPECT_EQ(copy[0].to_string(), "large");
+  EXPECT_FALSE(static_cast<bool>(copy[1]));
+  EXPECT_EQ(copy[2].to_string(), "large");
+  EXPECT_EQ(copy[3].to_string(), "world");
+  EXPECT_EQ(copy[4].to_string(), "aaaa");
+  EXPECT_EQ(insts[0].to_string(), "");
+  EXPECT_EQ(insts[1].to_string(), "large");
+}
+
+struct AddInstruction : base::Extend<AddInstruction, 3>::With<> {
+  static constexpr bool kPure = true;
+
+  std::string to_string() const { return "add"; }
+  void Inline(ir::InstructionInliner const& inliner) {}
+  void WriteByteCode(ir::ByteCodeWriter* writer) const {}
+
+  int64_t Resolve() const { return lhs.value() + rhs.value(); }
+
+  ir::RegOr<int64_t> lhs;
+  ir::RegOr<int64_t> rhs;
+  ir::Reg result;
+};
+
+struct StoreInstruction : base::Extend<StoreInstruction, 2>::With<> {
+  std::string to_string() const { return "store"; }
+  void Inline(ir::InstructionInliner const& inliner) {}
+  void WriteByteCode(ir::ByteCodeWriter* writer) const {}
+
+  std::vector<ir::RegOr<double>> values;
+  ir::Value location;
+};
+
+struct OpaqueInstruction : base::Extend<OpaqueInstruction, 1>::With<> {
+  struct Field {
+    ir::Reg reg;
+  };
+
+  std::string to_string() const { return "opaque"; }
+  void Inline(ir::InstructionInliner const& inliner) {}
+  void WriteByteCode(ir::ByteCodeWriter* writer) const {}
+
+  std::vector<Field> fields;
+};
+
+TEST(Inst, Simplify) {
+  ir::Inst inst = AddInstruction{.lhs = 1, .rhs = 2, .result = ir::Reg(3)};
+  EXPECT_TRUE(inst.pure());
+  EXPECT_EQ(inst.result(), ir::Reg(3));
+  EXPECT_EQ(inst.Simplify(), ir::Value(int64_t{3}));
+
+  inst = AddInstruction{.lhs = ir::Reg(1), .rhs = 2, .result = ir::Reg(3)};
+  EXPECT_TRUE(inst.Simplify().empty());
+  inst.ReplaceUses([](ir::Reg) { return ir::Value(int64_t{5}); });
+  EXPECT_EQ(inst.Simplify(), ir::Value(int64_t{7}));
+}
+
+TEST(Inst, ForEachUse) {
+  ir::Inst inst = AddInstruction{
+      .lhs = ir::Reg(1), .rhs = ir::Reg(2), .result = ir::Reg(3)};
+  std::vector<ir::Reg> uses;
+  EXPECT_TRUE(inst.ForEachUse([&](ir::Reg r) { uses.push_back(r); }));
+  EXPECT_THAT(uses, ElementsAre(ir::Reg(1), ir::Reg(2)));
+
+  inst = OpaqueInstruction{};
+  EXPECT_FALSE(inst.ForEachUse([](ir::Reg) {}));
+
+  inst = nullptr;
+  EXPECT_TRUE(inst.ForEachUse([](ir::Reg) {}));
+}
+
+TEST(Inst, ReplaceUses) {
+  ir::Inst inst = StoreInstruction{
+      .values   = {ir::Reg(1), 2.0, ir::Reg(2)},
+      .location = ir::Value(ir::Reg(3)),
+  };
+  EXPECT_FALSE(inst.pure());
+  EXPECT_EQ(inst.result(), std::nullopt);
+
+  inst.ReplaceUses([](ir::Reg r) {
+    if (r == ir::Reg(1)) { return ir::Value(1.5); }
+    // Immediates of the wrong type are ignored.
+    if (r == ir::Reg(2)) { return ir::Value(int64_t{1}); }
+    return ir::Value(ir::Reg(4));
+  });
+  auto const& store = inst.as<StoreInstruction>();
+  EXPECT_THAT(store.values, ElementsAre(ir::RegOr<double>(1.5),
+                                        ir::RegOr<double>(2.0),
+                                        ir::RegOr<double>(ir::Reg(2))));
+  EXPECT_EQ(store.location, ir::Value(ir::Reg(4)));
+}
+
+TEST(Inst, SameOperands) {
+  ir::Inst a = AddInstruction{.lhs = ir::Reg(1), .rhs = 2, .result = ir::Reg(3)};
+  ir::Inst b = AddInstruction{.lhs = ir::Reg(1), .rhs = 2, .result = ir::Reg(4)};
+  ir::Inst c = AddInstruction{.lhs = ir::Reg(1), .rhs = 3, .result = ir::Reg(5)};
+  ASSERT_TRUE(a.value_numberable());
+  EXPECT_EQ(a.HashOperands(), b.HashOperands());
+  EXPECT_TRUE(a.SameOperands(b));
+  EXPECT_FALSE(a.SameOperands(c));
+  EXPECT_FALSE(
+      ir::Inst(StoreInstruction{.location = ir::Value()}).value_numberable());
+}
+
 }  // namespace
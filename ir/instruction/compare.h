@@ -16,6 +16,7 @@ struct EqInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = eq %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(lhs.value(), rhs.value()); }
   static bool Apply(num_type lhs, num_type rhs) { return lhs == rhs; }
@@ -31,6 +32,7 @@ struct NeInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = ne %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(lhs.value(), rhs.value()); }
   static bool Apply(num_type lhs, num_type rhs) { return lhs != rhs; }
@@ -46,6 +48,7 @@ struct LtInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = lt %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(lhs.value(), rhs.value()); }
   static bool Apply(num_type lhs, num_type rhs) { return lhs < rhs; }
@@ -61,6 +64,7 @@ struct LeInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   using num_type                                 = NumType;
   static constexpr std::string_view kDebugFormat = "%3$s = le %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(lhs.value(), rhs.value()); }
   static bool Apply(num_type lhs, num_type rhs) { return lhs <= rhs; }
@@ -1,20 +1,25 @@
 #ifndef ICARUS_IR_INSTRUCTION_CORE_H
 #define ICARUS_IR_INSTRUCTION_CORE_H
 
+#include <concepts>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/strings/str_cat.h"
 #include "base/extend.h"
 #include "ir/blocks/basic.h"
 #include "ir/byte_code_writer.h"
+#include "ir/instruction/base.h"
 #include "ir/instruction/debug.h"
 #include "ir/instruction/inliner.h"
 #include "ir/instruction/op_codes.h"
 #include "ir/interpreter/architecture.h"
 #include "ir/out_params.h"
 #include "ir/value/reg_or.h"
+#include "ir/value/value.h"
 
 namespace ir {
 // These instructions are required to appear in every instruction set. They
@@ -43,6 +48,15 @@ template <typename T>
 struct PhiInstruction {
   using type = T;
 
+  // Phi instructions are often constructed before their inputs are known, and
+  // are filled in by pointer after more instructions have been appended to the
+  // block, so they must not be stored inline.
+  static constexpr bool kRequiresStableAddress = true;
+
+  // Phi instructions have no side-effects, but because their value depends on
+  // the incoming block they are never folded or deduplicated.
+  static constexpr bool kPure = true;
+
   PhiInstruction() = default;
   PhiInstruction(std::vector<BasicBlock const*> blocks,
                  std::vector<RegOr<T>> values)
@@ -75,6 +89,41 @@ struct PhiInstruction {
     inliner.Inline(result);
   }
 
+  bool ReplaceUses(absl::FunctionRef<Value(Reg)> f) {
+    internal_instruction::ReplaceOperandUses(values, f);
+    return true;
+  }
+
+  void ReplaceIncomingBlocks(
+      absl::FunctionRef<BasicBlock const*(BasicBlock const*)> f) {
+    size_t n = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      if (BasicBlock const* b = f(blocks[i])) {
+        blocks[n]   = b;
+        values[n++] = values[i];
+      }
+    }
+    blocks.resize(n);
+    values.resize(n);
+  }
+
+  // If every incoming value other than the phi's own result is the same, the
+  // phi is equivalent to that value.
+  Value Simplify() const {
+    if constexpr (std::constructible_from<Value, RegOr<T> const&>) {
+      std::optional<RegOr<T>> common;
+      for (RegOr<T> const& v : values) {
+        if (v.is_reg() and v.reg() == result) { continue; }
+        if (common and not internal_instruction::SameOperand(*common, v)) {
+          return Value();
+        }
+        common = v;
+      }
+      if (common) { return Value(*common); }
+    }
+    return Value();
+  }
+
   std::vector<BasicBlock const*> blocks;
   std::vector<RegOr<T>> values;
   Reg result;
@@ -95,10 +144,19 @@ struct RegisterInstruction
     : base::Extend<RegisterInstruction<T>>::template With<
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = %1$s";
+  static constexpr bool kPure                    = true;
 
   T Resolve() const { return Apply(operand.value()); }
   static T Apply(T val) { return val; }
 
+  Value Simplify() const {
+    if constexpr (std::constructible_from<Value, RegOr<T> const&>) {
+      return Value(operand);
+    } else {
+      return Value();
+    }
+  }
+
   RegOr<T> operand;
   Reg result;
 };
@@ -176,6 +234,15 @@ struct CallInstruction {
     for (auto& reg : outs_.regs()) { inliner.Inline(reg); }
   }
 
+  // Output registers are reported as uses (for large types they hold the
+  // address to be written to) but are never replaced.
+  bool ReplaceUses(absl::FunctionRef<Value(Reg)> f) {
+    internal_instruction::ReplaceOperandUses(fn_, f);
+    internal_instruction::ReplaceOperandUses(args_, f);
+    for (Reg r : outs_.regs()) { f(r); }
+    return true;
+  }
+
  private:
   type::Function const* fn_type_;
   RegOr<Fn> fn_;
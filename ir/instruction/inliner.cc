@@ -36,7 +36,8 @@ InstructionInliner::InstructionInliner(
     block->jump_.Visit([&](auto& j) {
       constexpr auto type = base::meta<std::decay_t<decltype(j)>>;
       if constexpr (type == base::meta<JumpCmd::RetJump> or
-                    type == base::meta<JumpCmd::JumpExitJump>) {
+                    type == base::meta<JumpCmd::JumpExitJump> or
+                    type == base::meta<JumpCmd::UnreachableJump>) {
         // Nothing to do.
       } else if constexpr (type == base::meta<JumpCmd::UncondJump>) {
         to_visit.push(j.block);
@@ -72,13 +73,16 @@ InstructionInliner::InstructionInliner(
     // because we may request a jump downwards (i.e., to a block which we have
     // not yet seen). In other words, we have to make sure that any jump which
     // needs to be updated, the block mapping is already present.
-    blocks_.emplace(
-        block_to_copy,
-        into->AppendBlock(
-            *block_to_copy,
-            BasicBlock::DebugInfo{
-                .header = absl::StrCat("Jump: ", block_to_copy->debug().header),
-                .cluster_index = index}));
+    //
+    // The copy is made member-wise rather than with `BasicBlock`'s copy
+    // constructor, which would register the copy as an incoming block of the
+    // original's successors. Incoming blocks are set up in `InlineJump`.
+    auto* block = into->AppendBlock(BasicBlock::DebugInfo{
+        .header        = absl::StrCat("Jump: ", block_to_copy->debug().header),
+        .cluster_index = index});
+    block->instructions_ = block_to_copy->instructions_;
+    block->jump_         = block_to_copy->jump_;
+    blocks_.emplace(block_to_copy, block);
   }
 }
 
@@ -93,10 +97,10 @@ void InstructionInliner::Inline(BasicBlock*& block,
 void InstructionInliner::InlineJump(BasicBlock* block) {
   block->jump_.Visit([&](auto& j) {
     constexpr auto type = base::meta<std::decay_t<decltype(j)>>;
-    if constexpr (type == base::meta<JumpCmd::UnreachableJump>) {
-      UNREACHABLE(*block);
-    } else if constexpr (type == base::meta<JumpCmd::RetJump>) {
-      UNREACHABLE(*block);
+    if constexpr (type == base::meta<JumpCmd::UnreachableJump> or
+                  type == base::meta<JumpCmd::RetJump>) {
+      // Nothing to do. Returns only appear when inlining functions, in which
+      // case the caller of the inliner is responsible for replacing them.
     } else if constexpr (type == base::meta<JumpCmd::JumpExitJump>) {
       LOG("InlineJump", "%s %p %p", j.name, j.choose_block,
           blocks_.at(j.choose_block));
@@ -144,6 +148,8 @@ void InstructionInliner::InlineJump(BasicBlock* block) {
 }
 
 BasicBlock* InstructionInliner::InlineAllBlocks() {
+  ASSERT(into_->complete() == false);
+
   // Update the register count. This must be done after we've added the
   // register-forwarding instructions which use this count to choose a register
   // number.
@@ -153,7 +159,13 @@ BasicBlock* InstructionInliner::InlineAllBlocks() {
   });
 
   for (auto [ignored, block] : blocks_) {
-    for (auto& inst : block->instructions_) { inst->Inline(*this); }
+    for (auto& inst : block->instructions_) {
+      inst->Inline(*this);
+      inst.ReplaceIncomingBlocks([&](BasicBlock const* b) -> BasicBlock const* {
+        auto iter = blocks_.find(b);
+        return iter == blocks_.end() ? b : iter->second;
+      });
+    }
     InlineJump(block);
   }
 
@@ -28,10 +28,15 @@ struct InstructionInliner {
   void Inline(T &v) const {
     constexpr auto type = base::meta<T>;
     if constexpr (type == base::meta<Reg>) {
+      // Output registers refer to the caller's storage and are left for the
+      // caller of the inliner to rewrite.
+      if (v.is_out()) { return; }
+      // Value registers are numbered starting at `num_args()`, so offsetting
+      // both kinds by the same amount keeps them disjoint.
       if (v.is_arg()) {
         v = Reg(v.arg_value() + register_offset_);
       } else {
-        v = Reg(v.value() + register_offset_ + to_be_inlined_->num_args());
+        v = Reg(v.value() + register_offset_);
       }
     } else if constexpr (type.template is_a<RegOr>()) {
       if (v.is_reg()) {
@@ -1,7 +1,11 @@
 #ifndef ICARUS_IR_INSTRUCTION_INSTRUCTIONS_H
 #define ICARUS_IR_INSTRUCTION_INSTRUCTIONS_H
 
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <variant>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
@@ -47,6 +51,7 @@ struct CastInstruction<ToType(FromType)>
   using from_type                                = FromType;
   using to_type                                  = ToType;
   static constexpr std::string_view kDebugFormat = "%2$s = cast %1$s";
+  static constexpr bool kPure                    = true;
 
   ToType Resolve() const {
     if constexpr (base::meta<ToType> == base::meta<ir::Char>) {
@@ -68,6 +73,7 @@ struct PtrDiffInstruction
     : base::Extend<PtrDiffInstruction>::With<ByteCodeExtension, InlineExtension,
                                              DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = ptrdiff %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   void Apply(interpreter::ExecutionContext& ctx) const {
     ctx.current_frame().regs_.set(
@@ -85,6 +91,7 @@ struct NotInstruction
     : base::Extend<NotInstruction>::With<ByteCodeExtension, InlineExtension,
                                          DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = not %1$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(operand.value()); }
   static bool Apply(bool operand) { return not operand; }
@@ -280,6 +287,103 @@ struct MoveInitInstruction
   }
 };
 
+// Copies `count` contiguous objects of the trivially copyable type `type` from
+// `from` to `to`. The two ranges must either be disjoint or identical.
+struct MemCopyInstruction
+    : base::Extend<MemCopyInstruction>::With<
+          ByteCodeExtension, InlineExtension, DebugFormatExtension> {
+  static constexpr std::string_view kDebugFormat =
+      "memcpy %4$s %3$s from %1$s to %2$s";
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    std::memcpy(ctx.resolve(to), ctx.resolve(from),
+                (core::FwdAlign(type.bytes(interpreter::kArchitecture),
+                                type.alignment(interpreter::kArchitecture)) *
+                 ctx.resolve(count))
+                    .value());
+  }
+
+  RegOr<addr_t> from;
+  RegOr<addr_t> to;
+  type::Type type;
+  RegOr<uint64_t> count;
+};
+
+// Sets every byte of `count` contiguous objects of type `type` at `to` to
+// `value`.
+struct MemSetInstruction
+    : base::Extend<MemSetInstruction>::With<ByteCodeExtension, InlineExtension,
+                                            DebugFormatExtension> {
+  static constexpr std::string_view kDebugFormat =
+      "memset %4$s %3$s at %1$s to %2$s";
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    std::memset(ctx.resolve(to), ctx.resolve(value),
+                (core::FwdAlign(type.bytes(interpreter::kArchitecture),
+                                type.alignment(interpreter::kArchitecture)) *
+                 ctx.resolve(count))
+                    .value());
+  }
+
+  RegOr<addr_t> to;
+  RegOr<uint8_t> value;
+  type::Type type;
+  RegOr<uint64_t> count;
+};
+
+// Compares the first `bytes` bytes at `lhs` and `rhs` as `std::memcmp` does.
+struct MemCompareInstruction
+    : base::Extend<MemCompareInstruction>::With<
+          ByteCodeExtension, InlineExtension, DebugFormatExtension> {
+  static constexpr std::string_view kDebugFormat =
+      "%4$s = memcmp %3$s bytes at %1$s and %2$s";
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    ctx.current_frame().regs_.set(
+        result, static_cast<int32_t>(std::memcmp(
+                    ctx.resolve(lhs), ctx.resolve(rhs), ctx.resolve(bytes))));
+  }
+
+  RegOr<addr_t> lhs;
+  RegOr<addr_t> rhs;
+  RegOr<uint64_t> bytes;
+  Reg result;
+};
+
+// Allocates uninitialized heap storage for `count` contiguous objects of type
+// `type`, to be released with a `FreeInstruction`.
+struct MallocInstruction
+    : base::Extend<MallocInstruction>::With<ByteCodeExtension, InlineExtension,
+                                            DebugFormatExtension> {
+  static constexpr std::string_view kDebugFormat = "%3$s = malloc %2$s %1$s";
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    ctx.current_frame().regs_.set(
+        result,
+        static_cast<addr_t>(std::malloc(
+            (core::FwdAlign(type.bytes(interpreter::kArchitecture),
+                            type.alignment(interpreter::kArchitecture)) *
+             ctx.resolve(count))
+                .value())));
+  }
+
+  type::Type type;
+  RegOr<uint64_t> count;
+  Reg result;
+};
+
+struct FreeInstruction
+    : base::Extend<FreeInstruction>::With<ByteCodeExtension, InlineExtension,
+                                          DebugFormatExtension> {
+  static constexpr std::string_view kDebugFormat = "free %1$s";
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    std::free(ctx.resolve(addr));
+  }
+
+  RegOr<addr_t> addr;
+};
+
 [[noreturn]] inline void FatalInterpreterError(std::string_view err_msg) {
   // TODO: Add a diagnostic explaining the failure.
   absl::FPrintF(stderr,
@@ -294,29 +398,83 @@ struct MoveInitInstruction
 }
 
 struct LoadSymbolInstruction
-    : base::Extend<LoadSymbolInstruction>::With<
-          ByteCodeExtension, InlineExtension, DebugFormatExtension> {
+    : base::Extend<LoadSymbolInstruction>::With<InlineExtension,
+                                                DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat =
       "%3$s = load-symbol %1$s: %2$s";
 
-  void Apply(interpreter::ExecutionContext& ctx) const {
+  // The value of the symbol, or a description of why it could not be loaded.
+  struct Resolved {
+    void Apply(interpreter::ExecutionContext& ctx) const {
+      if (auto const* fn = std::get_if<Fn>(&symbol)) {
+        ctx.current_frame().regs_.set(result, *fn);
+      } else if (auto const* addr = std::get_if<addr_t>(&symbol)) {
+        ctx.current_frame().regs_.set(result, *addr);
+      } else {
+        FatalInterpreterError(std::get<std::string>(symbol));
+      }
+    }
+
+    std::variant<std::string, Fn, addr_t> symbol;
+    Reg result;
+  };
+
+  // Named so as not to be mistaken by the interpreter for an instruction whose
+  // result is computed by `Resolve`.
+  Resolved ResolveSymbol() const {
     // TODO: We could probably extract this into two separate instructions (one
     // for functions and one for pointers) so that we can surface errors during
     // code-gen without the UNREACHABLE.
     if (auto* fn_type = type.if_as<type::Function>()) {
       auto sym = interpreter::LoadFunctionSymbol(name);
-      if (not sym.ok()) { FatalInterpreterError(sym.status().message()); }
-      ctx.current_frame().regs_.set(result,
-                                    ir::Fn(ir::ForeignFn(*sym, fn_type)));
+      if (not sym.ok()) {
+        return {.symbol = std::string(sym.status().message()),
+                .result = result};
+      }
+      return {.symbol = Fn(ForeignFn(*sym, fn_type)), .result = result};
     } else if (type.is<type::Pointer>()) {
       absl::StatusOr<void*> sym = interpreter::LoadDataSymbol(name);
-      if (not sym.ok()) { FatalInterpreterError(sym.status().message()); }
-      ctx.current_frame().regs_.set(result, ir::Addr(*sym));
+      if (not sym.ok()) {
+        return {.symbol = std::string(sym.status().message()),
+                .result = result};
+      }
+      return {.symbol = Addr(*sym), .result = result};
     } else {
       UNREACHABLE(type.to_string());
     }
   }
 
+  // Symbols are resolved once, when byte code is written, rather than each time
+  // the instruction is executed. A symbol which cannot be found is only
+  // reported as an error if the instruction is executed.
+  void WriteByteCode(ByteCodeWriter* writer) const {
+    Resolved resolved = ResolveSymbol();
+    writer->Write(static_cast<uint8_t>(resolved.symbol.index()));
+    std::visit([&](auto const& symbol) { writer->Write(symbol); },
+               resolved.symbol);
+    writer->Write(resolved.result);
+  }
+
+  static Resolved ReadFromByteCode(base::untyped_buffer::const_iterator* iter) {
+    Resolved resolved;
+    switch (ir::ReadFromByteCode<uint8_t>(iter)) {
+      case 0: {
+        std::string message;
+        internal::ReadInto(message, iter);
+        resolved.symbol = std::move(message);
+      } break;
+      case 1: resolved.symbol = ir::ReadFromByteCode<Fn>(iter); break;
+      case 2: resolved.symbol = ir::ReadFromByteCode<addr_t>(iter); break;
+      default: UNREACHABLE();
+    }
+    resolved.result = ir::ReadFromByteCode<Reg>(iter);
+    return resolved;
+  }
+
+  void Apply(interpreter::ExecutionContext& ctx) const {
+    ResolveSymbol().Apply(ctx);
+  }
+
   std::string name;
   type::Type type;
   Reg result;
@@ -327,6 +485,10 @@ struct TypeInfoInstruction
                                               InlineExtension> {
   enum class Kind : uint8_t { Alignment = 0, Bytes = 2 };
 
+  static constexpr bool kPure = true;
+  // Type layouts may not be complete when the function is optimized.
+  static constexpr bool kFoldable = false;
+
   std::string to_string() const {
     using base::stringify;
     return absl::StrCat(
@@ -407,6 +569,9 @@ struct StructIndexInstruction
           ByteCodeExtension, InlineExtension, DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat =
       "%4$s = index %2$s of %1$s (struct %3$s)";
+  static constexpr bool kPure = true;
+  // Type layouts may not be complete when the function is optimized.
+  static constexpr bool kFoldable = false;
 
   addr_t Resolve() const {
     return addr.value() +
@@ -425,6 +590,9 @@ struct PtrIncrInstruction
                                              DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat =
       "%4$s = index %2$s of %1$s (pointer %3$s)";
+  static constexpr bool kPure = true;
+  // Type layouts may not be complete when the function is optimized.
+  static constexpr bool kFoldable = false;
 
   addr_t Resolve() const {
     return addr.value() +
@@ -445,6 +613,7 @@ struct AndInstruction
     : base::Extend<AndInstruction>::With<ByteCodeExtension, InlineExtension,
                                          DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = and %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   bool Resolve() const { return Apply(lhs.value(), rhs.value()); }
   static bool Apply(bool lhs, bool rhs) { return lhs and rhs; }
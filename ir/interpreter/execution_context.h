@@ -8,6 +8,7 @@
 #include "absl/types/span.h"
 #include "base/untyped_buffer.h"
 #include "base/untyped_buffer_view.h"
+#include "ir/byte_code_writer.h"
 #include "ir/instruction/core.h"
 #include "ir/interpreter/architecture.h"
 #include "ir/interpreter/foreign.h"
@@ -42,14 +43,14 @@ struct StackFrameIterator {
     byte_code_iter_.skip(offset);
   }
 
-  // Reads exactly `num` uintptr_t's starting at `iter` and returns the index of
-  // the one whose value was the previous index. Behavior is undefined if zero
-  // or more than one such value matches.
+  // Reads exactly `num` block offsets starting at `iter` and returns the index
+  // of the one whose value was the previous index. Behavior is undefined if
+  // zero or more than one such value matches.
   uintptr_t IndexMatchingPrevious(base::untyped_buffer::const_iterator &iter,
                                   size_t num) {
     uint64_t index = std::numeric_limits<uint64_t>::max();
     for (size_t i = 0; i < num; ++i) {
-      if (prev_index_ == iter.read<uintptr_t>()) {
+      if (prev_index_ == ir::ReadFromByteCode<ir::block_offset_t>(&iter)) {
         ASSERT(index == std::numeric_limits<uint64_t>::max());
         index = i;
       }
@@ -136,24 +137,27 @@ struct ExecutionContext {
         current_frame_->fn().native(), *current_frame_);
     auto &iter = frame_iter.byte_code_iterator();
     while (true) {
-      ir::cmd_index_t cmd_index = iter.read<ir::cmd_index_t>();
+      auto cmd_index = ir::ReadFromByteCode<ir::cmd_index_t>(&iter);
       switch (cmd_index) {
         case ir::internal::kReturnInstruction: return;
         case ir::internal::kUncondJumpInstruction: {
-          uintptr_t offset = iter.read<uintptr_t>();
+          uintptr_t offset = ir::ReadFromByteCode<ir::block_offset_t>(&iter);
           frame_iter.MoveTo(offset);
         } break;
         case ir::internal::kCondJumpInstruction: {
-          ir::Reg r             = iter.read<ir::Reg>();
-          uintptr_t true_block  = iter.read<uintptr_t>();
-          uintptr_t false_block = iter.read<uintptr_t>();
+          ir::Reg r = ir::ReadFromByteCode<ir::Reg>(&iter);
+          uintptr_t true_block =
+              ir::ReadFromByteCode<ir::block_offset_t>(&iter);
+          uintptr_t false_block =
+              ir::ReadFromByteCode<ir::block_offset_t>(&iter);
           uintptr_t offset      = resolve<bool>(r) ? true_block : false_block;
           frame_iter.MoveTo(offset);
         } break;
         case ir::LoadInstruction::kIndex: {
-          uint16_t num_bytes = iter.read<uint16_t>();
-          ir::addr_t addr      = resolve(iter.read<ir::RegOr<ir::addr_t>>().get());
-          auto result_reg    = iter.read<ir::Reg>().get();
+          uint16_t num_bytes = ir::ReadFromByteCode<uint16_t>(&iter);
+          ir::addr_t addr =
+              resolve(ir::ReadFromByteCode<ir::RegOr<ir::addr_t>>(&iter));
+          ir::Reg result_reg = ir::ReadFromByteCode<ir::Reg>(&iter);
           Load(result_reg, addr, core::Bytes(num_bytes));
         } break;
 
@@ -190,7 +194,7 @@ struct ExecutionContext {
       auto *iter = &frame_iter.byte_code_iterator();
 
       if constexpr (base::meta<Inst> == base::meta<ir::CallInstruction>) {
-        ir::Fn f = ctx.resolve(iter->read<ir::RegOr<ir::Fn>>().get());
+        ir::Fn f = ctx.resolve(ir::ReadFromByteCode<ir::RegOr<ir::Fn>>(iter));
 
         type::Function const *fn_type = f.type();
         LOG("CallInstruction", "%s: %s", f, fn_type->to_string());
@@ -199,9 +203,9 @@ struct ExecutionContext {
 
         // TODO: you probably want interpreter::Arguments or something.
         size_t num_inputs = fn_type->params().size();
-        size_t num_args = iter->read<uint16_t>();
+        size_t num_args = ir::ReadFromByteCode<uint16_t>(iter);
         for (size_t i = 0; i < num_args; ++i) {
-          ir::Value arg = iter->read<ir::Value>();
+          ir::Value arg = ir::ReadFromByteCode<ir::Value>(iter);
           if (auto *reg = arg.get_if<ir::Reg>()) {
             frame.regs_.set_raw(ir::Reg::Arg(i),
                                 ctx.current_frame().regs_.raw(*reg),
@@ -216,10 +220,10 @@ struct ExecutionContext {
           }
         }
 
-        uint16_t num_rets = iter->read<uint16_t>();
+        uint16_t num_rets = ir::ReadFromByteCode<uint16_t>(iter);
 
         for (uint16_t i = 0; i < num_rets; ++i) {
-          ir::Reg reg  = iter->read<ir::Reg>();
+          ir::Reg reg  = ir::ReadFromByteCode<ir::Reg>(iter);
           type::Type t = fn_type->output()[i];
           ir::addr_t out_addr = t.is_big() ? ctx.resolve<ir::addr_t>(reg)
                                            : ctx.current_frame().regs_.raw(reg);
@@ -231,7 +235,7 @@ struct ExecutionContext {
 
       } else if constexpr (
           base::meta<Inst>.template is_a<ir::PhiInstruction>()) {
-        uint16_t num   = iter->read<uint16_t>();
+        uint16_t num   = ir::ReadFromByteCode<uint16_t>(iter);
         uint64_t index = frame_iter.IndexMatchingPrevious(*iter, num);
 
         using type = typename Inst::type;
@@ -240,19 +244,21 @@ struct ExecutionContext {
         type *result = reinterpret_cast<type *>(result_buffer);
         for (uint16_t i = 0; i < num; ++i) {
           if (i == index) {
-            new (result) type(ctx.resolve(iter->read<ir::RegOr<type>>().get()));
+            new (result)
+                type(ctx.resolve(ir::ReadFromByteCode<ir::RegOr<type>>(iter)));
           } else {
-            iter->read<ir::RegOr<type>>();
+            ir::ReadFromByteCode<ir::RegOr<type>>(iter);
           }
         }
 
-        ctx.current_frame().regs_.set(iter->read<ir::Reg>(), *result);
+        ctx.current_frame().regs_.set(ir::ReadFromByteCode<ir::Reg>(iter),
+                                      *result);
       } else if constexpr (
           base::meta<Inst>.template is_a<ir::SetReturnInstruction>()) {
         using type        = typename Inst::type;
-        uint16_t n        = iter->read<uint16_t>();
+        uint16_t n          = ir::ReadFromByteCode<uint16_t>(iter);
         ir::addr_t ret_slot = ctx.resolve<ir::addr_t>(ir::Reg::Out(n));
-        type val          = ctx.resolve(iter->read<ir::RegOr<type>>().get());
+        type val = ctx.resolve(ir::ReadFromByteCode<ir::RegOr<type>>(iter));
         *ASSERT_NOT_NULL(reinterpret_cast<type *>(ret_slot)) = val;
       } else if constexpr (internal_execution::HasResolveMemberFunction<Inst>) {
         auto inst = Inst::ReadFromByteCode(iter);
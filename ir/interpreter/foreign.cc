@@ -3,12 +3,17 @@
 #include <dlfcn.h>
 #include <ffi.h>
 
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "base/debug.h"
+#include "base/guarded.h"
+#include "base/no_destructor.h"
 #include "ir/read_only_data.h"
 #include "ir/value/value.h"
 #include "type/function.h"
@@ -18,21 +23,38 @@
 namespace interpreter {
 using void_fn_ptr = void (*)();
 
-absl::StatusOr<void *> LoadDataSymbol(std::string_view name) {
+namespace {
+
+// Symbols do not move once loaded, so each successful lookup is cached to avoid
+// repeated calls to `dlsym`.
+absl::StatusOr<void *> LoadSymbol(std::string_view name) {
+  static base::NoDestructor<
+      base::guarded<absl::flat_hash_map<std::string, void *>>>
+      symbols;
+  auto handle = symbols->lock();
+  if (auto iter = handle->find(name); iter != handle->end()) {
+    return iter->second;
+  }
+
+  std::string name_str(name);
   dlerror();  // Clear previous errors.
-  void *result    = dlsym(RTLD_DEFAULT, std::string(name).c_str());
+  void *result    = dlsym(RTLD_DEFAULT, name_str.c_str());
   char const *err = dlerror();
-  if (not err) { return result; }
-  return absl::NotFoundError(err);
+  if (err) { return absl::NotFoundError(err); }
+  handle->emplace(std::move(name_str), result);
+  return result;
+}
+
+}  // namespace
+
+absl::StatusOr<void *> LoadDataSymbol(std::string_view name) {
+  return LoadSymbol(name);
 }
 
 absl::StatusOr<void_fn_ptr> LoadFunctionSymbol(std::string_view name) {
-  dlerror();  // Clear previous errors.
-  auto result = reinterpret_cast<void_fn_ptr>(
-      dlsym(RTLD_DEFAULT, std::string(name).c_str()));
-  char const *err = dlerror();
-  if (not err) { return result; }
-  return absl::NotFoundError(err);
+  absl::StatusOr<void *> result = LoadSymbol(name);
+  if (not result.ok()) { return result.status(); }
+  return reinterpret_cast<void_fn_ptr>(*result);
 }
 
 }  // namespace interpreter
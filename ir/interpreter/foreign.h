@@ -12,6 +12,8 @@
 
 namespace interpreter {
 
+// Returns the address of the symbol `name`. Successful lookups are cached, so
+// these may be called repeatedly without repeatedly calling `dlsym`.
 absl::StatusOr<void *> LoadDataSymbol(std::string_view name);
 absl::StatusOr<void (*)()> LoadFunctionSymbol(std::string_view name);
 
@@ -0,0 +1,51 @@
+// Measures the cost of the lookups performed each time a foreign function is
+// loaded and called from the interpreter, as in print-heavy loops such as
+// `examples/fizzbuzz.ic`. Run with `bazel run -c opt`.
+
+#include <dlfcn.h>
+
+#include <cstdio>
+#include <string>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ir/interpreter/foreign.h"
+#include "ir/value/foreign_fn.h"
+
+namespace {
+
+constexpr int kIterations = 1'000'000;
+
+template <typename Fn>
+void Time(char const *name, Fn &&f) {
+  absl::Time start = absl::Now();
+  for (int i = 0; i < kIterations; ++i) { f(); }
+  absl::Duration elapsed = absl::Now() - start;
+  std::printf("%-24s %8.1f ns/iteration\n", name,
+              absl::ToDoubleNanoseconds(elapsed) / kIterations);
+}
+
+}  // namespace
+
+int main() {
+  // The lookup performed on every execution before symbols were cached.
+  Time("dlsym", [] {
+    void *volatile sym = dlsym(RTLD_DEFAULT, std::string("printf").c_str());
+    (void)sym;
+  });
+  Time("LoadFunctionSymbol", [] {
+    auto volatile sym = *interpreter::LoadFunctionSymbol("printf");
+    (void)sym;
+  });
+
+  ir::ForeignFn f(*interpreter::LoadFunctionSymbol("printf"), nullptr);
+  Time("ForeignFn::get", [&] {
+    auto volatile fn = f.get();
+    (void)fn;
+  });
+  Time("ForeignFn::type", [&] {
+    auto volatile t = f.type();
+    (void)t;
+  });
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include "ir/read_only_data.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace ir {
+
+addr_t ReadOnlyData::Intern(std::string_view bytes) {
+  if (auto iter = constants_.find(bytes); iter != constants_.end()) {
+    return Addr(iter->data());
+  }
+
+  // Constants are never freed; their addresses may be embedded in IR for the
+  // lifetime of the program.
+  auto *data = static_cast<char *>(
+      ::operator new(std::max<size_t>(bytes.size(), 1),
+                     std::align_val_t(kAlignment)));
+  std::memcpy(data, bytes.data(), bytes.size());
+  constants_.emplace(data, bytes.size());
+  sizes_.emplace(data, bytes.size());
+  return data;
+}
+
+std::optional<std::string_view> ReadOnlyData::Find(addr_t addr) const {
+  auto iter = sizes_.find(addr);
+  if (iter == sizes_.end()) { return std::nullopt; }
+  return std::string_view(addr, iter->second);
+}
+
+}  // namespace ir
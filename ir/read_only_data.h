@@ -1,4 +1,45 @@
 #ifndef ICARUS_IR_READ_ONLY_DATA_H
 #define ICARUS_IR_READ_ONLY_DATA_H
 
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "base/global.h"
+#include "ir/value/addr.h"
+
+namespace ir {
+
+// ReadOnlyData:
+//
+// Holds the bytes of big constants computed at compile time. Each distinct
+// sequence of bytes is stored exactly once and is never moved or freed, so
+// that every use of a constant, however many times it is loaded, refers to the
+// same `addr_t`. Backends emitting native code may emit each constant as a
+// read-only global, so constants whose bytes hold addresses within the compiler
+// (e.g., pointers, slices, or functions) must not be stored here.
+struct ReadOnlyData {
+  // Every constant is aligned to at least this many bytes, which suffices for
+  // any type.
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+  // Returns the address of a read-only copy of `bytes`, reusing an existing
+  // copy if these bytes have been stored before.
+  addr_t Intern(std::string_view bytes);
+
+  // Returns the bytes of the constant starting at `addr`, or `std::nullopt` if
+  // `addr` is not the address of a constant returned by `Intern`.
+  std::optional<std::string_view> Find(addr_t addr) const;
+
+ private:
+  absl::flat_hash_set<std::string_view> constants_;
+  absl::flat_hash_map<addr_t, size_t> sizes_;
+};
+
+inline base::Global<ReadOnlyData> GlobalReadOnlyData;
+
+}  // namespace ir
+
 #endif  //  ICARUS_IR_READ_ONLY_DATA_H
@@ -0,0 +1,51 @@
+#include "ir/read_only_data.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace ir {
+namespace {
+
+using ::testing::Optional;
+
+TEST(ReadOnlyData, DeduplicatesByContent) {
+  ReadOnlyData data;
+  std::string a = "abc";
+  std::string b = "abc";
+  addr_t addr   = data.Intern(a);
+  EXPECT_EQ(data.Intern(b), addr);
+  EXPECT_NE(data.Intern("abd"), addr);
+  EXPECT_NE(data.Intern("ab"), addr);
+}
+
+TEST(ReadOnlyData, ContentsAreCopied) {
+  ReadOnlyData data;
+  std::string s = "hello";
+  addr_t addr   = data.Intern(s);
+  s[0]          = 'j';
+  EXPECT_EQ(std::string_view(addr, 5), "hello");
+  EXPECT_NE(data.Intern(s), addr);
+}
+
+TEST(ReadOnlyData, Aligned) {
+  ReadOnlyData data;
+  for (std::string_view s : {"", "a", "bc", "def", "0123456789abcdefg"}) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data.Intern(s)) %
+                  ReadOnlyData::kAlignment,
+              0u);
+  }
+}
+
+TEST(ReadOnlyData, Find) {
+  ReadOnlyData data;
+  addr_t addr = data.Intern("xyz");
+  EXPECT_THAT(data.Find(addr), Optional(std::string_view("xyz")));
+  EXPECT_EQ(data.Find(addr + 1), std::nullopt);
+  EXPECT_EQ(data.Find(nullptr), std::nullopt);
+}
+
+}  // namespace
+}  // namespace ir
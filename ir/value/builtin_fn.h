@@ -22,7 +22,12 @@ struct BuiltinFn : base::Extend<BuiltinFn, 1>::With<base::EqualityExtension> {
     Opaque,
     Foreign,
     Slice,
-    DebugIr
+    DebugIr,
+    MemCopy,
+    MemSet,
+    MemCompare,
+    Malloc,
+    Free
   };
   explicit constexpr BuiltinFn(Which w) : which_(w) {}
 
@@ -34,6 +39,11 @@ struct BuiltinFn : base::Extend<BuiltinFn, 1>::With<base::EqualityExtension> {
   static BuiltinFn Foreign() { return BuiltinFn(Which::Foreign); }
   static BuiltinFn Slice() { return BuiltinFn(Which::Slice); }
   static BuiltinFn DebugIr() { return BuiltinFn(Which::DebugIr); }
+  static BuiltinFn MemCopy() { return BuiltinFn(Which::MemCopy); }
+  static BuiltinFn MemSet() { return BuiltinFn(Which::MemSet); }
+  static BuiltinFn MemCompare() { return BuiltinFn(Which::MemCompare); }
+  static BuiltinFn Malloc() { return BuiltinFn(Which::Malloc); }
+  static BuiltinFn Free() { return BuiltinFn(Which::Free); }
 
   static std::optional<BuiltinFn> ByName(std::string_view name) {
     size_t i = 0;
@@ -53,9 +63,13 @@ struct BuiltinFn : base::Extend<BuiltinFn, 1>::With<base::EqualityExtension> {
  private:
   friend base::EnableExtensions;
 
-  static constexpr std::array kNames{"abort",    "alignment", "bytes",
-                                     "callable", "opaque",    "foreign",
-                                     "slice",    "debug_ir"};
+  // Builtin names are keywords, so those of the memory intrinsics are prefixed
+  // to leave the C library names free for `foreign` declarations.
+  static constexpr std::array kNames{
+      "abort",          "alignment",      "bytes",          "callable",
+      "opaque",         "foreign",        "slice",          "debug_ir",
+      "builtin_memcpy", "builtin_memset", "builtin_memcmp", "builtin_malloc",
+      "builtin_free"};
 
   Which which_;
 };
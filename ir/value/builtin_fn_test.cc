@@ -15,7 +15,15 @@ TEST(BuiltinFn, ByName) {
   EXPECT_THAT(ir::BuiltinFn::ByName("foreign"),
               Optional(ir::BuiltinFn::Foreign()));
 
+  EXPECT_THAT(ir::BuiltinFn::ByName("builtin_memcpy"),
+              Optional(ir::BuiltinFn::MemCopy()));
+  EXPECT_THAT(ir::BuiltinFn::ByName("builtin_free"),
+              Optional(ir::BuiltinFn::Free()));
+
   EXPECT_EQ(ir::BuiltinFn::ByName("FOREIGN"), std::nullopt);
+  // C library names remain available for `foreign` declarations.
+  EXPECT_EQ(ir::BuiltinFn::ByName("malloc"), std::nullopt);
+  EXPECT_EQ(ir::BuiltinFn::ByName("free"), std::nullopt);
 }
 
 }  // namespace
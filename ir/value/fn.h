@@ -57,10 +57,16 @@ struct Fn : base::Extend<Fn, 1>::With<base::AbslHashExtension> {
           case BuiltinFn::Which::Opaque: return type::Func({}, {type::Type_});
           case BuiltinFn::Which::Slice:
           case BuiltinFn::Which::Foreign:
-            // Note: We do not allow passing `foreign` or `slice` around as a
-            // function object. It is call-only, which means the generic part
-            // can be handled in the type checker. The value here may be stored,
-            // but it will never be accessed again.
+          case BuiltinFn::Which::MemCopy:
+          case BuiltinFn::Which::MemSet:
+          case BuiltinFn::Which::MemCompare:
+          case BuiltinFn::Which::Malloc:
+          case BuiltinFn::Which::Free:
+            // Note: We do not allow passing `foreign`, `slice`, or the memory
+            // intrinsics around as a function object. They are call-only,
+            // which means the generic part can be handled in the type checker.
+            // The value here may be stored, but it will never be accessed
+            // again.
             //
             // TODO: Why not allow passing it around?
             return nullptr;
@@ -1,9 +1,7 @@
 #include "ir/value/foreign_fn.h"
 
-#include "absl/container/flat_hash_map.h"
 #include "base/debug.h"
 #include "base/flyweight_map.h"
-#include "base/guarded.h"
 
 namespace ir {
 
@@ -44,19 +42,22 @@ struct ForeignFnData {
   }
 };
 
-base::guarded<base::flyweight_map<ForeignFnData>> foreign_fns;
+// Foreign functions are created rarely (once per `foreign` call site when byte
+// code is emitted) but their function pointer and type are read on every call,
+// so lookups by id must not take a lock.
+base::concurrent_flyweight_map<ForeignFnData> foreign_fns;
 
 }  // namespace
 
 ForeignFn::ForeignFn(void (*fn)(), type::Function const *t)
-    : id_(foreign_fns.lock()->get(ForeignFnData{fn, t})) {}
+    : id_(foreign_fns.get(ForeignFnData{fn, t})) {}
 
 type::Function const *ForeignFn::type() const {
-  return foreign_fns.lock()->get(id_).type;
+  return foreign_fns.get(id_).type;
 }
 
 ForeignFn::void_fn_ptr ForeignFn::get() const {
-  return foreign_fns.lock()->get(id_).fn;
+  return foreign_fns.get(id_).fn;
 }
 
 }  // namespace ir
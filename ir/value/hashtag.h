@@ -12,6 +12,9 @@ enum class Hashtag : uint8_t {
   Export     = 0,
   Uncopyable = 1,
   Immovable  = 2,
+  // Allows a struct's fields to be laid out in memory in an order other than
+  // the one in which they are declared, so as to minimize padding.
+  Compact    = 3,
 };
 
 inline constexpr std::string_view ToStringView(Hashtag h) {
@@ -19,6 +22,7 @@ inline constexpr std::string_view ToStringView(Hashtag h) {
     case Hashtag::Export: return "{export}";
     case Hashtag::Uncopyable: return "{uncopyable}";
     case Hashtag::Immovable: return "{immovable}";
+    case Hashtag::Compact: return "{compact}";
   }
 }
 
@@ -30,6 +34,7 @@ inline std::array BuiltinHashtagsByName{
     std::pair(std::string_view("{export}"), Hashtag::Export),
     std::pair(std::string_view("{uncopyable}"), Hashtag::Uncopyable),
     std::pair(std::string_view("{immovable}"), Hashtag::Immovable),
+    std::pair(std::string_view("{compact}"), Hashtag::Compact),
 };
 
 }  // namespace ir
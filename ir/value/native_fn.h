@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "absl/strings/str_format.h"
+#include "base/debug.h"
 #include "base/extend.h"
 #include "base/extend/absl_hash.h"
 #include "ir/compiled_fn.h"
@@ -23,7 +24,6 @@ struct NativeFn : base::Extend<NativeFn, 1>::With<base::AbslHashExtension> {
   struct Data {
     CompiledFn *fn;
     type::Function const *type;
-    base::untyped_buffer::const_iterator byte_code;
   };
 
   explicit NativeFn(Data const *data = nullptr);
@@ -32,8 +32,11 @@ struct NativeFn : base::Extend<NativeFn, 1>::With<base::AbslHashExtension> {
 
   type::Function const *type() const;
 
+  // Returns an iterator to the start of the byte code for this function.
+  // Byte code must have been emitted (and not since invalidated) before this
+  // function can be called.
   base::untyped_buffer::const_iterator byte_code_iterator() const {
-    return data_->byte_code;
+    return ASSERT_NOT_NULL(data_->fn->byte_code())->begin();
   }
 
   CompiledFn *operator->() { return data_->fn; }
@@ -54,4 +54,23 @@ TEST(NativeFn, Value) {
   EXPECT_EQ(&*f, &cf);
 }
 
+TEST(NativeFn, ByteCode) {
+  auto *fn_type = type::Func(core::Params<type::QualType>{}, {});
+
+  ir::CompiledFn cf(fn_type, {});
+  ir::NativeFn::Data d{
+      .fn   = &cf,
+      .type = fn_type,
+  };
+  ir::NativeFn f(&d);
+  EXPECT_EQ(cf.byte_code(), nullptr);
+
+  base::untyped_buffer buffer;
+  buffer.append<int>(3);
+  cf.Finalize(std::move(buffer));
+  EXPECT_TRUE(cf.complete());
+  ASSERT_NE(cf.byte_code(), nullptr);
+  EXPECT_EQ(f.byte_code_iterator().read<int>(), 3);
+}
+
 }  // namespace
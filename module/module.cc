@@ -10,8 +10,10 @@ BasicModule::BasicModule() : scope_(this) {}
 BasicModule::~BasicModule() {}
 
 void BasicModule::InitializeNodes(base::PtrSpan<ast::Node> nodes) {
-  ast::Node::Initializer initializer{.scope = &scope_};
+  ast::Node::Initializer initializer{.scope      = &scope_,
+                                     .next_index = num_nodes_};
   ast::InitializeNodes(nodes, initializer);
+  num_nodes_ = initializer.next_index;
   for (ast::Node const *node : nodes) {
     auto *decl = node->if_as<ast::Declaration>();
     if (not decl) { continue; }
@@ -33,11 +35,9 @@ void BasicModule::AppendNodes(std::vector<std::unique_ptr<ast::Node>> nodes,
                 std::make_move_iterator(nodes.end()));
 }
 
-// TODO: Add a version of this function that also gives the declarations that
-// are inaccessible. Particularly interesting would be the case of an overlaod
-// set mixing constant and non-constants. It should also be an error to
-// reference that when you're only able to see some of the name.
-std::vector<ast::Declaration::Id const *> AllVisibleDeclsTowardsRoot(
+namespace {
+
+std::vector<ast::Declaration::Id const *> UncachedVisibleDeclsTowardsRoot(
     ast::Scope const *starting_scope, std::string_view id_name) {
   std::vector<ast::Declaration::Id const *> ids;
   bool only_constants = false;
@@ -70,11 +70,25 @@ std::vector<ast::Declaration::Id const *> AllVisibleDeclsTowardsRoot(
   return ids;
 }
 
+}  // namespace
+
+// TODO: Add a version of this function that also gives the declarations that
+// are inaccessible. Particularly interesting would be the case of an overlaod
+// set mixing constant and non-constants. It should also be an error to
+// reference that when you're only able to see some of the name.
+absl::Span<ast::Declaration::Id const *const> AllVisibleDeclsTowardsRoot(
+    ast::Scope const *starting_scope, ast::Symbol id) {
+  return starting_scope->CachedLookup(id, [&] {
+    return UncachedVisibleDeclsTowardsRoot(starting_scope, id.name());
+  });
+}
+
 std::vector<ast::Declaration::Id const *> AllAccessibleDeclIds(
-    ast::Scope const *starting_scope, std::string_view id_name) {
-  std::vector<ast::Declaration::Id const *> decl_iters =
-      module::AllVisibleDeclsTowardsRoot(starting_scope, id_name);
-  auto child_decls = starting_scope->VisibleChildren(id_name);
+    ast::Scope const *starting_scope, ast::Symbol id) {
+  auto visible_decls = module::AllVisibleDeclsTowardsRoot(starting_scope, id);
+  std::vector<ast::Declaration::Id const *> decl_iters(visible_decls.begin(),
+                                                       visible_decls.end());
+  auto child_decls = starting_scope->VisibleChildren(id.name());
   decl_iters.insert(decl_iters.end(), child_decls.begin(), child_decls.end());
   return decl_iters;
 }
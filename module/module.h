@@ -10,7 +10,9 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
 #include "ast/scope.h"
+#include "ast/symbol.h"
 #include "base/cast.h"
 #include "base/guarded.h"
 #include "base/macros.h"
@@ -74,6 +76,9 @@ struct BasicModule : base::Cast<BasicModule> {
 
   ast::ModuleScope scope_;
   std::vector<std::unique_ptr<ast::Node>> nodes_;
+  // The number of nodes initialized so far, which is also the index to be
+  // assigned to the next node initialized.
+  uint32_t num_nodes_ = 0;
 
   // This notification is notified when parsing is complete. It is not possible
   // to access `scope()` without this notification having been notified, thus
@@ -86,15 +91,17 @@ struct BasicModule : base::Cast<BasicModule> {
 
 // Returns a container of all visible declarations in this scope  with the given
 // identifier. This means any declarations in the path to the ancestor
-// function/jump, and any constant declarations above that.
-std::vector<ast::Declaration::Id const *> AllVisibleDeclsTowardsRoot(
-    ast::Scope const *starting_scope, std::string_view id);
+// function/jump, and any constant declarations above that. Results are cached
+// on `starting_scope`, so repeated lookups need not search each scope, and the
+// returned span remains valid for the lifetime of `starting_scope`.
+absl::Span<ast::Declaration::Id const *const> AllVisibleDeclsTowardsRoot(
+    ast::Scope const *starting_scope, ast::Symbol id);
 
 // Returns a container of all declaration ids with the given identifier that are
 // in a scope directly related to this one (i.e., one of the scopes is an
 // ancestor of the other, or is the root scope of an embedded module).
 std::vector<ast::Declaration::Id const *> AllAccessibleDeclIds(
-    ast::Scope const *starting_scope, std::string_view id);
+    ast::Scope const *starting_scope, ast::Symbol id);
 
 }  // namespace module
 
@@ -0,0 +1,109 @@
+#include "opt/cfg.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "base/meta.h"
+#include "ir/instruction/jump.h"
+
+namespace opt {
+
+bool HasOnlyLocalJumps(ir::CompiledFn const& fn) {
+  for (auto const* block : fn.blocks()) {
+    switch (block->jump().kind()) {
+      case ir::JumpCmd::Kind::JumpExit:
+      case ir::JumpCmd::Kind::Choose: return false;
+      default: break;
+    }
+  }
+  return true;
+}
+
+std::vector<ir::BasicBlock const*> ReversePostOrder(ir::CompiledFn const& fn) {
+  // Compute a post-order with an explicit stack so that long chains of blocks
+  // do not overflow the native one.
+  std::vector<ir::BasicBlock const*> order;
+  absl::flat_hash_set<ir::BasicBlock const*> visited;
+  std::vector<std::pair<ir::BasicBlock const*, std::vector<ir::BasicBlock*>>>
+      stack;
+  auto push = [&](ir::BasicBlock const* block) {
+    if (not visited.insert(block).second) { return; }
+    std::vector<ir::BasicBlock*> successors;
+    ForEachSuccessor(block,
+                     [&](ir::BasicBlock* b) { successors.push_back(b); });
+    std::reverse(successors.begin(), successors.end());
+    stack.emplace_back(block, std::move(successors));
+  };
+  push(fn.entry());
+  while (not stack.empty()) {
+    auto& [block, successors] = stack.back();
+    if (successors.empty()) {
+      order.push_back(block);
+      stack.pop_back();
+    } else {
+      ir::BasicBlock* next = successors.back();
+      successors.pop_back();
+      push(next);
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+void ForEachSuccessor(ir::BasicBlock const* block,
+                      absl::FunctionRef<void(ir::BasicBlock*)> f) {
+  block->jump().Visit([&](auto const& j) {
+    constexpr auto type = base::meta<std::decay_t<decltype(j)>>;
+    if constexpr (type == base::meta<ir::JumpCmd::UncondJump>) {
+      f(j.block);
+    } else if constexpr (type == base::meta<ir::JumpCmd::CondJump>) {
+      f(j.true_block);
+      if (j.false_block != j.true_block) { f(j.false_block); }
+    } else if constexpr (type == base::meta<ir::JumpCmd::ChooseJump>) {
+      for (ir::BasicBlock* b : j.blocks()) { f(b); }
+    }
+  });
+}
+
+void RemoveIncomingBlock(ir::BasicBlock* to, ir::BasicBlock* from) {
+  to->erase_incoming(from);
+  ReplaceIncomingBlock(to, from, nullptr);
+}
+
+void ReplaceIncomingBlock(ir::BasicBlock* to, ir::BasicBlock const* from,
+                          ir::BasicBlock const* replacement) {
+  for (auto& inst : to->instructions()) {
+    inst.ReplaceIncomingBlocks([&](ir::BasicBlock const* b) {
+      return b == from ? replacement : b;
+    });
+  }
+}
+
+bool ReplaceJumpCondition(ir::BasicBlock* block, ir::Value const& v) {
+  if (block->jump().kind() != ir::JumpCmd::Kind::Cond) { return false; }
+  if (auto const* r = v.get_if<ir::Reg>()) {
+    block->set_jump(ir::JumpCmd::Cond(*r, block->jump().CondTarget(true),
+                                      block->jump().CondTarget(false)));
+    return true;
+  } else if (auto const* b = v.get_if<bool>()) {
+    ir::BasicBlock* target  = block->jump().CondTarget(*b);
+    ir::BasicBlock* dropped = block->jump().CondTarget(not *b);
+    if (dropped != target) { RemoveIncomingBlock(dropped, block); }
+    block->set_jump(ir::JumpCmd::Uncond(target));
+    return true;
+  }
+  return false;
+}
+
+bool HasPhiInstructions(ir::BasicBlock* block) {
+  for (auto& inst : block->instructions()) {
+    if (inst.ReplaceIncomingBlocks([](ir::BasicBlock const* b) { return b; })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace opt
@@ -0,0 +1,44 @@
+#ifndef ICARUS_OPT_CFG_H
+#define ICARUS_OPT_CFG_H
+
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "ir/compiled_fn.h"
+#include "ir/value/value.h"
+
+namespace opt {
+
+// Returns whether every block in `fn` ends in a jump which is local to the
+// function (i.e., not a `choose` or `jump-exit`). The passes in this directory
+// only apply to such functions.
+bool HasOnlyLocalJumps(ir::CompiledFn const& fn);
+
+// Returns the blocks of `fn` reachable from its entry in reverse post-order. In
+// particular, each block appears after every block which dominates it.
+std::vector<ir::BasicBlock const*> ReversePostOrder(ir::CompiledFn const& fn);
+
+// Calls `f` on each block to which `block` may jump.
+void ForEachSuccessor(ir::BasicBlock const* block,
+                      absl::FunctionRef<void(ir::BasicBlock*)> f);
+
+// Removes `from` as an incoming block of `to`, along with the corresponding
+// entries of any phi instructions in `to`. Does not modify the jump of `from`.
+void RemoveIncomingBlock(ir::BasicBlock* to, ir::BasicBlock* from);
+
+// Replaces `from` with `replacement` in any phi instructions in `to`.
+void ReplaceIncomingBlock(ir::BasicBlock* to, ir::BasicBlock const* from,
+                          ir::BasicBlock const* replacement);
+
+// If `block` ends in a conditional jump and `v` is a register, replaces the
+// jump's condition with it. If `v` is a boolean the jump is made unconditional.
+// Returns whether the jump was modified.
+bool ReplaceJumpCondition(ir::BasicBlock* block, ir::Value const& v);
+
+// Returns whether any instruction in `block` depends on the block from which
+// control reached it.
+bool HasPhiInstructions(ir::BasicBlock* block);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_CFG_H
@@ -0,0 +1,50 @@
+#include "opt/dead_code.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ir/instruction/jump.h"
+#include "ir/value/reg.h"
+
+namespace opt {
+
+bool RemoveDeadInstructions(ir::CompiledFn* fn) {
+  absl::flat_hash_map<ir::Reg, size_t> num_uses;
+  absl::flat_hash_map<ir::Reg, ir::Inst*> definitions;
+  for (auto* block : fn->blocks()) {
+    for (auto& inst : block->instructions()) {
+      if (not inst.ForEachUse([&](ir::Reg r) { ++num_uses[r]; })) {
+        return false;
+      }
+      if (not inst.pure()) { continue; }
+      if (auto r = inst.result()) { definitions.emplace(*r, &inst); }
+    }
+    if (block->jump().kind() == ir::JumpCmd::Kind::Cond) {
+      ++num_uses[block->jump().CondReg()];
+    }
+  }
+
+  std::vector<ir::Inst*> dead;
+  for (auto [r, inst] : definitions) {
+    if (not num_uses.contains(r)) { dead.push_back(inst); }
+  }
+  if (dead.empty()) { return false; }
+
+  while (not dead.empty()) {
+    ir::Inst* inst = dead.back();
+    dead.pop_back();
+    inst->ForEachUse([&](ir::Reg r) {
+      auto iter = num_uses.find(r);
+      if (--iter->second != 0) { return; }
+      if (auto def = definitions.find(r); def != definitions.end()) {
+        dead.push_back(def->second);
+      }
+    });
+    *inst = nullptr;
+  }
+
+  for (auto* block : fn->blocks()) { block->RemoveNullInstructions(); }
+  return true;
+}
+
+}  // namespace opt
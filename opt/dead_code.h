@@ -0,0 +1,16 @@
+#ifndef ICARUS_OPT_DEAD_CODE_H
+#define ICARUS_OPT_DEAD_CODE_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Removes pure instructions whose results are never used, including those
+// which only become unused once other dead instructions are removed. Nothing
+// is removed if `fn` contains any instruction whose operands cannot be
+// enumerated. Returns whether `fn` was modified.
+bool RemoveDeadInstructions(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_DEAD_CODE_H
@@ -0,0 +1,86 @@
+#include "opt/dominators.h"
+
+#include "opt/cfg.h"
+
+namespace opt {
+
+DominatorTree::DominatorTree(ir::CompiledFn& fn) {
+  // `fn` is not const, so neither are any of its blocks.
+  for (ir::BasicBlock const* block : ReversePostOrder(fn)) {
+    reverse_post_order_.push_back(const_cast<ir::BasicBlock*>(block));
+  }
+  for (size_t i = 0; i < reverse_post_order_.size(); ++i) {
+    post_order_index_.emplace(reverse_post_order_[i],
+                              reverse_post_order_.size() - 1 - i);
+  }
+
+  absl::flat_hash_map<ir::BasicBlock const*, std::vector<ir::BasicBlock*>>
+      predecessors;
+  for (ir::BasicBlock* block : reverse_post_order_) {
+    ForEachSuccessor(block, [&](ir::BasicBlock* b) {
+      predecessors[b].push_back(block);
+    });
+  }
+
+  auto intersect = [&](ir::BasicBlock* a, ir::BasicBlock* b) {
+    while (a != b) {
+      while (post_order_index_.at(a) < post_order_index_.at(b)) {
+        a = idom_.at(a);
+      }
+      while (post_order_index_.at(b) < post_order_index_.at(a)) {
+        b = idom_.at(b);
+      }
+    }
+    return a;
+  };
+
+  idom_.emplace(root(), root());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (ir::BasicBlock* block : reverse_post_order_) {
+      if (block == root()) { continue; }
+      ir::BasicBlock* new_idom = nullptr;
+      for (ir::BasicBlock* pred : predecessors[block]) {
+        if (not idom_.contains(pred)) { continue; }
+        new_idom = new_idom ? intersect(pred, new_idom) : pred;
+      }
+      auto [iter, inserted] = idom_.emplace(block, new_idom);
+      if (inserted or iter->second != new_idom) {
+        iter->second = new_idom;
+        changed      = true;
+      }
+    }
+  }
+
+  for (ir::BasicBlock* block : reverse_post_order_) {
+    if (block == root()) { continue; }
+    children_[idom_.at(block)].push_back(block);
+  }
+}
+
+ir::BasicBlock* DominatorTree::immediate_dominator(
+    ir::BasicBlock const* block) const {
+  if (block == root()) { return nullptr; }
+  auto iter = idom_.find(block);
+  return iter == idom_.end() ? nullptr : iter->second;
+}
+
+absl::Span<ir::BasicBlock* const> DominatorTree::children(
+    ir::BasicBlock const* block) const {
+  auto iter = children_.find(block);
+  if (iter == children_.end()) { return {}; }
+  return iter->second;
+}
+
+bool DominatorTree::Dominates(ir::BasicBlock const* a,
+                              ir::BasicBlock const* b) const {
+  if (not idom_.contains(b)) { return false; }
+  while (b != a) {
+    b = immediate_dominator(b);
+    if (not b) { return false; }
+  }
+  return true;
+}
+
+}  // namespace opt
@@ -0,0 +1,48 @@
+#ifndef ICARUS_OPT_DOMINATORS_H
+#define ICARUS_OPT_DOMINATORS_H
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// DominatorTree:
+//
+// The dominator tree of the blocks reachable from the entry of a function,
+// computed with the iterative algorithm described in "A Simple, Fast Dominance
+// Algorithm" by Cooper, Harvey, and Kennedy. The tree is not updated if the
+// function is modified.
+struct DominatorTree {
+  explicit DominatorTree(ir::CompiledFn& fn);
+
+  ir::BasicBlock* root() const { return reverse_post_order_[0]; }
+
+  // All blocks reachable from the entry, in reverse post-order.
+  absl::Span<ir::BasicBlock* const> reverse_post_order() const {
+    return reverse_post_order_;
+  }
+
+  // Returns the immediate dominator of `block`, or null if `block` is the
+  // root or is unreachable.
+  ir::BasicBlock* immediate_dominator(ir::BasicBlock const* block) const;
+
+  // Returns the blocks whose immediate dominator is `block`.
+  absl::Span<ir::BasicBlock* const> children(
+      ir::BasicBlock const* block) const;
+
+  bool Dominates(ir::BasicBlock const* a, ir::BasicBlock const* b) const;
+
+ private:
+  std::vector<ir::BasicBlock*> reverse_post_order_;
+  absl::flat_hash_map<ir::BasicBlock const*, size_t> post_order_index_;
+  absl::flat_hash_map<ir::BasicBlock const*, ir::BasicBlock*> idom_;
+  absl::flat_hash_map<ir::BasicBlock const*, std::vector<ir::BasicBlock*>>
+      children_;
+};
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_DOMINATORS_H
@@ -0,0 +1,280 @@
+#include "opt/inline_calls.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "base/meta.h"
+#include "ir/instruction/core.h"
+#include "ir/instruction/inliner.h"
+#include "ir/instruction/jump.h"
+#include "ir/local_block_interpretation.h"
+#include "ir/value/addr.h"
+#include "ir/value/block.h"
+#include "ir/value/char.h"
+#include "ir/value/fn.h"
+#include "ir/value/generic_fn.h"
+#include "ir/value/jump.h"
+#include "ir/value/module_id.h"
+#include "ir/value/reg.h"
+#include "ir/value/scope.h"
+#include "ir/value/value.h"
+#include "opt/cfg.h"
+#include "type/interface/interface.h"
+#include "type/type.h"
+
+namespace opt {
+namespace {
+
+// Callees are never inlined if their cost exceeds this. The cost of a function
+// is the number of instructions and jumps it contains, which is a reasonable
+// estimate for both the code size added and the time saved by not having to
+// set up a stack frame.
+constexpr int kMaxCalleeCost = 32;
+
+// Calls exposed by inlining are considered for inlining themselves, but only up
+// to this depth. This bounds the work done on (mutually) recursive functions.
+constexpr int kMaxDepth = 3;
+
+// The maximum total cost of all callees inlined into a single function.
+constexpr int kMaxGrowth = 512;
+
+// The types for which functions return values with `SetReturnInstruction`s.
+// Values of all other types are returned by writing through an output
+// register.
+using ReturnTypes =
+    base::type_list<bool, ir::Char, int8_t, int16_t, int32_t, int64_t, uint8_t,
+                    uint16_t, uint32_t, uint64_t, float, double, type::Type,
+                    ir::addr_t, ir::ModuleId, ir::Scope, ir::Fn, ir::Jump,
+                    ir::Block, ir::GenericFn, interface::Interface>;
+
+// If `inst` is a `SetReturnInstruction<T>` for some `T` in `ReturnTypes`, calls
+// `f` with it and returns true. Otherwise returns false.
+template <typename Fn, typename... Ts>
+bool VisitSetReturn(ir::Inst const& inst, Fn&& f, base::type_list<Ts...>) {
+  return ([&]<typename T>() {
+    auto const* set_ret = inst.if_as<ir::SetReturnInstruction<T>>();
+    if (set_ret) { f(*set_ret); }
+    return set_ret != nullptr;
+  }.template operator()<Ts>() or ...);
+}
+
+std::optional<uint16_t> SetReturnIndex(ir::Inst const& inst) {
+  std::optional<uint16_t> index;
+  VisitSetReturn(
+      inst, [&](auto const& set_ret) { index = set_ret.index; }, ReturnTypes{});
+  return index;
+}
+
+ir::CompiledFn const* NativeCallee(ir::CallInstruction const& call) {
+  if (call.func().is_reg()) { return nullptr; }
+  ir::Fn f = call.func().value();
+  if (f.kind() != ir::Fn::Kind::Native) { return nullptr; }
+  return &*f.native();
+}
+
+using Substitutions = absl::flat_hash_map<ir::Reg, ir::Value>;
+
+void Substitute(Substitutions const& substitutions, ir::Inst& inst) {
+  inst.ReplaceUses([&](ir::Reg r) {
+    auto iter = substitutions.find(r);
+    return iter == substitutions.end() ? ir::Value() : iter->second;
+  });
+}
+
+// Returns the cost of inlining `callee` at `call` within `caller`, or
+// `std::nullopt` if it cannot be inlined there. A callee can be inlined only if
+// every read of its arguments and output registers can be rewritten in terms of
+// the caller's values, and if each block which returns sets each small output
+// exactly once.
+std::optional<int> InlineCost(ir::CompiledFn const& caller,
+                              ir::CompiledFn const& callee,
+                              ir::CallInstruction const& call) {
+  if (&callee == &caller or not callee.complete() or
+      callee.num_args() != call.arguments().size() or
+      not HasOnlyLocalJumps(callee)) {
+    return std::nullopt;
+  }
+
+  // Registers in the caller are substituted with an arbitrary value register:
+  // what matters is only whether each read can be replaced at all.
+  auto const& outputs = call.func_type()->output();
+  Substitutions substitutions;
+  for (size_t i = 0; i < call.arguments().size(); ++i) {
+    ir::Value const& arg = call.arguments()[i];
+    substitutions.emplace(ir::Reg::Arg(i),
+                          arg.get_if<ir::Reg>() ? ir::Value(ir::Reg(0)) : arg);
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (outputs[i].is_big()) {
+      substitutions.emplace(ir::Reg::Out(i), ir::Value(ir::Reg(0)));
+    }
+  }
+
+  int cost = 0;
+  for (auto const* block : callee.blocks()) {
+    cost += 1 + block->instructions().size();
+    if (cost > kMaxCalleeCost) { return std::nullopt; }
+
+    bool returns = block->jump().kind() == ir::JumpCmd::Kind::Return;
+    if (block->jump().kind() == ir::JumpCmd::Kind::Cond and
+        block->jump().CondReg().is_out()) {
+      return std::nullopt;
+    }
+
+    std::vector<bool> returned(outputs.size(), false);
+    for (ir::Inst const& inst : block->instructions()) {
+      if (not inst) { continue; }
+      ir::Inst copy = inst;
+      Substitute(substitutions, copy);
+      bool reads_frame = false;
+      if (not copy.ForEachUse([&](ir::Reg r) {
+            reads_frame |= r.is_arg() or r.is_out();
+          }) or
+          reads_frame) {
+        return std::nullopt;
+      }
+
+      std::optional<uint16_t> index = SetReturnIndex(inst);
+      if (not index) { continue; }
+      if (not returns or *index >= outputs.size() or
+          outputs[*index].is_big() or returned[*index]) {
+        return std::nullopt;
+      }
+      returned[*index] = true;
+    }
+
+    if (not returns) { continue; }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      if (not outputs[i].is_big() and not returned[i]) { return std::nullopt; }
+    }
+  }
+  return cost;
+}
+
+// Replaces the call which is the `index`th instruction of `block` with a copy
+// of `callee`. Returns the block holding the instructions following the call.
+ir::BasicBlock* InlineCall(ir::CompiledFn* fn, ir::BasicBlock* block,
+                           size_t index, ir::CompiledFn const& callee) {
+  ir::CallInstruction const& call =
+      *block->instructions()[index].if_as<ir::CallInstruction>();
+  auto const& outputs = call.func_type()->output();
+
+  auto* continuation = fn->AppendBlock(
+      ir::BasicBlock::DebugInfo{.header = "Inlined call continuation"});
+
+  size_t first_inlined = fn->blocks().size();
+  size_t offset        = fn->num_regs();
+  ir::InstructionInliner inliner(
+      &callee, fn, ir::LocalBlockInterpretation({}, nullptr, nullptr));
+  ir::BasicBlock* entry = inliner.InlineAllBlocks();
+
+  // The inliner renames argument `i` to the value register `offset + i`, which
+  // is otherwise unused. Reads of it are replaced with the argument itself.
+  // Output registers are left untouched by the inliner.
+  Substitutions substitutions;
+  for (size_t i = 0; i < call.arguments().size(); ++i) {
+    substitutions.emplace(ir::Reg(offset + i), call.arguments()[i]);
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (outputs[i].is_big()) {
+      substitutions.emplace(ir::Reg::Out(i), ir::Value(call.outputs()[i]));
+    }
+  }
+
+  std::vector<std::vector<std::pair<ir::BasicBlock const*, ir::Inst*>>>
+      set_returns(outputs.size());
+  std::vector<ir::BasicBlock*> returning_blocks;
+  for (size_t i = first_inlined; i < fn->blocks().size(); ++i) {
+    ir::BasicBlock* inlined = fn->blocks()[i];
+    for (auto& inst : inlined->instructions()) {
+      Substitute(substitutions, inst);
+      if (auto index = SetReturnIndex(inst)) {
+        set_returns[*index].emplace_back(inlined, &inst);
+      }
+    }
+    if (inlined->jump().kind() == ir::JumpCmd::Kind::Cond) {
+      auto iter = substitutions.find(inlined->jump().CondReg());
+      if (iter != substitutions.end()) {
+        ReplaceJumpCondition(inlined, iter->second);
+      }
+    } else if (inlined->jump().kind() == ir::JumpCmd::Kind::Return) {
+      returning_blocks.push_back(inlined);
+    }
+  }
+
+  // Each small output is defined at the start of the continuation by a phi
+  // over the values returned from each returning block.
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (set_returns[i].empty()) { continue; }
+    VisitSetReturn(
+        *set_returns[i].front().second,
+        [&]<typename T>(ir::SetReturnInstruction<T> const&) {
+          ir::PhiInstruction<T> phi;
+          for (auto [returning_block, inst] : set_returns[i]) {
+            phi.add(returning_block,
+                    inst->template if_as<ir::SetReturnInstruction<T>>()->value);
+            *inst = nullptr;
+          }
+          phi.result = call.outputs()[i];
+          continuation->Append(std::move(phi));
+        },
+        ReturnTypes{});
+  }
+  for (ir::BasicBlock* returning_block : returning_blocks) {
+    returning_block->RemoveNullInstructions();
+    continuation->insert_incoming(returning_block);
+  }
+
+  block->SplitAfter(index + 1, continuation);
+  ForEachSuccessor(continuation, [&](ir::BasicBlock* successor) {
+    ReplaceIncomingBlock(successor, block, continuation);
+  });
+
+  block->instructions()[index] = nullptr;
+  block->RemoveNullInstructions();
+  entry->insert_incoming(block);
+  return continuation;
+}
+
+}  // namespace
+
+bool InlineCalls(ir::CompiledFn* fn) {
+  // Each block is paired with the number of inlined calls it is nested within.
+  std::vector<std::pair<ir::BasicBlock*, int>> worklist;
+  for (auto* block : fn->blocks()) { worklist.emplace_back(block, 0); }
+
+  int budget   = kMaxGrowth;
+  bool changed = false;
+  while (not worklist.empty()) {
+    auto [block, depth] = worklist.back();
+    worklist.pop_back();
+    if (depth >= kMaxDepth) { continue; }
+
+    auto instructions = block->instructions();
+    for (size_t i = 0; i < instructions.size(); ++i) {
+      auto const* call = instructions[i].if_as<ir::CallInstruction>();
+      if (not call) { continue; }
+      ir::CompiledFn const* callee = NativeCallee(*call);
+      if (not callee) { continue; }
+      std::optional<int> cost = InlineCost(*fn, *callee, *call);
+      if (not cost or *cost > budget) { continue; }
+      budget -= *cost;
+      changed = true;
+
+      size_t first_inlined          = fn->blocks().size();
+      ir::BasicBlock* continuation = InlineCall(fn, block, i, *callee);
+      for (size_t j = first_inlined; j < fn->blocks().size(); ++j) {
+        if (fn->blocks()[j] == continuation) { continue; }
+        worklist.emplace_back(fn->blocks()[j], depth + 1);
+      }
+      worklist.emplace_back(continuation, depth);
+      break;
+    }
+  }
+  return changed;
+}
+
+}  // namespace opt
@@ -0,0 +1,17 @@
+#ifndef ICARUS_OPT_INLINE_CALLS_H
+#define ICARUS_OPT_INLINE_CALLS_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Replaces calls to small native functions in `fn` with copies of their bodies.
+// Only callees whose byte code has already been emitted (and whose bodies are
+// therefore complete) are considered. Calls exposed by inlining are themselves
+// inlined up to a fixed depth, and the total amount of code inlined into `fn`
+// is bounded. Returns whether any call was inlined.
+bool InlineCalls(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_INLINE_CALLS_H
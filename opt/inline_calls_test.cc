@@ -0,0 +1,171 @@
+#include "opt/inline_calls.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ir/builder.h"
+#include "ir/compiled_fn.h"
+#include "ir/instruction/arithmetic.h"
+#include "ir/instruction/compare.h"
+#include "ir/instruction/core.h"
+#include "type/function.h"
+#include "type/primitive.h"
+
+namespace {
+
+using ::testing::SizeIs;
+
+type::Function const *I64ToI64() {
+  return type::Func(
+      {core::AnonymousParam(type::QualType::NonConstant(type::I64))},
+      {type::I64});
+}
+
+// Returns the number of instructions of type `T` in `fn`.
+template <typename T>
+int Count(ir::CompiledFn const &fn) {
+  int n = 0;
+  for (auto const *block : fn.blocks()) {
+    for (auto const &inst : block->instructions()) {
+      if (inst.if_as<T>()) { ++n; }
+    }
+  }
+  return n;
+}
+
+struct InlineCallsTest : testing::Test {
+  InlineCallsTest()
+      : callee(I64ToI64(),
+               core::Params<type::Typed<ast::Declaration const *>>(1)),
+        caller(I64ToI64(),
+               core::Params<type::Typed<ast::Declaration const *>>(1)),
+        data{.fn = &callee, .type = I64ToI64()} {}
+
+  // Marks `callee` as complete, as though its byte code had been emitted.
+  void FinishCallee() { callee.Finalize(base::untyped_buffer()); }
+
+  // Emits `out = callee(arg)` into the current block of `bldr`.
+  ir::Reg EmitCall(ir::Builder &bldr, ir::RegOr<int64_t> arg) {
+    ir::OutParams outs = bldr.OutParams(I64ToI64()->output());
+    ir::Reg out        = outs[0];
+    bldr.Call(ir::Fn(ir::NativeFn(&data)), I64ToI64(), {ir::Value(arg)},
+              std::move(outs));
+    return out;
+  }
+
+  void SetReturn(ir::Builder &bldr, ir::RegOr<int64_t> value) {
+    bldr.CurrentBlock()->Append(
+        ir::SetReturnInstruction<int64_t>{.index = 0, .value = value});
+    bldr.ReturnJump();
+  }
+
+  ir::CompiledFn callee;
+  ir::CompiledFn caller;
+  ir::NativeFn::Data data;
+};
+
+TEST_F(InlineCallsTest, InlinesSmallCallee) {
+  {
+    ir::Builder bldr;
+    bldr.CurrentGroup() = &callee;
+    bldr.CurrentBlock() = callee.entry();
+    ir::Reg product = bldr.CurrentBlock()->Append(ir::MulInstruction<int64_t>{
+        .lhs    = ir::Reg::Arg(0),
+        .rhs    = ir::Reg::Arg(0),
+        .result = bldr.CurrentGroup()->Reserve()});
+    SetReturn(bldr, product);
+  }
+  FinishCallee();
+
+  ir::Builder bldr;
+  bldr.CurrentGroup() = &caller;
+  bldr.CurrentBlock() = caller.entry();
+  SetReturn(bldr, EmitCall(bldr, ir::Reg::Arg(0)));
+
+  EXPECT_TRUE(opt::InlineCalls(&caller));
+  EXPECT_EQ(Count<ir::CallInstruction>(caller), 0);
+  EXPECT_EQ(Count<ir::MulInstruction<int64_t>>(caller), 1);
+  EXPECT_EQ(Count<ir::PhiInstruction<int64_t>>(caller), 1);
+  EXPECT_EQ(Count<ir::SetReturnInstruction<int64_t>>(caller), 1);
+
+  // The callee is left untouched.
+  EXPECT_THAT(callee.blocks(), SizeIs(1));
+  EXPECT_EQ(Count<ir::MulInstruction<int64_t>>(callee), 1);
+}
+
+TEST_F(InlineCallsTest, InlinesEachReturn) {
+  {
+    ir::Builder bldr;
+    bldr.CurrentGroup() = &callee;
+    bldr.CurrentBlock() = callee.entry();
+    auto *negative      = bldr.AddBlock();
+    auto *positive      = bldr.AddBlock();
+    ir::Reg cond = bldr.CurrentBlock()->Append(ir::LtInstruction<int64_t>{
+        .lhs    = ir::Reg::Arg(0),
+        .rhs    = 0,
+        .result = bldr.CurrentGroup()->Reserve()});
+    bldr.CondJump(cond, negative, positive);
+
+    bldr.CurrentBlock() = negative;
+    SetReturn(bldr, 0);
+
+    bldr.CurrentBlock() = positive;
+    SetReturn(bldr, ir::Reg::Arg(0));
+  }
+  FinishCallee();
+
+  ir::Builder bldr;
+  bldr.CurrentGroup() = &caller;
+  bldr.CurrentBlock() = caller.entry();
+  SetReturn(bldr, EmitCall(bldr, 3));
+
+  EXPECT_TRUE(opt::InlineCalls(&caller));
+  EXPECT_EQ(Count<ir::CallInstruction>(caller), 0);
+  auto const *lt =
+      caller.entry()->instructions()[0].if_as<ir::LtInstruction<int64_t>>();
+  ASSERT_NE(lt, nullptr);
+  EXPECT_EQ(lt->lhs, ir::RegOr<int64_t>(3));
+
+  ir::PhiInstruction<int64_t> const *phi = nullptr;
+  for (auto const *block : caller.blocks()) {
+    for (auto const &inst : block->instructions()) {
+      if (auto const *p = inst.if_as<ir::PhiInstruction<int64_t>>()) {
+        phi = p;
+      }
+    }
+  }
+  ASSERT_NE(phi, nullptr);
+  EXPECT_THAT(phi->values,
+              testing::UnorderedElementsAre(ir::RegOr<int64_t>(0),
+                                            ir::RegOr<int64_t>(3)));
+}
+
+TEST_F(InlineCallsTest, SkipsIncompleteCallees) {
+  {
+    ir::Builder bldr;
+    bldr.CurrentGroup() = &callee;
+    bldr.CurrentBlock() = callee.entry();
+    SetReturn(bldr, ir::Reg::Arg(0));
+  }
+
+  ir::Builder bldr;
+  bldr.CurrentGroup() = &caller;
+  bldr.CurrentBlock() = caller.entry();
+  SetReturn(bldr, EmitCall(bldr, ir::Reg::Arg(0)));
+
+  EXPECT_FALSE(opt::InlineCalls(&caller));
+  EXPECT_EQ(Count<ir::CallInstruction>(caller), 1);
+}
+
+TEST_F(InlineCallsTest, SkipsRecursiveCalls) {
+  data.fn = &caller;
+  ir::Builder bldr;
+  bldr.CurrentGroup() = &caller;
+  bldr.CurrentBlock() = caller.entry();
+  SetReturn(bldr, EmitCall(bldr, ir::Reg::Arg(0)));
+  caller.Finalize(base::untyped_buffer());
+
+  EXPECT_FALSE(opt::InlineCalls(&caller));
+  EXPECT_EQ(Count<ir::CallInstruction>(caller), 1);
+}
+
+}  // namespace
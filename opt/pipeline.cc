@@ -0,0 +1,35 @@
+#include "opt/pipeline.h"
+
+#include "base/debug.h"
+#include "opt/cfg.h"
+#include "opt/dead_code.h"
+#include "opt/inline_calls.h"
+#include "opt/propagate.h"
+#include "opt/simplify_cfg.h"
+#include "opt/value_numbering.h"
+
+namespace opt {
+namespace {
+
+// The maximum number of times the full sequence of passes is run on a single
+// function. In practice nearly all functions reach a fixed point in one or two
+// rounds.
+constexpr int kMaxRounds = 4;
+
+}  // namespace
+
+void Optimize(ir::CompiledFn* fn) {
+  if (not HasOnlyLocalJumps(*fn)) { return; }
+  ASSERT(fn->complete() == false);
+
+  InlineCalls(fn);
+  for (int round = 0; round < kMaxRounds; ++round) {
+    bool changed = SimplifyControlFlow(fn);
+    changed |= PropagateValues(fn);
+    changed |= NumberValues(fn);
+    changed |= RemoveDeadInstructions(fn);
+    if (not changed) { break; }
+  }
+}
+
+}  // namespace opt
@@ -0,0 +1,18 @@
+#ifndef ICARUS_OPT_PIPELINE_H
+#define ICARUS_OPT_PIPELINE_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Inlines small callees into `fn` and then runs control-flow simplification,
+// value propagation, global value numbering and dead instruction elimination
+// over it until none of them make further progress (or a fixed number of rounds
+// have run). Functions containing `choose` or `jump-exit` jumps are left
+// untouched. Run on every function as it is finalized (see
+// `compiler::ByteCode`).
+void Optimize(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_PIPELINE_H
@@ -0,0 +1,165 @@
+#include "opt/pipeline.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ir/builder.h"
+#include "ir/compiled_fn.h"
+#include "ir/instruction/arithmetic.h"
+#include "ir/instruction/compare.h"
+#include "ir/instruction/core.h"
+#include "opt/propagate.h"
+#include "type/function.h"
+#include "type/primitive.h"
+
+namespace {
+
+using ::testing::SizeIs;
+
+struct PipelineTest : testing::Test {
+  PipelineTest()
+      : fn(type::Func({core::AnonymousParam(
+                           type::QualType::NonConstant(type::I64)),
+                       core::AnonymousParam(
+                           type::QualType::NonConstant(type::Bool))},
+                      {type::I64}),
+           core::Params<type::Typed<ast::Declaration const *>>(2)) {
+    bldr.CurrentGroup() = &fn;
+    bldr.CurrentBlock() = fn.entry();
+  }
+
+  void SetReturn(ir::RegOr<int64_t> value) {
+    bldr.CurrentBlock()->Append(
+        ir::SetReturnInstruction<int64_t>{.index = 0, .value = value});
+    bldr.ReturnJump();
+  }
+
+  ir::CompiledFn fn;
+  ir::Builder bldr;
+};
+
+TEST_F(PipelineTest, FoldsConstants) {
+  ir::Reg sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs = 1, .rhs = 2, .result = bldr.CurrentGroup()->Reserve()});
+  ir::Reg product = bldr.CurrentBlock()->Append(ir::MulInstruction<int64_t>{
+      .lhs = sum, .rhs = 3, .result = bldr.CurrentGroup()->Reserve()});
+  SetReturn(product);
+
+  opt::Optimize(&fn);
+
+  ASSERT_THAT(fn.blocks(), SizeIs(1));
+  auto instructions = fn.entry()->instructions();
+  ASSERT_THAT(instructions, SizeIs(1));
+  auto const *set_ret =
+      instructions[0].if_as<ir::SetReturnInstruction<int64_t>>();
+  ASSERT_NE(set_ret, nullptr);
+  EXPECT_EQ(set_ret->value, ir::RegOr<int64_t>(9));
+}
+
+TEST_F(PipelineTest, PropagatesCopies) {
+  ir::Reg copy = bldr.CurrentBlock()->Append(ir::RegisterInstruction<int64_t>{
+      .operand = ir::Reg::Arg(0), .result = bldr.CurrentGroup()->Reserve()});
+  ir::Reg sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs = copy, .rhs = 1, .result = bldr.CurrentGroup()->Reserve()});
+  SetReturn(sum);
+
+  opt::Optimize(&fn);
+
+  auto instructions = fn.entry()->instructions();
+  ASSERT_THAT(instructions, SizeIs(2));
+  auto const *add = instructions[0].if_as<ir::AddInstruction<int64_t>>();
+  ASSERT_NE(add, nullptr);
+  EXPECT_EQ(add->lhs, ir::RegOr<int64_t>(ir::Reg::Arg(0)));
+}
+
+TEST_F(PipelineTest, PropagationReachesAFixedPoint) {
+  ir::Reg copy = bldr.CurrentBlock()->Append(ir::RegisterInstruction<int64_t>{
+      .operand = 3, .result = bldr.CurrentGroup()->Reserve()});
+  ir::Reg sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs    = copy,
+      .rhs    = ir::Reg::Arg(0),
+      .result = bldr.CurrentGroup()->Reserve()});
+  SetReturn(sum);
+
+  EXPECT_TRUE(opt::PropagateValues(&fn));
+  EXPECT_FALSE(opt::PropagateValues(&fn));
+}
+
+TEST_F(PipelineTest, RemovesUnusedPureInstructionsOnly) {
+  bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs    = ir::Reg::Arg(0),
+      .rhs    = 1,
+      .result = bldr.CurrentGroup()->Reserve()});
+  bldr.CurrentBlock()->Append(ir::DivInstruction<int64_t>{
+      .lhs    = ir::Reg::Arg(0),
+      .rhs    = 0,
+      .result = bldr.CurrentGroup()->Reserve()});
+  SetReturn(0);
+
+  opt::Optimize(&fn);
+
+  auto instructions = fn.entry()->instructions();
+  ASSERT_THAT(instructions, SizeIs(2));
+  EXPECT_NE(instructions[0].if_as<ir::DivInstruction<int64_t>>(), nullptr);
+}
+
+TEST_F(PipelineTest, NumbersValuesAcrossBlocks) {
+  auto *true_block  = bldr.AddBlock();
+  auto *false_block = bldr.AddBlock();
+  ir::Reg sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs    = ir::Reg::Arg(0),
+      .rhs    = 1,
+      .result = bldr.CurrentGroup()->Reserve()});
+  bldr.CondJump(ir::Reg::Arg(1), true_block, false_block);
+
+  bldr.CurrentBlock() = true_block;
+  ir::Reg same_sum = bldr.CurrentBlock()->Append(ir::AddInstruction<int64_t>{
+      .lhs    = ir::Reg::Arg(0),
+      .rhs    = 1,
+      .result = bldr.CurrentGroup()->Reserve()});
+  SetReturn(same_sum);
+
+  bldr.CurrentBlock() = false_block;
+  SetReturn(sum);
+
+  opt::Optimize(&fn);
+
+  ASSERT_THAT(fn.blocks(), SizeIs(3));
+  auto instructions = fn.blocks()[1]->instructions();
+  ASSERT_THAT(instructions, SizeIs(1));
+  auto const *set_ret =
+      instructions[0].if_as<ir::SetReturnInstruction<int64_t>>();
+  ASSERT_NE(set_ret, nullptr);
+  EXPECT_EQ(set_ret->value, ir::RegOr<int64_t>(sum));
+}
+
+TEST_F(PipelineTest, FoldsConstantBranches) {
+  auto *true_block  = bldr.AddBlock();
+  auto *false_block = bldr.AddBlock();
+  auto *landing     = bldr.AddBlock();
+  ir::Reg cond = bldr.CurrentBlock()->Append(ir::LtInstruction<int64_t>{
+      .lhs = 1, .rhs = 2, .result = bldr.CurrentGroup()->Reserve()});
+  bldr.CondJump(cond, true_block, false_block);
+
+  bldr.CurrentBlock() = true_block;
+  bldr.UncondJump(landing);
+
+  bldr.CurrentBlock() = false_block;
+  bldr.UncondJump(landing);
+
+  bldr.CurrentBlock() = landing;
+  ir::RegOr<int64_t> phi = bldr.Phi<int64_t>({true_block, false_block},
+                                             {ir::Reg::Arg(0), 3});
+  SetReturn(phi);
+
+  opt::Optimize(&fn);
+
+  ASSERT_THAT(fn.blocks(), SizeIs(1));
+  auto instructions = fn.entry()->instructions();
+  ASSERT_THAT(instructions, SizeIs(1));
+  auto const *set_ret =
+      instructions[0].if_as<ir::SetReturnInstruction<int64_t>>();
+  ASSERT_NE(set_ret, nullptr);
+  EXPECT_EQ(set_ret->value, ir::RegOr<int64_t>(ir::Reg::Arg(0)));
+}
+
+}  // namespace
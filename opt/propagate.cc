@@ -0,0 +1,96 @@
+#include "opt/propagate.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ir/instruction/jump.h"
+#include "ir/value/reg.h"
+#include "ir/value/value.h"
+#include "opt/cfg.h"
+
+namespace opt {
+namespace {
+
+struct KnownValues {
+  // Returns the value known to be held in `r`, looking through chains of
+  // copies, or an empty value if nothing is known about `r`.
+  ir::Value operator()(ir::Reg r) const {
+    auto iter = values_.find(r);
+    if (iter == values_.end()) { return ir::Value(); }
+    ir::Value v = iter->second;
+    while (auto const* reg = v.get_if<ir::Reg>()) {
+      auto next = values_.find(*reg);
+      if (next == values_.end()) { break; }
+      v = next->second;
+    }
+    return v;
+  }
+
+  bool contains(ir::Reg r) const { return values_.contains(r); }
+
+  // Records that `r` holds `v`. Returns false if `v` is `r` itself (possibly
+  // through a chain of copies), in which case nothing is recorded.
+  bool insert(ir::Reg r, ir::Value v) {
+    if (auto const* reg = v.get_if<ir::Reg>()) {
+      if (ir::Value known = (*this)(*reg); not known.empty()) { v = known; }
+      if (auto const* resolved = v.get_if<ir::Reg>();
+          resolved and *resolved == r) {
+        return false;
+      }
+    }
+    values_.emplace(r, v);
+    return true;
+  }
+
+ private:
+  absl::flat_hash_map<ir::Reg, ir::Value> values_;
+};
+
+// Replaces each operand of `inst` whose value is known. Returns whether any
+// operand was actually replaced, which is not the case if the known value is
+// an immediate the operand cannot hold.
+bool ReplaceKnownUses(ir::Inst& inst, KnownValues const& known) {
+  std::vector<ir::Reg> before;
+  bool any_known = false;
+  inst.ForEachUse([&](ir::Reg r) {
+    before.push_back(r);
+    any_known |= not known(r).empty();
+  });
+  if (not any_known) { return false; }
+
+  inst.ReplaceUses([&](ir::Reg r) { return known(r); });
+
+  std::vector<ir::Reg> after;
+  inst.ForEachUse([&](ir::Reg r) { after.push_back(r); });
+  return before != after;
+}
+
+}  // namespace
+
+bool PropagateValues(ir::CompiledFn* fn) {
+  KnownValues known;
+  bool changed  = false;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (auto* block : fn->blocks()) {
+      for (auto& inst : block->instructions()) {
+        if (not inst) { continue; }
+        changed |= ReplaceKnownUses(inst, known);
+
+        if (not inst.pure()) { continue; }
+        auto result = inst.result();
+        if (not result or known.contains(*result)) { continue; }
+        ir::Value v = inst.Simplify();
+        if (v.empty() or not known.insert(*result, v)) { continue; }
+        progress = true;
+      }
+
+      if (block->jump().kind() != ir::JumpCmd::Kind::Cond) { continue; }
+      changed |= ReplaceJumpCondition(block, known(block->jump().CondReg()));
+    }
+  }
+  return changed;
+}
+
+}  // namespace opt
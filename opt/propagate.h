@@ -0,0 +1,19 @@
+#ifndef ICARUS_OPT_PROPAGATE_H
+#define ICARUS_OPT_PROPAGATE_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Replaces uses of registers known to hold a constant or a copy of another
+// register with that constant or register. Results are known by evaluating
+// pure instructions whose operands are all immediates, by looking through
+// `RegisterInstruction`s, and by simplifying phi instructions whose incoming
+// values all agree. Conditional jumps on a known value are made unconditional.
+// Instructions whose results are no longer used are left in place; see
+// `RemoveDeadInstructions`. Returns whether `fn` was modified.
+bool PropagateValues(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_PROPAGATE_H
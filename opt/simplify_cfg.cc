@@ -0,0 +1,73 @@
+#include "opt/simplify_cfg.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "base/log.h"
+#include "ir/instruction/jump.h"
+#include "opt/cfg.h"
+
+namespace opt {
+namespace {
+
+absl::flat_hash_set<ir::BasicBlock*> UnreachableBlocks(ir::CompiledFn* fn) {
+  absl::flat_hash_set<ir::BasicBlock*> reachable;
+  std::vector<ir::BasicBlock*> to_visit = {fn->entry()};
+  while (not to_visit.empty()) {
+    ir::BasicBlock* block = to_visit.back();
+    to_visit.pop_back();
+    if (not reachable.insert(block).second) { continue; }
+    ForEachSuccessor(block, [&](ir::BasicBlock* b) { to_visit.push_back(b); });
+  }
+
+  absl::flat_hash_set<ir::BasicBlock*> unreachable;
+  for (auto* block : fn->blocks()) {
+    if (not reachable.contains(block)) { unreachable.insert(block); }
+  }
+  return unreachable;
+}
+
+// Returns the block into which `block` can be merged, or null if there is
+// none.
+ir::BasicBlock* MergeableSuccessor(ir::CompiledFn* fn, ir::BasicBlock* block) {
+  ir::BasicBlock* next = block->jump().UncondTarget();
+  if (not next or next == block or next == fn->entry()) { return nullptr; }
+  if (next->incoming().size() != 1 or not next->incoming().contains(block)) {
+    return nullptr;
+  }
+  if (HasPhiInstructions(next)) { return nullptr; }
+  return next;
+}
+
+}  // namespace
+
+bool SimplifyControlFlow(ir::CompiledFn* fn) {
+  absl::flat_hash_set<ir::BasicBlock*> to_delete = UnreachableBlocks(fn);
+  for (ir::BasicBlock* block : to_delete) {
+    ForEachSuccessor(block, [&](ir::BasicBlock* b) {
+      RemoveIncomingBlock(b, block);
+    });
+    block->set_jump(ir::JumpCmd::Unreachable());
+  }
+
+  for (auto* block : fn->blocks()) {
+    if (to_delete.contains(block)) { continue; }
+    while (ir::BasicBlock* next = MergeableSuccessor(fn, block)) {
+      LOG("opt", "Merging %p into %p", next, block);
+      ForEachSuccessor(next, [&](ir::BasicBlock* b) {
+        ReplaceIncomingBlock(b, next, block);
+      });
+      block->Append(std::move(*next));
+      next->set_jump(ir::JumpCmd::Unreachable());
+      to_delete.insert(next);
+    }
+  }
+
+  if (to_delete.empty()) { return false; }
+  std::erase_if(fn->mutable_blocks(), [&](auto const& block) {
+    return to_delete.contains(block.get());
+  });
+  return true;
+}
+
+}  // namespace opt
@@ -0,0 +1,16 @@
+#ifndef ICARUS_OPT_SIMPLIFY_CFG_H
+#define ICARUS_OPT_SIMPLIFY_CFG_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Removes blocks which are unreachable from the entry (along with the phi
+// entries referring to them), and merges each block into its predecessor when
+// that predecessor jumps unconditionally to it and is its only incoming block.
+// Returns whether `fn` was modified.
+bool SimplifyControlFlow(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_SIMPLIFY_CFG_H
@@ -0,0 +1,95 @@
+#include "opt/value_numbering.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "base/meta.h"
+#include "ir/instruction/jump.h"
+#include "ir/value/reg.h"
+#include "ir/value/value.h"
+#include "opt/dominators.h"
+
+namespace opt {
+namespace {
+
+struct OperandHash {
+  size_t operator()(ir::Inst const* inst) const {
+    return absl::Hash<std::pair<base::MetaValue, size_t>>{}(
+        std::pair(inst->rtti(), inst->HashOperands()));
+  }
+};
+
+struct SameOperands {
+  bool operator()(ir::Inst const* lhs, ir::Inst const* rhs) const {
+    return lhs->SameOperands(*rhs);
+  }
+};
+
+struct ValueNumbering {
+  explicit ValueNumbering(ir::CompiledFn* fn) : tree_(*fn) {}
+
+  void Visit(ir::BasicBlock* block) {
+    std::vector<ir::Inst const*> introduced;
+    for (auto& inst : block->instructions()) {
+      inst.ReplaceUses([&](ir::Reg r) { return Replacement(r); });
+      if (not inst.value_numberable()) { continue; }
+      ir::Reg result        = *inst.result();
+      auto [iter, inserted] = available_.emplace(&inst, result);
+      if (inserted) {
+        introduced.push_back(&inst);
+      } else {
+        replacements_.emplace(result, iter->second);
+      }
+    }
+
+    for (ir::BasicBlock* child : tree_.children(block)) { Visit(child); }
+
+    // Values computed in `block` are only available in blocks it dominates.
+    for (ir::Inst const* inst : introduced) { available_.erase(inst); }
+  }
+
+  ir::Value Replacement(ir::Reg r) const {
+    auto iter = replacements_.find(r);
+    if (iter == replacements_.end()) { return ir::Value(); }
+    return ir::Value(iter->second);
+  }
+
+  DominatorTree const& tree() const { return tree_; }
+  bool empty() const { return replacements_.empty(); }
+
+ private:
+  DominatorTree tree_;
+  absl::flat_hash_map<ir::Inst const*, ir::Reg, OperandHash, SameOperands>
+      available_;
+  // Because the dominator tree is walked in pre-order, the replacement for a
+  // register never itself has a replacement.
+  absl::flat_hash_map<ir::Reg, ir::Reg> replacements_;
+};
+
+}  // namespace
+
+bool NumberValues(ir::CompiledFn* fn) {
+  ValueNumbering numbering(fn);
+  numbering.Visit(numbering.tree().root());
+  if (numbering.empty()) { return false; }
+
+  // Phi operands flow along edges, so a phi may have been visited before the
+  // replacement for its operand was known. Jumps have not been visited at all.
+  for (auto* block : fn->blocks()) {
+    for (auto& inst : block->instructions()) {
+      inst.ReplaceUses([&](ir::Reg r) { return numbering.Replacement(r); });
+    }
+    if (block->jump().kind() == ir::JumpCmd::Kind::Cond) {
+      ir::Value v = numbering.Replacement(block->jump().CondReg());
+      if (auto const* r = v.get_if<ir::Reg>()) {
+        block->set_jump(ir::JumpCmd::Cond(*r, block->jump().CondTarget(true),
+                                          block->jump().CondTarget(false)));
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace opt
@@ -0,0 +1,20 @@
+#ifndef ICARUS_OPT_VALUE_NUMBERING_H
+#define ICARUS_OPT_VALUE_NUMBERING_H
+
+#include "ir/compiled_fn.h"
+
+namespace opt {
+
+// Global value numbering: walks the dominator tree and replaces uses of the
+// result of a pure instruction with the result of an equivalent instruction
+// (one of the same kind with the same operands) that dominates it. This is the
+// whole-function generalization of the per-block `OffsetCache` consulted while
+// building IR. Loads are not numbered because doing so would require knowing
+// which stores may alias them; `LoadStoreCache` continues to handle those
+// within a block. The duplicate instructions are left in place; see
+// `RemoveDeadInstructions`. Returns whether `fn` was modified.
+bool NumberValues(ir::CompiledFn* fn);
+
+}  // namespace opt
+
+#endif  // ICARUS_OPT_VALUE_NUMBERING_H
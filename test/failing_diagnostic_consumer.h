@@ -17,10 +17,10 @@ struct FailingConsumer : diagnostic::DiagnosticConsumer {
   explicit FailingConsumer() : diagnostic::DiagnosticConsumer(nullptr) {}
   ~FailingConsumer() override {}
 
-  void ConsumeImpl(diagnostic::DiagnosticMessage&& d) override {
+  void ConsumeImpl(diagnostic::Diagnostic const& d) override {
     // TODO move this out to an ostream renderer.
     std::stringstream ss;
-    d.for_each_component([&](auto const& component) {
+    d.message(source()).for_each_component([&](auto const& component) {
       using T = std::decay_t<decltype(component)>;
       if constexpr (std::is_same_v<T, diagnostic::Text>) {
         ss << component.c_str();
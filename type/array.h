@@ -97,6 +97,7 @@ struct ArrayInstruction
                                            ir::InlineExtension,
                                            ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = array %1$s %2$s";
+  static constexpr bool kPure                    = true;
   using length_t                                 = Array::length_t;
 
   Type Resolve() const { return Arr(length.value(), data_type.value()); }
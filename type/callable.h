@@ -15,7 +15,8 @@ struct Callable : LegacyType {
       : LegacyType(LegacyType::Flags{.is_default_initializable = 0,
                                      .is_copyable              = 1,
                                      .is_movable               = 1,
-                                     .has_destructor           = 0}) {}
+                                     .has_destructor           = 0,
+                                     .is_trivially_copyable    = 1}) {}
 
   // TODO: Make Jumps callable too, requiring that we change this as they don't
   // have return types.
@@ -1,8 +1,11 @@
 #include "type/cast.h"
 
 #include <numeric>
+#include <utility>
 
 #include "absl/algorithm/container.h"
+#include "base/concurrent_memo_map.h"
+#include "base/no_destructor.h"
 #include "type/array.h"
 #include "type/enum.h"
 #include "type/flags.h"
@@ -15,6 +18,22 @@
 namespace type {
 namespace {
 
+// Types are interned, so each of the relations below is a function of the pair
+// of types alone and can be memoized. Only pairs of compound types, whose
+// answers are computed structurally, are worth caching; everything else is
+// answered faster than a cache lookup.
+template <typename V>
+using TypePairCache =
+    base::NoDestructor<base::concurrent_memo_map<std::pair<Type, Type>, V>>;
+
+TypePairCache<bool> in_place_casts, implicit_casts, explicit_casts;
+TypePairCache<Type> meets;
+
+bool IsCompound(Type t) {
+  return t.is<Pointer>() or t.is<Array>() or t.is<Slice>() or
+         t.is<Function>();
+}
+
 bool CanCastPointer(Pointer const *from, Pointer const *to) {
   if (from == to) { return true; }
   if (to->is<BufferPointer>() and not from->is<BufferPointer>()) {
@@ -120,14 +139,7 @@ bool CanCast(Type from, Type to) {
   return false;
 }
 
-}  // namespace
-
-bool CanCastImplicitly(Type from, Type to) { return CanCast<false>(from, to); }
-bool CanCastExplicitly(Type from, Type to) { return CanCast<true>(from, to); }
-
-bool CanCastInPlace(Type from, Type to) {
-  if (from == to) { return true; }
-
+bool UncachedCanCastInPlace(Type from, Type to) {
   if (auto const *from_p = from.if_as<Pointer>()) {
     if (auto const *to_p = to.if_as<Pointer>()) {
       return CanCastPointer(from_p, to_p);
@@ -151,10 +163,7 @@ bool CanCastInPlace(Type from, Type to) {
 
 // TODO optimize (early exists. don't check lhs.is<> and rhs.is<>. If they
 // don't match you can early exit.
-Type Meet(Type lhs, Type rhs) {
-  if (lhs == rhs) { return lhs; }
-  if (not lhs or not rhs) { return nullptr; }
-
+Type UncachedMeet(Type lhs, Type rhs) {
   if (lhs == NullPtr and rhs.is<Pointer>()) { return rhs; }
   if (rhs == NullPtr and lhs.is<Pointer>()) { return lhs; }
 
@@ -176,4 +185,40 @@ Type Meet(Type lhs, Type rhs) {
   return nullptr;
 }
 
+}  // namespace
+
+bool CanCastImplicitly(Type from, Type to) {
+  if (from == to or not IsCompound(from) or not IsCompound(to)) {
+    return CanCast<false>(from, to);
+  }
+  return implicit_casts->get(std::pair(from, to),
+                             [&] { return CanCast<false>(from, to); });
+}
+
+bool CanCastExplicitly(Type from, Type to) {
+  if (from == to or not IsCompound(from) or not IsCompound(to)) {
+    return CanCast<true>(from, to);
+  }
+  return explicit_casts->get(std::pair(from, to),
+                             [&] { return CanCast<true>(from, to); });
+}
+
+bool CanCastInPlace(Type from, Type to) {
+  if (from == to) { return true; }
+  if (not IsCompound(from) or not IsCompound(to)) { return false; }
+  return in_place_casts->get(std::pair(from, to), [&] {
+    return UncachedCanCastInPlace(from, to);
+  });
+}
+
+Type Meet(Type lhs, Type rhs) {
+  if (lhs == rhs) { return lhs; }
+  if (not lhs or not rhs) { return nullptr; }
+  if (not IsCompound(lhs) or not IsCompound(rhs)) {
+    return UncachedMeet(lhs, rhs);
+  }
+  return meets->get(std::pair(lhs, rhs),
+                    [&] { return UncachedMeet(lhs, rhs); });
+}
+
 }  // namespace type
@@ -0,0 +1,89 @@
+// Measures the cost of the cast and meet queries made during overload
+// resolution and binary operator verification, both the first time a pair of
+// types is queried and once its answer has been memoized. Run with
+// `bazel run -c opt`.
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "type/array.h"
+#include "type/cast.h"
+#include "type/function.h"
+#include "type/pointer.h"
+#include "type/primitive.h"
+#include "type/slice.h"
+
+namespace {
+
+constexpr int kIterations = 100;
+
+// Pairs of types of the shapes queried when compiling the standard library:
+// nested pointers and buffer pointers, slices and arrays of them, and function
+// types taking them as parameters.
+std::vector<std::pair<type::Type, type::Type>> TypePairs() {
+  std::vector<std::pair<type::Type, type::Type>> pairs;
+  for (type::Type t : {type::Bool, type::Char, type::I64, type::U8,
+                       type::F64}) {
+    type::Type from = t, to = t;
+    for (int depth = 0; depth < 8; ++depth) {
+      from = type::BufPtr(from);
+      to   = type::Ptr(to);
+      pairs.emplace_back(from, to);
+      pairs.emplace_back(type::Slc(from), type::Slc(to));
+      pairs.emplace_back(type::Arr(depth, from), type::Arr(depth, to));
+      pairs.emplace_back(type::Arr(depth, from), type::Slc(to));
+      pairs.emplace_back(
+          type::Func({core::AnonymousParam(type::QualType::NonConstant(from))},
+                     {}),
+          type::Func({core::AnonymousParam(type::QualType::NonConstant(to))},
+                     {}));
+    }
+  }
+  return pairs;
+}
+
+template <typename Fn>
+void Time(char const *name, int iterations,
+          std::vector<std::pair<type::Type, type::Type>> const &pairs,
+          Fn &&f) {
+  absl::Time start = absl::Now();
+  for (int i = 0; i < iterations; ++i) {
+    for (auto [from, to] : pairs) { f(from, to); }
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  std::printf("%-24s %8.1f ns/query\n", name,
+              absl::ToDoubleNanoseconds(elapsed) /
+                  (iterations * pairs.size()));
+}
+
+void Run(char const *name, auto &&query) {
+  auto pairs = TypePairs();
+  std::printf("%s\n", name);
+  Time("  first query", 1, pairs, query);
+  Time("  repeated queries", kIterations, pairs, query);
+}
+
+}  // namespace
+
+int main() {
+  Run("CanCastInPlace", [](type::Type from, type::Type to) {
+    bool volatile result = type::CanCastInPlace(from, to);
+    (void)result;
+  });
+  Run("CanCastImplicitly", [](type::Type from, type::Type to) {
+    bool volatile result = type::CanCastImplicitly(from, to);
+    (void)result;
+  });
+  Run("CanCastExplicitly", [](type::Type from, type::Type to) {
+    bool volatile result = type::CanCastExplicitly(from, to);
+    (void)result;
+  });
+  Run("Meet", [](type::Type lhs, type::Type rhs) {
+    type::Type volatile result = type::Meet(lhs, rhs);
+    (void)result;
+  });
+  return 0;
+}
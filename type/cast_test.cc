@@ -296,5 +296,30 @@ TEST(CanCastExplicitly, Function) {
       Func({core::AnonymousParam(QualType::NonConstant(Ptr(Bool)))}, {})));
 }
 
+TEST(CanCast, RepeatedQueriesAreOrdered) {
+  // Answers are memoized per ordered pair of types, so asking again, or asking
+  // about the reverse cast, must not be confused with an earlier answer.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(CanCastInPlace(Slc(BufPtr(U8)), Slc(Ptr(U8))));
+    EXPECT_FALSE(CanCastInPlace(Slc(Ptr(U8)), Slc(BufPtr(U8))));
+    EXPECT_TRUE(CanCastImplicitly(Ptr(BufPtr(U8)), Ptr(Ptr(U8))));
+    EXPECT_FALSE(CanCastImplicitly(Ptr(Ptr(U8)), Ptr(BufPtr(U8))));
+    EXPECT_TRUE(CanCastExplicitly(Arr(2, BufPtr(U8)), Arr(2, Ptr(U8))));
+    EXPECT_FALSE(CanCastExplicitly(Arr(2, Ptr(U8)), Arr(2, BufPtr(U8))));
+  }
+}
+
+TEST(Meet, Compound) {
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(Meet(Ptr(I64), Ptr(I64)), Type(Ptr(I64)));
+    EXPECT_EQ(Meet(NullPtr, Ptr(I64)), Type(Ptr(I64)));
+    EXPECT_EQ(Meet(Ptr(I64), NullPtr), Type(Ptr(I64)));
+    EXPECT_EQ(Meet(Arr(3, Ptr(I64)), Arr(3, NullPtr)),
+              Type(Arr(3, Ptr(I64))));
+    EXPECT_FALSE(Meet(Arr(3, I64), Arr(4, I64)).valid());
+    EXPECT_FALSE(Meet(Ptr(I64), Arr(3, I64)).valid());
+  }
+}
+
 }  // namespace
 }  // namespace type
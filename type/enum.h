@@ -24,7 +24,8 @@ struct Enum : type::LegacyType {
       : LegacyType(LegacyType::Flags{.is_default_initializable = 0,
                                      .is_copyable              = 1,
                                      .is_movable               = 1,
-                                     .has_destructor           = 0}),
+                                     .has_destructor           = 0,
+                                     .is_trivially_copyable    = 1}),
         mod_(mod) {}
 
   void SetMembers(absl::flat_hash_map<std::string, underlying_type> vals) {
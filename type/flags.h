@@ -24,7 +24,9 @@ struct Flags : public type::LegacyType {
       : LegacyType(LegacyType::Flags{.is_default_initializable = 1,
                                      .is_copyable              = 1,
                                      .is_movable               = 1,
-                                     .has_destructor           = 0}),
+                                     .has_destructor           = 0,
+                                     .is_trivially_copyable    = 1,
+                                     .is_zero_initializable    = 1}),
         mod_(mod) {}
 
   void SetMembers(absl::flat_hash_map<std::string, underlying_type> vals) {
@@ -94,6 +96,7 @@ struct XorFlagsInstruction
                                               ir::InlineExtension,
                                               ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = xor-flags %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   Flags::underlying_type Resolve() const {
     return Apply(lhs.value(), rhs.value());
@@ -113,6 +116,7 @@ struct AndFlagsInstruction
                                               ir::InlineExtension,
                                               ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = and-flags %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   Flags::underlying_type Resolve() const {
     return Apply(lhs.value(), rhs.value());
@@ -132,6 +136,7 @@ struct OrFlagsInstruction
                                              ir::InlineExtension,
                                              ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%3$s = or-flags %1$s %2$s";
+  static constexpr bool kPure                    = true;
 
   Flags::underlying_type Resolve() const {
     return Apply(lhs.value(), rhs.value());
@@ -1,6 +1,11 @@
 #include "type/interface/interface.h"
+
+#include <utility>
+
 #include "absl/container/node_hash_set.h"
+#include "base/concurrent_memo_map.h"
 #include "base/global.h"
+#include "base/no_destructor.h"
 #include "core/call.h"
 #include "type/callable.h"
 #include "type/cast.h"
@@ -12,10 +17,27 @@ struct Interface::Impl {
   virtual ~Impl() {}
   virtual void stream(std::ostream &os) const = 0;
   virtual bool SatisfiedBy(type::Type) const  = 0;
+  // Whether `SatisfiedBy` is cheap enough that caching its answers is not
+  // worthwhile.
+  virtual bool cheap() const { return false; }
 };
 
+namespace {
+
+// Interfaces and types are both interned, so whether a type satisfies an
+// interface never changes. Answers are cached for the entire build, so that
+// constraints checked by every instantiation of a generic are only derived
+// once, whether by the verifier or by the interpreter.
+base::NoDestructor<base::concurrent_memo_map<
+    std::pair<Interface::Impl const *, type::Type>, bool>>
+    satisfactions_;
+
+}  // namespace
+
 bool Interface::SatisfiedBy(type::Type t) const {
-  return impl_->SatisfiedBy(t);
+  if (impl_->cheap()) { return impl_->SatisfiedBy(t); }
+  return satisfactions_->get(std::pair(impl_, t),
+                             [&] { return impl_->SatisfiedBy(t); });
 }
 
 std::ostream &operator<<(std::ostream &os, Interface i) {
@@ -28,6 +50,7 @@ namespace {
 struct Just : Interface::Impl {
   explicit Just(type::Type t) : type_(t) {}
   bool SatisfiedBy(type::Type t) const override { return t == type_; }
+  bool cheap() const override { return true; }
 
   void stream(std::ostream &os) const override {
     os << "Just(" << type_ << ")";
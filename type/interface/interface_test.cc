@@ -51,5 +51,17 @@ TEST(Satisfiability, Callable) {
               {})));
 }
 
+TEST(Satisfiability, RepeatedChecks) {
+  // Answers are cached per interface and type, so repeated checks, and checks
+  // of the same type against other interfaces, must be unaffected.
+  Interface to_ptr     = Interface::ConvertsTo(type::Ptr(type::I64));
+  Interface to_buf_ptr = Interface::ConvertsTo(type::BufPtr(type::I64));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(to_ptr.SatisfiedBy(type::BufPtr(type::I64)));
+    EXPECT_FALSE(to_buf_ptr.SatisfiedBy(type::Ptr(type::I64)));
+    EXPECT_TRUE(to_buf_ptr.SatisfiedBy(type::BufPtr(type::I64)));
+  }
+}
+
 }  // namespace
 }  // namespace interface
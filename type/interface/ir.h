@@ -18,6 +18,7 @@ struct ConvertsToInstruction
                                                 ir::InlineExtension,
                                                 ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = converts-to %1$s";
+  static constexpr bool kPure                    = true;
 
   Interface Resolve() const { return Interface::ConvertsTo(type.value()); }
 
@@ -30,6 +31,7 @@ struct JustInstruction
                                           ir::InlineExtension,
                                           ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = just %1$s";
+  static constexpr bool kPure                    = true;
 
   Interface Resolve() const { return Interface::Just(type.value()); }
 
@@ -34,7 +34,9 @@ struct Pointer : LegacyType {
       : LegacyType(LegacyType::Flags{.is_default_initializable = 1,
                                      .is_copyable              = 1,
                                      .is_movable               = 1,
-                                     .has_destructor           = 0}),
+                                     .has_destructor           = 0,
+                                     .is_trivially_copyable    = 1,
+                                     .is_zero_initializable    = 1}),
         pointee_(t) {}
 
  private:
@@ -66,6 +68,7 @@ struct PtrInstruction
                                          ir::InlineExtension,
                                          ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = ptr %1$s";
+  static constexpr bool kPure                    = true;
 
   Type Resolve() const { return Apply(operand.value()); }
   static type::Type Apply(type::Type operand) { return type::Ptr(operand); }
@@ -79,6 +82,7 @@ struct BufPtrInstruction
                                             ir::InlineExtension,
                                             ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = buf-ptr %1$s";
+  static constexpr bool kPure                    = true;
 
   Type Resolve() const { return Apply(operand.value()); }
   static type::Type Apply(type::Type operand) { return type::BufPtr(operand); }
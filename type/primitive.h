@@ -11,17 +11,19 @@ namespace type {
 
 struct Primitive : public LegacyType {
  public:
-  enum class BasicType : uint8_t {
-#define PRIMITIVE_MACRO(EnumName, name) EnumName,
-#include "type/primitive.xmacro.h"
-#undef PRIMITIVE_MACRO
-  };
+  using BasicType = internal_type::PrimitiveKind;
 
   constexpr Primitive(BasicType pt)
-      : LegacyType(LegacyType::Flags{.is_default_initializable = 1,
-                                     .is_copyable              = 1,
-                                     .is_movable               = 1,
-                                     .has_destructor           = 0}),
+      : LegacyType(
+            LegacyType::Flags{
+                .is_default_initializable = 1,
+                .is_copyable              = 1,
+                .is_movable               = 1,
+                .has_destructor           = 0,
+                .is_trivially_copyable    = IsArithmetic(pt),
+                .is_zero_initializable    = IsArithmetic(pt),
+            },
+            pt),
         type_(pt) {}
 
   void Accept(VisitorBase *visitor, void *ret, void *arg_tuple) const override {
@@ -50,6 +52,11 @@ struct Primitive : public LegacyType {
   BasicType type_;
 
  private:
+  // Returns whether `pt` is `bool`, `char`, or a numeric type.
+  static constexpr bool IsArithmetic(BasicType pt) {
+    return BasicType::Bool <= pt and pt <= BasicType::F64;
+  }
+
   template <typename... Ts, typename Fn>
   decltype(std::declval<Fn>().template operator()<base::first_t<Ts...>>())
   ApplyImpl(Fn &&fn) const;
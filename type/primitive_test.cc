@@ -16,4 +16,26 @@ TEST(Primitive, ToString) {
   EXPECT_EQ(absl::StrFormat("%s", type::Type_), "type");
 }
 
+TEST(Primitive, Layout) {
+  EXPECT_EQ(type::I64.bytes(core::Host), core::Bytes{8});
+  EXPECT_EQ(type::I64.alignment(core::Host), core::Alignment{8});
+  EXPECT_EQ(type::Bool.bytes(core::Host), core::Bytes{1});
+  EXPECT_EQ(type::Type_.bytes(core::Host), core::Bytes::Get<type::Type>());
+  EXPECT_EQ(type::NullPtr.bytes(core::Host), core::Host.pointer().bytes());
+  EXPECT_FALSE(type::F64.is_big());
+}
+
+TEST(Primitive, TaggedHandles) {
+  // However a handle to a primitive type is constructed, it must be recognized
+  // as the same primitive type.
+  type::Type t = type::I64.get();
+  EXPECT_EQ(t, type::I64);
+  EXPECT_NE(t, type::I32);
+  EXPECT_TRUE(t.is<type::Primitive>());
+  EXPECT_TRUE(t.is<type::LegacyType>());
+  EXPECT_EQ(t.if_as<type::Primitive>(), &type::I64.as<type::Primitive>());
+  EXPECT_EQ(t.as<type::Primitive>().type_, type::Primitive::BasicType::I64);
+  EXPECT_EQ(absl::HashOf(t), absl::HashOf(type::I64));
+}
+
 }  // namespace
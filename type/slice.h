@@ -64,6 +64,7 @@ struct Slice : LegacyType {
             .is_copyable              = 1,
             .is_movable               = 1,
             .has_destructor           = 0,
+            .is_trivially_copyable    = 1,
         }),
         data_type_(t) {}
 
@@ -77,6 +78,7 @@ struct SliceInstruction
                                            ir::InlineExtension,
                                            ir::DebugFormatExtension> {
   static constexpr std::string_view kDebugFormat = "%2$s = slice %1$s";
+  static constexpr bool kPure                    = true;
 
   Type Resolve() const { return Slc(data_type.value()); }
 
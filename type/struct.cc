@@ -1,6 +1,10 @@
 #include "type/struct.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/arch.h"
+#include "ir/interpreter/architecture.h"
 #include "ir/value/hashtag.h"
 #include "module/module.h"
 #include "type/function.h"
@@ -12,8 +16,11 @@ Struct::Struct(module::BasicModule const *mod, Struct::Options options)
     : LegacyType(LegacyType::Flags{.is_default_initializable = 1,
                                    .is_copyable    = options.is_copyable,
                                    .is_movable     = options.is_movable,
-                                   .has_destructor = 0}),
-      mod_(mod) {}
+                                   .has_destructor = 0,
+                                   .is_trivially_copyable = 0,
+                                   .is_zero_initializable = 0}),
+      mod_(mod),
+      reorder_fields_(options.reorder_fields) {}
 
 void Struct::AppendConstants(std::vector<Struct::Field> constants) {
   constants_ = std::move(constants);
@@ -27,7 +34,11 @@ void Struct::AppendConstants(std::vector<Struct::Field> constants) {
 void Struct::AppendFields(std::vector<Struct::Field> fields) {
   completeness_ = Completeness::DataComplete;
   fields_       = std::move(fields);
-  size_t i      = 0;
+  // These are only known once the fields are, so they start out unset in case
+  // the incomplete struct's flags are copied (e.g., by an array type).
+  flags_.is_trivially_copyable = 1;
+  flags_.is_zero_initializable = 1;
+  size_t i                     = 0;
   for (auto const &field : fields_) {
     ASSERT(field.type.valid() == true);
     field_indices_.emplace(field.name, i++);
@@ -36,6 +47,22 @@ void Struct::AppendFields(std::vector<Struct::Field> fields) {
     flags_.is_copyable &= field.type.get()->IsCopyable();
     flags_.is_movable &= field.type.get()->IsMovable();
     flags_.has_destructor |= field.type.get()->HasDestructor();
+    flags_.is_trivially_copyable &= field.type.get()->IsTriviallyCopyable();
+    flags_.is_zero_initializable &=
+        field.type.get()->IsZeroInitializable() and field.initial_value.empty();
+  }
+
+  layout_.resize(fields_.size());
+  std::iota(layout_.begin(), layout_.end(), 0);
+  if (reorder_fields_) {
+    // Placing fields in order of decreasing alignment means no padding is
+    // needed between them, because every field's size is a multiple of its
+    // alignment. The order is chosen once, for the architecture on which the
+    // interpreter runs, so that every backend agrees on it.
+    std::stable_sort(layout_.begin(), layout_.end(), [&](size_t l, size_t r) {
+      return fields_[l].type.alignment(interpreter::kArchitecture) >
+             fields_[r].type.alignment(interpreter::kArchitecture);
+    });
   }
 }
 
@@ -112,11 +139,12 @@ ir::Fn const *Struct::CopyAssignment(type::Type from_type) const {
 core::Bytes Struct::offset(size_t field_num, core::Arch const &a) const {
   ASSERT(completeness_ >= Completeness::DataComplete);
   auto offset = core::Bytes{0};
-  for (size_t i = 0; i < field_num; ++i) {
-    offset += fields_.at(i).type.bytes(a);
-    offset = core::FwdAlign(offset, fields_.at(i + 1).type.alignment(a));
+  for (size_t i : layout_) {
+    offset = core::FwdAlign(offset, fields_[i].type.alignment(a));
+    if (i == field_num) { return offset; }
+    offset += fields_[i].type.bytes(a);
   }
-  return offset;
+  UNREACHABLE(field_num);
 }
 
 size_t Struct::index(std::string_view name) const {
@@ -144,14 +172,14 @@ void Struct::WriteTo(std::string *result) const {
 core::Bytes Struct::bytes(core::Arch const &a) const {
   ASSERT(completeness_ >= Completeness::DataComplete);
   auto num_bytes = core::Bytes{0};
-  for (auto const &field : fields_) {
-    num_bytes += field.type.bytes(a);
+  for (size_t i : layout_) {
     // TODO it'd be in the (common, I think) case where you want both, it would
     // be faster to compute bytes and alignment simultaneously.
-    num_bytes = core::FwdAlign(num_bytes, field.type.alignment(a));
+    num_bytes = core::FwdAlign(num_bytes, fields_[i].type.alignment(a));
+    num_bytes += fields_[i].type.bytes(a);
   }
 
-  return num_bytes;
+  return core::FwdAlign(num_bytes, alignment(a));
 }
 
 core::Alignment Struct::alignment(core::Arch const &a) const {
@@ -215,6 +243,7 @@ void StructInstruction::Apply(interpreter::ExecutionContext &ctx) const {
   struct_->SetInits(move_inits, copy_inits);
   struct_->SetAssignments(move_assignments, copy_assignments);
   if (dtor) { struct_->SetDestructor(*dtor); }
+  if (user_defined_copy_or_move) { struct_->flags_.is_trivially_copyable = 0; }
 }
 
 }  // namespace type
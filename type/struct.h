@@ -35,6 +35,9 @@ struct Struct : public LegacyType {
   struct Options {
     uint8_t is_copyable : 1;
     uint8_t is_movable : 1;
+    // Whether fields may be laid out in an order other than their declaration
+    // order so as to minimize padding.
+    uint8_t reorder_fields : 1;
   };
   Struct(module::BasicModule const *mod, Options options);
 
@@ -64,8 +67,15 @@ struct Struct : public LegacyType {
 
   module::BasicModule const *defining_module() const { return mod_; }
 
+  // Returns the offset of the `n`th field in declaration order.
   core::Bytes offset(size_t n, core::Arch const &arch) const;
 
+  // Returns the indices of the fields in the order in which they are laid out
+  // in memory. This is declaration order unless the struct was declared with
+  // the `#{compact}` hashtag, in which case fields are ordered by decreasing
+  // alignment.
+  absl::Span<size_t const> layout() const { return layout_; }
+
   absl::Span<Field const> fields() const { return fields_; }
   absl::Span<Field const> constants() const { return constants_; }
   size_t index(std::string_view name) const;
@@ -92,6 +102,8 @@ struct Struct : public LegacyType {
   absl::flat_hash_map<type::Type, ir::Fn> move_inits_, copy_inits_,
       move_assignments_, copy_assignments_;
   absl::flat_hash_map<std::string, size_t> field_indices_;
+  std::vector<size_t> layout_;
+  bool reorder_fields_;
 };
 
 // When compiling a struct definition, we build up a function to be
@@ -184,6 +196,9 @@ struct StructInstruction
   std::vector<ir::Fn> move_inits, copy_inits, move_assignments,
       copy_assignments;
   std::optional<ir::Fn> dtor;
+  // Whether any of the inits or assignments above were provided by the user
+  // rather than generated to copy or move each field.
+  bool user_defined_copy_or_move = false;
 };
 
 }  // namespace type
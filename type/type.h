@@ -1,6 +1,8 @@
 #ifndef ICARUS_TYPE_TYPE_H
 #define ICARUS_TYPE_TYPE_H
 
+#include <array>
+#include <functional>
 #include <string>
 
 #include "base/cast.h"
@@ -28,6 +30,27 @@ enum class Completeness {
   Complete
 };
 
+namespace internal_type {
+
+// The kinds of primitive types (see `type::Primitive`).
+enum class PrimitiveKind : uint8_t {
+#define PRIMITIVE_MACRO(EnumName, name) EnumName,
+#include "type/primitive.xmacro.h"
+#undef PRIMITIVE_MACRO
+};
+
+inline constexpr size_t kNumPrimitives = 0
+#define PRIMITIVE_MACRO(EnumName, name) +1
+#include "type/primitive.xmacro.h"
+#undef PRIMITIVE_MACRO
+    ;
+
+inline core::Bytes PrimitiveBytes(PrimitiveKind k, core::Arch const &arch);
+inline core::Alignment PrimitiveAlignment(PrimitiveKind k,
+                                          core::Arch const &arch);
+
+}  // namespace internal_type
+
 // `LegacyType` is the base class for all types in the Icarus type system. To
 // construct a new category of types, create a subclass of `LegacyType`.
 // Implementing the required virtual methods, and passing the correct flags to
@@ -46,6 +69,12 @@ struct LegacyType : base::Cast<LegacyType> {
   bool IsCopyable() const { return flags_.is_copyable; }
   bool IsMovable() const { return flags_.is_movable; }
   bool HasDestructor() const { return flags_.has_destructor; }
+  // Objects of trivially copyable types may be copied or moved by copying
+  // their bytes.
+  bool IsTriviallyCopyable() const { return flags_.is_trivially_copyable; }
+  // Default-initialized objects of zero-initializable types have all of their
+  // bytes set to zero.
+  bool IsZeroInitializable() const { return flags_.is_zero_initializable; }
 
   virtual void Accept(VisitorBase *visitor, void *ret,
                       void *arg_tuple) const = 0;
@@ -58,8 +87,9 @@ struct LegacyType : base::Cast<LegacyType> {
 
   virtual Completeness completeness() const = 0;
 
-  // TODO length-0 arrays and length-1 arrays of small types should be
-  // considered small too. Similarly with simple variants and tuples.
+  // Big types are held by address in the IR. Whether a big type may
+  // nonetheless be passed to and returned from functions by value in compiled
+  // code is decided by `IsSmallAggregate`.
   // // TODO make this pure virtual
   virtual bool is_big() const { return false; }
 
@@ -69,15 +99,26 @@ struct LegacyType : base::Cast<LegacyType> {
     uint8_t is_copyable : 1;
     uint8_t is_movable : 1;
     uint8_t has_destructor : 1;
+    uint8_t is_trivially_copyable : 1;
+    uint8_t is_zero_initializable : 1;
   };
 
   constexpr Flags flags() const { return flags_; }
 
  protected:
   explicit constexpr LegacyType(Flags flags) : flags_(flags) {}
+  explicit constexpr LegacyType(Flags flags, internal_type::PrimitiveKind k)
+      : flags_(flags), primitive_kind_(static_cast<int8_t>(k)) {}
   Flags flags_;
+
+ private:
+  friend struct Type;
+  // The kind of primitive type this is, or -1 if this is not a primitive type.
+  int8_t primitive_kind_ = -1;
 };
 
+struct Primitive;
+
 struct Type;
 
 // clang-format off
@@ -118,9 +159,9 @@ struct TypeVTable {
 
 inline TypeVTable DefaultTypeVTable{};
 
-template <TypeFamily T>
-inline TypeVTable TypeVTableFor =
-    TypeVTable{
+template <typename T>
+constexpr TypeVTable MakeTypeVTable() {
+  return TypeVTable{
         .bytes =
             [](void const *self, core::Arch const &a) {
               return reinterpret_cast<T const *>(self)->bytes(a);
@@ -151,6 +192,10 @@ inline TypeVTable TypeVTableFor =
               reinterpret_cast<T const *>(self)->Accept(v, ret, args);
             },
     };
+}
+
+template <TypeFamily T>
+inline TypeVTable TypeVTableFor = MakeTypeVTable<T>();
 
 struct LegacyTypeWrapper {
   LegacyTypeWrapper(LegacyType const *t) : t_(t) {}
@@ -182,15 +227,34 @@ struct LegacyTypeWrapper {
   LegacyType const *t_;
 };
 
+// Each primitive type has a vtable of its own, indexed by its
+// `PrimitiveKind`. The entries behave exactly like the vtable for all other
+// `LegacyType`s, but allow `Type` to recognize a primitive type and its kind
+// from the vtable pointer alone.
+inline constexpr std::array<TypeVTable, kNumPrimitives> PrimitiveTypeVTables =
+    [] {
+      std::array<TypeVTable, kNumPrimitives> vtables;
+      vtables.fill(MakeTypeVTable<LegacyTypeWrapper>());
+      return vtables;
+    }();
+
 }  // namespace internal_type
 
+// `Type` is a type-erased handle to a type of any type family. Primitive types
+// make up the vast majority of all queried types, so they are tagged: their
+// kind is encoded in the vtable pointer (see
+// `internal_type::PrimitiveTypeVTables`), and layout queries, equality and
+// checks for `Primitive` are answered inline without calling through any
+// vtable.
 struct Type {
   Type(std::nullptr_t p = nullptr)
       : data_{}, vptr_(&internal_type::DefaultTypeVTable) {}
   Type(LegacyType const *t)
-      : vptr_(
-            t ? &internal_type::TypeVTableFor<internal_type::LegacyTypeWrapper>
-              : &internal_type::DefaultTypeVTable) {
+      : vptr_(not t ? &internal_type::DefaultTypeVTable
+              : t->primitive_kind_ >= 0
+                  ? &internal_type::PrimitiveTypeVTables[t->primitive_kind_]
+                  : &internal_type::TypeVTableFor<
+                        internal_type::LegacyTypeWrapper>) {
     new (reinterpret_cast<internal_type::LegacyTypeWrapper *>(data_))
         internal_type::LegacyTypeWrapper(t);
   }
@@ -202,6 +266,9 @@ struct Type {
 
   template <typename H>
   friend H AbslHashValue(H h, Type t) {
+    if (t.is_primitive()) {
+      return H::combine(std::move(h), t.primitive_kind());
+    }
     return H::combine(std::move(h), t.vptr_->Hash(&t.data_));
   }
 
@@ -213,34 +280,39 @@ struct Type {
   }
 
   // Template avoids implicit conversions.
+  // Primitive types are unique, so two primitive types are equal exactly when
+  // their vtables are.
   template <std::same_as<Type> T>
   friend bool operator==(T lhs, T rhs) {
-    return lhs.vptr_ == rhs.vptr_ and lhs.vptr_->Equals(&lhs.data_, &rhs.data_);
+    return lhs.vptr_ == rhs.vptr_ and
+           (lhs.is_primitive() or lhs.vptr_->Equals(&lhs.data_, &rhs.data_));
   }
   friend bool operator!=(Type lhs, Type rhs) { return not(lhs == rhs); }
 
   core::Bytes bytes(core::Arch const &arch) const {
+    if (is_primitive()) {
+      return internal_type::PrimitiveBytes(primitive_kind(), arch);
+    }
     return vptr_->bytes(&data_, arch);
   }
   core::Alignment alignment(core::Arch const &arch) const {
+    if (is_primitive()) {
+      return internal_type::PrimitiveAlignment(primitive_kind(), arch);
+    }
     return vptr_->alignment(&data_, arch);
   }
 
   std::string to_string() const { return vptr_->to_string(&data_); }
 
-  bool is_big() const { return vptr_->is_big(&data_); }
+  bool is_big() const { return not is_primitive() and vptr_->is_big(&data_); }
 
   template <typename T>
   auto const *if_as() const {
-    if constexpr (std::is_base_of_v<LegacyType, T> or
-                  base::meta<T> == base::meta<LegacyType>) {
-      return vptr_ == &internal_type::TypeVTableFor<
-                          internal_type::LegacyTypeWrapper>
-                 ? reinterpret_cast<internal_type::LegacyTypeWrapper const &>(
-                       data_)
-                       .get()
-                       ->template if_as<T>()
-                 : nullptr;
+    if constexpr (std::is_same_v<T, Primitive>) {
+      return is_primitive() ? static_cast<T const *>(legacy()) : nullptr;
+    } else if constexpr (std::is_base_of_v<LegacyType, T> or
+                         base::meta<T> == base::meta<LegacyType>) {
+      return is_legacy() ? legacy()->template if_as<T>() : nullptr;
     } else {
       return vptr_ == &internal_type::TypeVTableFor<T>
                  ? &reinterpret_cast<T const &>(data_)
@@ -249,24 +321,23 @@ struct Type {
   }
   template <typename T>
   bool is() const {
-    if constexpr (std::is_base_of_v<LegacyType, T> or
-                  base::meta<T> == base::meta<LegacyType>) {
-      return vptr_ == &internal_type::TypeVTableFor<
-                          internal_type::LegacyTypeWrapper> and
-             reinterpret_cast<internal_type::LegacyTypeWrapper const &>(data_)
-                 .get()
-                 ->template is<T>();
+    if constexpr (std::is_same_v<T, Primitive>) {
+      return is_primitive();
+    } else if constexpr (base::meta<T> == base::meta<LegacyType>) {
+      return is_legacy();
+    } else if constexpr (std::is_base_of_v<LegacyType, T>) {
+      return is_legacy() and legacy()->template is<T>();
     } else {
       return vptr_ == &internal_type::TypeVTableFor<T>;
     }
   }
   template <typename T>
   T const &as() const {
-    if constexpr (std::is_base_of_v<LegacyType, T> or
-                  base::meta<T> == base::meta<LegacyType>) {
-      return reinterpret_cast<internal_type::LegacyTypeWrapper const &>(data_)
-          .get()
-          ->template as<T>();
+    if constexpr (std::is_same_v<T, Primitive>) {
+      return *static_cast<T const *>(legacy());
+    } else if constexpr (std::is_base_of_v<LegacyType, T> or
+                         base::meta<T> == base::meta<LegacyType>) {
+      return legacy()->template as<T>();
     } else {
       return reinterpret_cast<T const &>(data_);
     }
@@ -279,10 +350,106 @@ struct Type {
   }
 
  private:
+  bool is_primitive() const {
+    auto const *vtables = internal_type::PrimitiveTypeVTables.data();
+    return std::greater_equal<>{}(vptr_, vtables) and
+           std::less<>{}(vptr_, vtables + internal_type::kNumPrimitives);
+  }
+  internal_type::PrimitiveKind primitive_kind() const {
+    return static_cast<internal_type::PrimitiveKind>(
+        vptr_ - internal_type::PrimitiveTypeVTables.data());
+  }
+
+  bool is_legacy() const {
+    return vptr_ == &internal_type::TypeVTableFor<
+                        internal_type::LegacyTypeWrapper> or
+           is_primitive();
+  }
+  LegacyType const *legacy() const {
+    return reinterpret_cast<internal_type::LegacyTypeWrapper const &>(data_)
+        .get();
+  }
+
   alignas(void const *) char data_[sizeof(void const *)];
   internal_type::TypeVTable const *vptr_;
 };
 
+namespace internal_type {
+
+inline core::Bytes PrimitiveBytes(PrimitiveKind k, core::Arch const &arch) {
+  switch (k) {
+    // Types are stored as pointers on the host and integers on the target
+    // machine that are as wide as host pointers.
+    case PrimitiveKind::Void: return core::Bytes{0};
+    case PrimitiveKind::Type_: return core::Bytes::Get<Type>();
+    case PrimitiveKind::NullPtr: return arch.pointer().bytes();
+    case PrimitiveKind::EmptyArray: return core::Bytes{0};
+    case PrimitiveKind::Bool: return core::Bytes{1};
+    case PrimitiveKind::Char: return core::Bytes{1};
+    case PrimitiveKind::I8: return core::Bytes{1};
+    case PrimitiveKind::I16: return core::Bytes{2};
+    case PrimitiveKind::I32: return core::Bytes{4};
+    case PrimitiveKind::I64: return core::Bytes{8};
+    case PrimitiveKind::U8: return core::Bytes{1};
+    case PrimitiveKind::U16: return core::Bytes{2};
+    case PrimitiveKind::U32: return core::Bytes{4};
+    case PrimitiveKind::U64: return core::Bytes{8};
+    case PrimitiveKind::F32: return core::Bytes{4};
+    case PrimitiveKind::F64: return core::Bytes{8};
+    case PrimitiveKind::Module: return core::Host.pointer().bytes();
+    case PrimitiveKind::Scope: return core::Host.pointer().bytes();
+    case PrimitiveKind::Block: return core::Host.pointer().bytes();
+    case PrimitiveKind::Label: return core::Host.pointer().bytes();
+    case PrimitiveKind::Interface: return core::Host.pointer().bytes();
+  }
+  UNREACHABLE(static_cast<int>(k));
+}
+
+inline core::Alignment PrimitiveAlignment(PrimitiveKind k,
+                                          core::Arch const &arch) {
+  switch (k) {
+    // Types are stored as pointers on the host and integers on the target
+    // machine that are as wide as host pointers.
+    case PrimitiveKind::Void: return core::Alignment{0};
+    case PrimitiveKind::Type_: return core::Alignment::Get<Type>();
+    case PrimitiveKind::NullPtr: return arch.pointer().alignment();
+    case PrimitiveKind::EmptyArray: return core::Alignment{1};
+    case PrimitiveKind::Bool: return core::Alignment{1};
+    case PrimitiveKind::Char: return core::Alignment{1};
+    case PrimitiveKind::I8: return core::Alignment{1};
+    case PrimitiveKind::I16: return core::Alignment{2};
+    case PrimitiveKind::I32: return core::Alignment{4};
+    case PrimitiveKind::I64: return core::Alignment{8};
+    case PrimitiveKind::U8: return core::Alignment{1};
+    case PrimitiveKind::U16: return core::Alignment{2};
+    case PrimitiveKind::U32: return core::Alignment{4};
+    case PrimitiveKind::U64: return core::Alignment{8};
+    case PrimitiveKind::F32: return core::Alignment{4};
+    case PrimitiveKind::F64: return core::Alignment{8};
+    case PrimitiveKind::Module: return core::Host.pointer().alignment();
+    case PrimitiveKind::Scope: return core::Host.pointer().alignment();
+    case PrimitiveKind::Block: return core::Host.pointer().alignment();
+    case PrimitiveKind::Label: return core::Host.pointer().alignment();
+    case PrimitiveKind::Interface: return core::Host.pointer().alignment();
+  }
+  UNREACHABLE(static_cast<int>(k));
+}
+
+}  // namespace internal_type
+
+// Returns whether objects of the big type `t` may be passed to and returned
+// from functions by value on `arch`, as they fit in two registers and can be
+// copied, moved, and destroyed without running any code.
+//
+// Only the LLVM backend takes advantage of this. The IR, and hence the
+// interpreter, still passes every big type by address.
+inline bool IsSmallAggregate(Type t, core::Arch const &arch) {
+  if (not t.is_big()) { return false; }
+  auto const *lt = t.get();
+  return lt and lt->IsTriviallyCopyable() and not lt->HasDestructor() and
+         t.bytes(arch) <= core::Bytes(16);
+}
+
 // Intentionally leak this type.
 template <typename T, typename... Args>
 T *Allocate(Args &&... args) {